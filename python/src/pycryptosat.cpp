@@ -332,34 +332,44 @@ static int _add_clauses_from_array(Solver *self, const size_t array_length, cons
         PyErr_SetString(PyExc_ValueError, "last clause not terminated by zero");
         return 0;
     }
-    size_t k = 0;
-    long val = 0;
+
+    // Convert into one flat, lit_Undef-terminated buffer and add it in bulk
     std::vector<Lit>& lits = self->tmp_cl_lits;
-    for (val = (long) array[k]; k < array_length; val = (long) array[++k]) {
-        lits.clear();
-        long int max_var = 0;
-        for (; k < array_length && val != 0; val = (long) array[++k]) {
-            long var;
-            bool sign;
-            if (val > std::numeric_limits<int>::max()/2
-                || val < std::numeric_limits<int>::min()/2
-            ) {
-                PyErr_Format(PyExc_ValueError, "integer %ld is too small or too large", val);
-                return 0;
+    lits.clear();
+    lits.reserve(array_length);
+    long int max_var = -1;
+    size_t clause_start = 0;
+    for (size_t k = 0; k < array_length; k++) {
+        const long val = (long) array[k];
+        if (val == 0) {
+            //skip empty clauses
+            if (lits.size() != clause_start) {
+                lits.push_back(lit_Undef);
+                clause_start = lits.size();
             }
-
-            sign = (val < 0);
-            var = std::abs(val) - 1;
-            max_var = std::max(var, max_var);
-
-            lits.push_back(Lit(var, sign));
+            continue;
         }
-        if (!lits.empty()) {
-            if (max_var >= (long int)self->cmsat->nVars()) {
-                self->cmsat->new_vars(max_var-(long int)self->cmsat->nVars()+1);
-            }
-            self->cmsat->add_clause(lits);
+        if (val > std::numeric_limits<int>::max()/2
+            || val < std::numeric_limits<int>::min()/2
+        ) {
+            PyErr_Format(PyExc_ValueError, "integer %ld is too small or too large", val);
+            return 0;
         }
+
+        const bool sign = (val < 0);
+        const long var = std::abs(val) - 1;
+        max_var = std::max(var, max_var);
+        lits.push_back(Lit(var, sign));
+    }
+
+    if (max_var >= (long int)self->cmsat->nVars()) {
+        self->cmsat->new_vars(max_var-(long int)self->cmsat->nVars()+1);
+    }
+    try {
+        self->cmsat->add_clauses(lits.data(), lits.size());
+    } catch (const std::exception& e) {
+        PyErr_SetString(PyExc_ValueError, e.what());
+        return 0;
     }
     return 1;
 }
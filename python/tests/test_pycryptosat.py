@@ -230,6 +230,24 @@ class TestSolve(unittest.TestCase):
         cls = array('i', [1, 2, 0, 1, 2])
         self.assertRaises(ValueError, self.solver.add_clause, cls)
 
+    def test_add_clauses_array_multi(self):
+        cls = array('i', [1, 0, -1, 2, 0, -2, 3, 0, -3, -4, 0])
+        self.solver.add_clauses(cls)
+        res, solution = self.solver.solve()
+        self.assertEqual(res, True)
+        self.assertEqual(solution, (None, True, True, True, False))
+
+    def test_add_clauses_array_types(self):
+        for typecode in ['i', 'l', 'q']:
+            solver = Solver()
+            solver.add_clauses(array(typecode, [1, 2, 0, -1, 0, -2, 0]))
+            res, solution = solver.solve()
+            self.assertEqual(res, False)
+
+    def test_add_clauses_array_too_large(self):
+        cls = array('q', [1, 2**40, 0])
+        self.assertRaises(ValueError, self.solver.add_clauses, cls)
+
     def test_bad_iter(self):
         class Liar:
 
@@ -23,6 +23,7 @@ THE SOFTWARE.
 #include "ccnr.h"
 #include "ccnr_mersenne.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
 #include <iostream>
@@ -52,6 +53,99 @@ ls_solver::ls_solver(const bool aspiration)
 }
 
 /**********************************build instance*******************************/
+void ls_solver::start_build(int num_vars, int num_clauses_max, size_t num_lits_max)
+{
+    //An unfinished build is dropped, the last finished one is kept
+    if (_f_built) {
+        _prev_f = _f;
+        _prev_num_vars = _num_vars;
+    }
+    _f_built = false;
+    _num_vars = num_vars;
+    _num_clauses = 0;
+    _f = std::make_shared<formula>();
+    _f->cl_lits.reserve(num_lits_max);
+    _f->cl_start.reserve(num_clauses_max+1);
+    _f->cl_start.push_back(0);
+    _f->cl_id.reserve(num_clauses_max);
+}
+
+void ls_solver::add_clause(const vector<int>& lits, const int32_t ID)
+{
+    for(const int l: lits) {
+        _f->cl_lits.push_back(lit(l, _num_clauses));
+    }
+    _f->cl_start.push_back(_f->cl_lits.size());
+    _f->cl_id.push_back(ID);
+    _num_clauses++;
+}
+
+bool ls_solver::finish_build()
+{
+    if (!make_space()) {
+        return false;
+    }
+    build_occurrences();
+    sort_ids();
+    if (_prev_f && _prev_num_vars <= _num_vars) {
+        build_neighborhood_delta();
+    } else {
+        _clauses_added = _num_clauses;
+        _clauses_removed = 0;
+        build_neighborhood();
+    }
+    _prev_f.reset();
+    _changed_vars.clear();
+    _f_built = true;
+    cache_formula();
+
+    return true;
+}
+
+void ls_solver::share_formula(const ls_solver& other)
+{
+    _f = other._f;
+    _f_built = other._f_built;
+    _num_vars = other._num_vars;
+    _num_clauses = other._num_clauses;
+    make_space();
+    cache_formula();
+}
+
+template<class T>
+static uint64_t vec_mem(const vector<T>& v)
+{
+    return v.capacity()*sizeof(T);
+}
+
+uint64_t ls_solver::mem_used() const
+{
+    uint64_t mem = 0;
+    if (_f) {
+        const formula& f = *_f;
+        mem += vec_mem(f.cl_lits) + vec_mem(f.cl_start);
+        mem += vec_mem(f.var_lits) + vec_mem(f.var_start);
+        mem += vec_mem(f.neighbors) + vec_mem(f.neighbor_start);
+        mem += vec_mem(f.cl_id) + vec_mem(f.id_order);
+    }
+    mem += vec_mem(_vars) + vec_mem(_clauses);
+    mem += vec_mem(_conflict_ct) + vec_mem(_unsat_clauses);
+    mem += vec_mem(_index_in_unsat_clauses) + vec_mem(_unsat_vars);
+    mem += vec_mem(_index_in_unsat_vars) + vec_mem(_ccd_vars);
+    mem += vec_mem(_solution) + vec_mem(_best_solution);
+    return mem;
+}
+
+void ls_solver::cache_formula()
+{
+    _cl_lits = _f->cl_lits.data();
+    _cl_start = _f->cl_start.data();
+    _var_lits = _f->var_lits.data();
+    _var_start = _f->var_start.data();
+    _neighbors = _f->neighbors.data();
+    _neighbor_start = _f->neighbor_start.data();
+}
+
 bool ls_solver::make_space()
 {
     if (0 == _num_vars || 0 == _num_clauses) {
@@ -69,27 +163,176 @@ bool ls_solver::make_space()
     return true;
 }
 
-void ls_solver::build_neighborhood()
+//Counting sort of the clause literals by variable
+void ls_solver::build_occurrences()
+{
+    formula& f = *_f;
+    f.var_start.assign(_num_vars+2, 0);
+    for(const lit l: f.cl_lits) {
+        f.var_start[l.var_num+1]++;
+    }
+    for(int v = 1; v <= _num_vars+1; v++) {
+        f.var_start[v] += f.var_start[v-1];
+    }
+
+    vector<uint32_t> at(f.var_start.begin(), f.var_start.end()-1);
+    f.var_lits.resize(f.cl_lits.size(), lit(1, 0));
+    for(const lit l: f.cl_lits) {
+        f.var_lits[at[l.var_num]++] = l;
+    }
+}
+
+void ls_solver::add_neighbors_of(const formula& f, int v, vector<uint8_t>& neighbor_flag)
 {
-    vector<bool> neighbor_flag(_num_vars+1);
-    for (uint32_t j = 0; j < neighbor_flag.size(); ++j) {
-        neighbor_flag[j] = 0;
+    vector<int>& neighbors = _f->neighbors;
+    const uint32_t start = neighbors.size();
+    for (uint32_t i = f.var_start[v]; i < f.var_start[v+1]; i++) {
+        const int c = f.var_lits[i].clause_num;
+        for (uint32_t k = f.cl_start[c]; k < f.cl_start[c+1]; k++) {
+            const int v2 = f.cl_lits[k].var_num;
+            if (!neighbor_flag[v2] && v2 != v) {
+                neighbor_flag[v2] = 1;
+                neighbors.push_back(v2);
+            }
+        }
     }
+    for (uint32_t j = start; j < neighbors.size(); ++j) {
+        neighbor_flag[neighbors[j]] = 0;
+    }
+}
+
+void ls_solver::build_neighborhood()
+{
+    formula& f = *_f;
+    vector<uint8_t> neighbor_flag(_num_vars+1, 0);
+    f.neighbors.clear();
+    f.neighbor_start.assign(_num_vars+2, 0);
     for (int v = 1; v <= _num_vars; ++v) {
-        variable *vp = &(_vars[v]);
-        for (lit lv: vp->literals) {
-            int c = lv.clause_num;
-            for (lit lc: _clauses[c].literals) {
-                if (!neighbor_flag[lc.var_num] && lc.var_num != v) {
-                    neighbor_flag[lc.var_num] = 1;
-                    vp->neighbor_var_nums.push_back(lc.var_num);
-                }
+        f.neighbor_start[v] = f.neighbors.size();
+        add_neighbors_of(f, v, neighbor_flag);
+    }
+    f.neighbor_start[_num_vars+1] = f.neighbors.size();
+}
+
+void ls_solver::sort_ids()
+{
+    formula& f = *_f;
+    f.id_order.resize(_num_clauses);
+    for (int c = 0; c < _num_clauses; c++) {
+        f.id_order[c] = (uint64_t)(uint32_t)f.cl_id[c] << 32 | (uint32_t)c;
+    }
+    std::sort(f.id_order.begin(), f.id_order.end());
+}
+
+//Same as build_neighborhood(), but copies the neighbours of variables that
+//are in exactly the same clauses as in _prev_f
+void ls_solver::build_neighborhood_delta()
+{
+    formula& f = *_f;
+    const formula& prev = *_prev_f;
+    const uint32_t prev_num_clauses = prev.cl_start.size()-1;
+
+    vector<uint8_t> changed(_num_vars+1, 0);
+    for (const int v: _changed_vars) {
+        changed[v] = 1;
+    }
+    auto has_changed_var = [&](const formula& ff, const uint32_t c) {
+        if (_changed_vars.empty()) return false;
+        for (uint32_t k = ff.cl_start[c]; k < ff.cl_start[c+1]; k++) {
+            if (changed[ff.cl_lits[k].var_num]) return true;
+        }
+        return false;
+    };
+
+    //Match clauses by ID, both lists are sorted by it
+    vector<uint8_t> now_matched(_num_clauses, 0);
+    vector<uint8_t> prev_matched(prev_num_clauses, 0);
+    uint32_t i = 0;
+    uint32_t j = 0;
+    while (i < f.id_order.size() && j < prev.id_order.size()) {
+        const uint32_t id = f.id_order[i] >> 32;
+        const uint32_t prev_id = prev.id_order[j] >> 32;
+        if (id < prev_id) {
+            i++;
+        } else if (id > prev_id) {
+            j++;
+        } else {
+            const uint32_t c = (uint32_t)f.id_order[i];
+            const uint32_t pc = (uint32_t)prev.id_order[j];
+            if (id != 0
+                && f.cl_start[c+1]-f.cl_start[c] == prev.cl_start[pc+1]-prev.cl_start[pc]
+                && !has_changed_var(prev, pc)
+            ) {
+                now_matched[c] = 1;
+                prev_matched[pc] = 1;
             }
+            i++;
+            j++;
         }
-        for (uint32_t j = 0; j < vp->neighbor_var_nums.size(); ++j) {
-            neighbor_flag[vp->neighbor_var_nums[j]] = 0;
+    }
+
+    //Variables of added or removed clauses need their neighbours recalculated
+    vector<uint8_t> dirty(_num_vars+1, 0);
+    for (int v = _prev_num_vars+1; v <= _num_vars; v++) {
+        dirty[v] = 1;
+    }
+    for (const int v: _changed_vars) {
+        dirty[v] = 1;
+    }
+    _clauses_added = 0;
+    for (int c = 0; c < _num_clauses; c++) {
+        if (now_matched[c]) continue;
+        _clauses_added++;
+        for (uint32_t k = f.cl_start[c]; k < f.cl_start[c+1]; k++) {
+            dirty[f.cl_lits[k].var_num] = 1;
+        }
+    }
+    _clauses_removed = 0;
+    for (uint32_t c = 0; c < prev_num_clauses; c++) {
+        if (prev_matched[c]) continue;
+        _clauses_removed++;
+        for (uint32_t k = prev.cl_start[c]; k < prev.cl_start[c+1]; k++) {
+            dirty[prev.cl_lits[k].var_num] = 1;
         }
     }
+
+    vector<uint8_t> neighbor_flag(_num_vars+1, 0);
+    f.neighbors.clear();
+    f.neighbors.reserve(prev.neighbors.size());
+    f.neighbor_start.assign(_num_vars+2, 0);
+    for (int v = 1; v <= _num_vars; ++v) {
+        f.neighbor_start[v] = f.neighbors.size();
+        if (dirty[v]) {
+            add_neighbors_of(f, v, neighbor_flag);
+        } else {
+            f.neighbors.insert(f.neighbors.end(),
+                prev.neighbors.begin()+prev.neighbor_start[v],
+                prev.neighbors.begin()+prev.neighbor_start[v+1]);
+        }
+    }
+    f.neighbor_start[_num_vars+1] = f.neighbors.size();
+}
+
+void ls_solver::share_best()
+{
+    std::lock_guard<std::mutex> lock(_shared->mu);
+    if (_best_found_cost < _shared->cost) {
+        _shared->cost = _best_found_cost;
+        _shared->solution = _best_solution;
+        if (_best_found_cost == 0) {
+            _shared->found = true;
+        }
+    }
+}
+
+bool ls_solver::take_shared_best(vector<bool>& solution)
+{
+    std::lock_guard<std::mutex> lock(_shared->mu);
+    if (_shared->cost >= _best_found_cost) {
+        return false;
+    }
+    solution.assign(_shared->solution.begin(), _shared->solution.end());
+    return true;
 }
 
 /****************local search**********************************/
@@ -100,10 +343,12 @@ bool ls_solver::local_search(
 ) {
     bool result = false;
     _random_gen.seed(_random_seed);
+    _mems = 0;
     _best_found_cost = _num_clauses;
     _conflict_ct.clear();
     _conflict_ct.resize(_num_vars+1,0);
 
+    vector<bool> from_shared;
     for (int t = 0; t < _max_tries; t++) {
         initialize(init_solution);
         if (0 == _unsat_clauses.size()) {
@@ -116,8 +361,30 @@ bool ls_solver::local_search(
             flip(flipv);
             for(int var_idx:_unsat_vars) ++_conflict_ct[var_idx];
             if (_mems > _mems_limit) {
+                if (_shared) share_best();
                 return result;
             }
+            if ((_step & 0x3ff) == 0x3ff) {
+                if ((_interrupt && _interrupt->load(std::memory_order_relaxed))
+                    || (_shared && _shared->found.load(std::memory_order_relaxed))
+                ) {
+                    if (_shared) share_best();
+                    return result;
+                }
+            }
+            if (_shared && (_step & 0xffff) == 0xffff) {
+                share_best();
+                if (take_shared_best(from_shared)) {
+                    initialize(&from_shared);
+                    _best_found_cost = _unsat_clauses.size();
+                    std::copy(_solution.begin(), _solution.end(),
+                              _best_solution.begin());
+                    if (_best_found_cost == 0) {
+                        result = true;
+                        break;
+                    }
+                }
+            }
 
 
             if ((int)_unsat_clauses.size() < _best_found_cost) {
@@ -138,6 +405,7 @@ bool ls_solver::local_search(
 
 
             if (_best_found_cost == 0) {
+                if (_shared) share_best();
                 result = true;
                 break;
             }
@@ -147,6 +415,7 @@ bool ls_solver::local_search(
             break;
         }
     }
+    if (_shared) share_best();
     _end_step = _step;
     return result;
 }
@@ -195,7 +464,7 @@ void ls_solver::initialize(const vector<bool> *init_solution)
         _clauses[c].sat_var = -1;
         _clauses[c].weight = 1;
 
-        for (lit l: _clauses[c].literals) {
+        for (lit l: clause_lits(c)) {
             if (_solution[l.var_num] == l.sense) {
                 _clauses[c].sat_count++;
                 _clauses[c].sat_var = l.var_num;
@@ -216,7 +485,7 @@ void ls_solver::initialize_variable_datas()
     for (int v = 1; v <= _num_vars; v++) {
         vp = &(_vars[v]);
         vp->score = 0;
-        for (lit l: vp->literals) {
+        for (lit l: var_lits(v)) {
             int c = l.clause_num;
             if (0 == _clauses[c].sat_count) {
                 vp->score += _clauses[c].weight;
@@ -300,10 +569,10 @@ int ls_solver::pick_var()
 
     /*focused random walk*/
     int c = _unsat_clauses[_random_gen.next(_unsat_clauses.size())];
-    clause *cp = &(_clauses[c]);
-    best_var = cp->literals[0].var_num;
-    for (size_t k = 1; k < cp->literals.size(); k++) {
-        int v = cp->literals[k].var_num;
+    const span<lit> cl = clause_lits(c);
+    best_var = cl[0].var_num;
+    for (size_t k = 1; k < cl.size(); k++) {
+        int v = cl[k].var_num;
         if (_vars[v].score > _vars[best_var].score) {
             best_var = v;
         } else if (_vars[v].score == _vars[best_var].score &&
@@ -319,17 +588,18 @@ void ls_solver::flip(int flipv)
 {
     _solution[flipv] = 1 - _solution[flipv];
     int org_flipv_score = _vars[flipv].score;
-    _mems += _vars[flipv].literals.size();
+    const span<lit> occ = var_lits(flipv);
+    _mems += occ.size();
 
     // Go through each clause the literal is in and update status
-    for (lit l: _vars[flipv].literals) {
+    for (lit l: occ) {
         clause *cp = &(_clauses[l.clause_num]);
         if (_solution[flipv] == l.sense) {
             cp->sat_count++;
             if (1 == cp->sat_count) {
                 sat_a_clause(l.clause_num);
                 cp->sat_var = flipv;
-                for (lit lc: cp->literals) {
+                for (lit lc: clause_lits(l.clause_num)) {
                     _vars[lc.var_num].score -= cp->weight;
                 }
             } else if (2 == cp->sat_count) {
@@ -339,11 +609,11 @@ void ls_solver::flip(int flipv)
             cp->sat_count--;
             if (0 == cp->sat_count) {
                 unsat_a_clause(l.clause_num);
-                for (lit lc: cp->literals) {
+                for (lit lc: clause_lits(l.clause_num)) {
                     _vars[lc.var_num].score += cp->weight;
                 }
             } else if (1 == cp->sat_count) {
-                for (lit lc: cp->literals) {
+                for (lit lc: clause_lits(l.clause_num)) {
                     if (_solution[lc.var_num] == lc.sense) {
                         _vars[lc.var_num].score -= cp->weight;
                         cp->sat_var = lc.var_num;
@@ -378,8 +648,9 @@ void ls_solver::update_cc_after_flip(int flipv)
     }
 
     //update all flipv's neighbor's cc to be 1
-    _mems += vp->neighbor_var_nums.size()/4;
-    for (int v: vp->neighbor_var_nums) {
+    const span<int> neighbors = var_neighbors(flipv);
+    _mems += neighbors.size()/4;
+    for (int v: neighbors) {
         _vars[v].cc_value = 1;
         if (_vars[v].score > 0 && !(_vars[v].is_in_ccd_vars)) {
             _ccd_vars.push_back(v);
@@ -400,7 +671,7 @@ void ls_solver::sat_a_clause(int the_clause)
     }
     _index_in_unsat_clauses[last_item] = index;
     //update unsat_appear and unsat_vars
-    for (lit l: _clauses[the_clause].literals) {
+    for (lit l: clause_lits(the_clause)) {
         _vars[l.var_num].unsat_appear--;
         if (0 == _vars[l.var_num].unsat_appear) {
             last_item = _unsat_vars.back();
@@ -418,7 +689,7 @@ void ls_solver::unsat_a_clause(int the_clause)
     _index_in_unsat_clauses[the_clause] = _unsat_clauses.size();
     _unsat_clauses.push_back(the_clause);
     //update unsat_appear and unsat_vars
-    for (lit l: _clauses[the_clause].literals) {
+    for (lit l: clause_lits(the_clause)) {
         _vars[l.var_num].unsat_appear++;
         if (1 == _vars[l.var_num].unsat_appear) {
             _index_in_unsat_vars[l.var_num] = _unsat_vars.size();
@@ -469,7 +740,7 @@ void ls_solver::smooth_clause_weights()
             _delta_total_clause_weight -= _num_clauses;
         }
         if (0 == cp->sat_count) {
-            for (lit l: cp->literals) {
+            for (lit l: clause_lits(c)) {
                 _vars[l.var_num].score += cp->weight;
             }
         } else if (1 == cp->sat_count) {
@@ -506,7 +777,7 @@ void ls_solver::print_solution(bool need_verify)
     if (need_verify) {
         for (int c = 0; c < _num_clauses; c++) {
             sat_flag = false;
-            for (lit l: _clauses[c].literals) {
+            for (lit l: clause_lits(c)) {
                 if (_solution[l.var_num] == l.sense) {
                     sat_flag = true;
                     break;
@@ -23,7 +23,11 @@ THE SOFTWARE.
 #ifndef CCNR_H
 #define CCNR_H
 
+#include <atomic>
 #include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 #include "ccnr_mersenne.h"
@@ -66,20 +70,55 @@ struct lit {
         return !(*this == l);
     }
 };
+//The literals of clauses, the occurrences of variables and the neighbours
+//of variables are each stored in one flat array (CSR layout), indexed through
+//the _*_start arrays. What's left per variable/clause is the search state.
 struct variable {
-    vector<lit> literals;
-    vector<int> neighbor_var_nums;
-    long long score;
-    long long last_flip_step;
+    int score;
+    int last_flip_step;
     int unsat_appear; //how many unsat clauses it appears in
     bool cc_value;
     bool is_in_ccd_vars;
 };
 struct clause {
-    vector<lit> literals;
     int sat_count; //no. of satisfied literals
     int sat_var;
-    long long weight;
+    int weight;
+};
+
+//The formula in CSR layout. Read-only once built, so that several walkers
+//(see share_formula()) can search it at the same time
+struct formula {
+    vector<lit> cl_lits;
+    vector<uint32_t> cl_start;
+    vector<lit> var_lits;
+    vector<uint32_t> var_start;
+    vector<int> neighbors;
+    vector<uint32_t> neighbor_start;
+
+    //ID of each clause as given by the caller (0 if none), and
+    //ID<<32 | clause number, sorted, to match clauses against the next build
+    vector<int32_t> cl_id;
+    vector<uint64_t> id_order;
+};
+
+//Lowest-cost assignment of all walkers on the same formula
+struct shared_best {
+    std::mutex mu;
+    int cost = std::numeric_limits<int>::max();
+    vector<uint8_t> solution;
+    std::atomic<bool> found{false};
+};
+
+//[begin, end) of a part of one of the flat arrays
+template<class T>
+struct span {
+    const T* b;
+    const T* e;
+    const T* begin() const { return b; }
+    const T* end() const { return e; }
+    uint32_t size() const { return e-b; }
+    const T& operator[](const uint32_t at) const { return b[at]; }
 };
 
 //---------------------------
@@ -102,12 +141,47 @@ class ls_solver
         return _best_found_cost;
     }
     void set_verbosity(uint32_t verb);
+    //Polled during the search, local_search() returns early once it's set
+    void set_interrupt(const std::atomic<bool>* interrupt) { _interrupt = interrupt; }
+    void set_seed(const int seed) { _random_seed = seed; }
+
+    //Building the formula: add_clause() for every clause, then finish_build().
+    //Can be called again on the same solver with the changed formula. Clauses
+    //are then matched by their ID against the last build: the caller must
+    //give a changed clause a new ID, and must call mark_var_changed() for
+    //variables whose fixed value changed, as that changes clauses without
+    //changing their IDs. Only the neighbours of variables in added or removed
+    //clauses are recalculated, and _best_solution is kept to warm-start from.
+    void start_build(int num_vars, int num_clauses_max, size_t num_lits_max);
+    void add_clause(const vector<int>& lits, const int32_t ID = 0);
+    void mark_var_changed(const int v) { _changed_vars.push_back(v); }
+    bool finish_build();
+    uint64_t mem_used() const;
+    int get_prev_num_vars() const { return _prev_num_vars; }
+    int get_clauses_added() const { return _clauses_added; }
+    int get_clauses_removed() const { return _clauses_removed; }
+
+    //Search the (built) formula of another solver. With a shared_best,
+    //walkers publish their best assignment every few thousand steps and
+    //restart from the shared one when it's better than anything they found
+    void share_formula(const ls_solver& other);
+    void set_shared_best(shared_best* best) { _shared = best; }
+
+    span<lit> clause_lits(const int c) const {
+        return span<lit>{_cl_lits+_cl_start[c], _cl_lits+_cl_start[c+1]};
+    }
+    span<lit> var_lits(const int v) const {
+        return span<lit>{_var_lits+_var_start[v], _var_lits+_var_start[v+1]};
+    }
+    span<int> var_neighbors(const int v) const {
+        return span<int>{_neighbors+_neighbor_start[v], _neighbors+_neighbor_start[v+1]};
+    }
 
     //formula
     vector<variable> _vars;
     vector<clause> _clauses;
-    int _num_vars;
-    int _num_clauses;
+    int _num_vars = 0;
+    int _num_clauses = 0;
 
     //data structure used
     vector<int> _conflict_ct;
@@ -121,12 +195,38 @@ class ls_solver
     vector<uint8_t> _solution;
     vector<uint8_t> _best_solution;
 
+    int get_cost() { return _unsat_clauses.size(); }
+
+    private:
+    //CSR storage of the formula, and its arrays cached for the flip loop
+    std::shared_ptr<formula> _f;
+    bool _f_built = false;
+    std::shared_ptr<formula> _prev_f; //last built one, while building
+    int _prev_num_vars = 0;
+    int _clauses_added = 0;
+    int _clauses_removed = 0;
+    vector<int> _changed_vars;
+    const lit* _cl_lits = nullptr;
+    const uint32_t* _cl_start = nullptr;
+    const lit* _var_lits = nullptr;
+    const uint32_t* _var_start = nullptr;
+    const int* _neighbors = nullptr;
+    const uint32_t* _neighbor_start = nullptr;
+    shared_best* _shared = nullptr;
+
     //functions for buiding data structure
     bool make_space();
+    void build_occurrences();
     void build_neighborhood();
-    int get_cost() { return _unsat_clauses.size(); }
+    void build_neighborhood_delta();
+    void sort_ids();
+    void add_neighbors_of(const formula& f, int v, vector<uint8_t>& neighbor_flag);
+    void cache_formula();
+
+    //sharing between walkers
+    void share_best();
+    bool take_shared_best(vector<bool>& solution);
 
-    private:
     int _best_found_cost;
     long long _mems = 0;
     long long _step;
@@ -172,6 +272,7 @@ class ls_solver
     //--------------------
     long long _end_step;
     uint32_t _verbosity = 0;
+    const std::atomic<bool>* _interrupt = nullptr;
 
     long long up_times = 0;
     long long flip_numbers = 0;
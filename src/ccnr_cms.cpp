@@ -25,6 +25,8 @@ THE SOFTWARE.
 #include <cstdio>
 #include <cmath>
 #include <cstdlib>
+#include <numeric>
+#include <thread>
 #include "constants.h"
 #include "ccnr_cms.h"
 #include "solver.h"
@@ -48,17 +50,50 @@ CMS_ccnr::~CMS_ccnr()
     delete ls_s;
 }
 
+uint64_t CMS_ccnr::mem_used() const
+{
+    uint64_t mem = ls_s->mem_used();
+    mem += phases.capacity()/8;
+    mem += yals_lits.capacity()*sizeof(int);
+    mem += fixed_at_build.capacity()*sizeof(lbool);
+    return mem;
+}
+
 lbool CMS_ccnr::main(const uint32_t num_sls_called)
 {
+    double startTime = cpuTime();
+    if (!snapshot()) {
+        return l_Undef;
+    }
+    search();
+    lbool ret = apply(num_sls_called);
+
+    double time_used = cpuTime()-startTime;
+    if (solver->conf.verbosity) {
+        cout << "c [ccnr] time: " << time_used << endl;
+    }
+    if (solver->sqlStats) {
+        solver->sqlStats->time_passed_min(
+            solver
+            , "sls-ccnr"
+            , time_used
+        );
+    }
+
+    return ret;
+}
+
+bool CMS_ccnr::snapshot()
+{
+    const double myTime = cpuTime();
     //It might not work well with few number of variables
     //rnovelty could also die/exit(-1), etc.
     if (solver->nVars() < 50 ||
         solver->binTri.irredBins + solver->longIrredCls.size() < 10
     ) {
         verb_print(1, "[ccnr] too few variables & clauses");
-        return l_Undef;
+        return false;
     }
-    double startTime = cpuTime();
 
     if (!init_problem()) {
         //it's actually l_False under assumptions
@@ -67,34 +102,99 @@ lbool CMS_ccnr::main(const uint32_t num_sls_called)
             cout << "c [ccnr] problem UNSAT under assumptions, returning to main solver"
             << endl;
         }
-        return l_Undef;
+        return false;
     }
-
-    vector<bool> phases(solver->nVars()+1);
+    if (!ls_s->finish_build()) {
+        return false;
+    }
+    verb_print(1, "[ccnr] clauses: " << ls_s->_num_clauses
+        << " added: " << ls_s->get_clauses_added()
+        << " removed: " << ls_s->get_clauses_removed()
+        << " since last call"
+        << solver->conf.print_times(cpuTime() - myTime));
+
+    //Warm start from the last best assignment, CDCL's best phases otherwise
+    phases.assign(solver->nVarsOuter()+1, false);
     for(uint32_t i = 0; i < solver->nVars(); i++) {
-        phases[i+1] = solver->varData[i].best_polarity;
+        phases[solver->map_inter_to_outer(i)+1] = solver->varData[i].best_polarity;
+    }
+    for(int v = 1; v <= ls_s->get_prev_num_vars(); v++) {
+        phases[v] = ls_s->_best_solution[v];
     }
+    mems_limit = (long long)solver->conf.yalsat_max_mems*2*1000*1000;
+    num_walkers = std::max(1U, solver->conf.sls_walkers);
+    return true;
+}
 
-    int res = ls_s->local_search(&phases, solver->conf.yalsat_max_mems*2*1000*1000);
-    lbool ret = deal_with_solution(res, num_sls_called);
+void CMS_ccnr::search(const std::atomic<bool>* interrupt)
+{
+    if (num_walkers > 1) {
+        search_walkers(interrupt);
+        return;
+    }
 
-    double time_used = cpuTime()-startTime;
-    if (solver->conf.verbosity) {
-        cout << "c [ccnr] time: " << time_used << endl;
+    ls_s->set_interrupt(interrupt);
+    sls_res = ls_s->local_search(&phases, mems_limit);
+    ls_s->set_interrupt(nullptr);
+}
+
+//Walkers with different seeds on the formula of ls_s, the first one on this
+//thread. The one with the lowest cost takes the place of ls_s, so apply()
+//uses its phases, clause weights and conflict counts.
+void CMS_ccnr::search_walkers(const std::atomic<bool>* interrupt)
+{
+    CCNR::shared_best best;
+    vector<CCNR::ls_solver*> walkers;
+    walkers.push_back(ls_s);
+    for(uint32_t i = 1; i < num_walkers; i++) {
+        CCNR::ls_solver* w = new CCNR::ls_solver(solver->conf.sls_ccnr_asipire);
+        w->share_formula(*ls_s);
+        w->set_seed(1+i);
+        walkers.push_back(w);
     }
-    if (solver->sqlStats) {
-        solver->sqlStats->time_passed_min(
-            solver
-            , "sls-ccnr"
-            , time_used
-        );
+
+    vector<int> res(num_walkers, 0);
+    vector<std::thread> threads;
+    for(uint32_t i = 0; i < num_walkers; i++) {
+        walkers[i]->set_interrupt(interrupt);
+        walkers[i]->set_shared_best(&best);
     }
+    for(uint32_t i = 1; i < num_walkers; i++) {
+        threads.push_back(std::thread([&, i]() {
+            res[i] = walkers[i]->local_search(&phases, mems_limit);
+        }));
+    }
+    res[0] = walkers[0]->local_search(&phases, mems_limit);
+    for(auto& t: threads) t.join();
+
+    uint32_t win = 0;
+    for(uint32_t i = 0; i < num_walkers; i++) {
+        walkers[i]->set_interrupt(nullptr);
+        walkers[i]->set_shared_best(nullptr);
+        if (walkers[i]->get_best_cost() < walkers[win]->get_best_cost()) {
+            win = i;
+        }
+    }
+    verb_print(1, "[ccnr] walkers: " << num_walkers
+        << " best cost: " << walkers[win]->get_best_cost()
+        << " by walker " << win);
+
+    ls_s = walkers[win];
+    sls_res = res[win];
+    for(uint32_t i = 0; i < num_walkers; i++) {
+        if (i != win) delete walkers[i];
+    }
+}
 
-    return ret;
+lbool CMS_ccnr::apply(const uint32_t num_sls_called)
+{
+    //No new variables since snapshot(), and no renumbering either
+    assert((int)solver->nVarsOuter() == ls_s->_num_vars);
+    return deal_with_solution(sls_res, num_sls_called);
 }
 
 template<class T>
-CMS_ccnr::add_cl_ret CMS_ccnr::add_this_clause(const T& cl)
+CMS_ccnr::add_cl_ret CMS_ccnr::add_this_clause(const T& cl, const int32_t ID)
 {
     uint32_t sz = 0;
     bool sat = false;
@@ -116,8 +216,9 @@ CMS_ccnr::add_cl_ret CMS_ccnr::add_this_clause(const T& cl)
         } else if (val == l_False) {
             continue;
         }
-        int l = lit.var()+1;
-        l *= lit.sign() ? -1 : 1;
+        const Lit outer = solver->map_inter_to_outer(lit);
+        int l = outer.var()+1;
+        l *= outer.sign() ? -1 : 1;
         yals_lits.push_back(l);
         sz++;
     }
@@ -132,9 +233,7 @@ CMS_ccnr::add_cl_ret CMS_ccnr::add_this_clause(const T& cl)
         return add_cl_ret::unsat;
     }
 
-    for(auto& lit: yals_lits) {
-        ls_s->_clauses[cl_num].literals.push_back(CCNR::lit(lit, cl_num));
-    }
+    ls_s->add_clause(yals_lits, ID);
     cl_num++;
 
     return add_cl_ret::added_cl;
@@ -150,9 +249,28 @@ bool CMS_ccnr::init_problem()
     solver->check_stats();
     #endif
 
-    ls_s->_num_vars = solver->nVars();
-    ls_s->_num_clauses = solver->longIrredCls.size() + solver->binTri.irredBins;
-    ls_s->make_space();
+    //In outer numbering, so that it stays valid across renumbering and can
+    //be matched against the formula of the last call
+    cl_num = 0;
+    ls_s->start_build(
+        solver->nVarsOuter(),
+        solver->longIrredCls.size() + solver->binTri.irredBins,
+        solver->litStats.irredLits + solver->binTri.irredBins*2);
+
+    //Clauses are matched by ID, and every change to a clause gives it a new
+    //one. Level-0 values and assumptions change the clauses given to CCNR
+    //without that, so variables whose value changed are passed on instead
+    fixed_at_build.resize(solver->nVarsOuter(), l_Undef);
+    for(uint32_t i = 0; i < solver->nVars(); i++) {
+        const Lit lit = Lit(i, false);
+        lbool val = solver->value(lit);
+        if (val == l_Undef) val = solver->lit_inside_assumptions(lit);
+        const uint32_t outer = solver->map_inter_to_outer(i);
+        if (fixed_at_build[outer] != val) {
+            ls_s->mark_var_changed(outer+1);
+            fixed_at_build[outer] = val;
+        }
+    }
 
     vector<Lit> this_clause;
     for(size_t i2 = 0; i2 < solver->nVars()*2; i2++) {
@@ -163,7 +281,7 @@ bool CMS_ccnr::init_problem()
                 this_clause.push_back(lit);
                 this_clause.push_back(w.lit2());
 
-                if (add_this_clause(this_clause) == add_cl_ret::unsat) {
+                if (add_this_clause(this_clause, w.get_ID()) == add_cl_ret::unsat) {
                     return false;
                 }
             }
@@ -174,33 +292,25 @@ bool CMS_ccnr::init_problem()
         assert(!cl->freed());
         assert(!cl->getRemoved());
 
-        if (add_this_clause(*cl) == add_cl_ret::unsat) {
+        if (add_this_clause(*cl, cl->stats.ID) == add_cl_ret::unsat) {
             return false;
         }
     }
 
-    //Shrink the space if we have to
-    assert(ls_s->_num_clauses >= (int)cl_num);
-    ls_s->_num_clauses = (int)cl_num;
-    ls_s->make_space();
-
-    for (int c=0; c < ls_s->_num_clauses; c++) {
-        for(CCNR::lit item: ls_s->_clauses[c].literals) {
-            int v = item.var_num;
-            ls_s->_vars[v].literals.push_back(item);
-        }
-    }
-    ls_s->build_neighborhood();
-
+    assert(ls_s->_num_clauses == (int)cl_num);
     return true;
 }
 
 struct ClWeightSorter
 {
-    bool operator()(const CCNR::clause& a, const CCNR::clause& b)
+    explicit ClWeightSorter(const vector<CCNR::clause>& _clauses) :
+        clauses(_clauses)
+    {}
+    bool operator()(const int a, const int b) const
     {
-        return a.weight > b.weight;
+        return clauses[a].weight > clauses[b].weight;
     }
+    const vector<CCNR::clause>& clauses;
 };
 
 struct VarAndVal {
@@ -229,15 +339,17 @@ vector<pair<uint32_t, double>> CMS_ccnr::get_bump_based_on_cls()
     SLOW_DEBUG_DO(for(const auto x: seen) assert(x == 0));
 
     vector<pair<uint32_t, double>> tobump_cl_var;
-    std::sort(ls_s->_clauses.begin(), ls_s->_clauses.end(), ClWeightSorter());
+    vector<int> cls_by_weight(ls_s->_num_clauses);
+    std::iota(cls_by_weight.begin(), cls_by_weight.end(), 0);
+    std::sort(cls_by_weight.begin(), cls_by_weight.end(), ClWeightSorter(ls_s->_clauses));
     uint32_t vars_bumped = 0;
     uint32_t individual_vars_bumped = 0;
-    for(const auto& c: ls_s->_clauses) {
+    for(const int c: cls_by_weight) {
         if (vars_bumped > solver->conf.sls_how_many_to_bump)
             break;
 
-        for(uint32_t i = 0; i < c.literals.size(); i++) {
-            uint32_t v = c.literals[i].var_num-1;
+        for(const CCNR::lit l: ls_s->clause_lits(c)) {
+            uint32_t v = solver->map_outer_to_inter(l.var_num-1);
             if (v < solver->nVars() &&
                 solver->varData[v].removed == Removed::none &&
                 solver->value(v) == l_Undef &&
@@ -261,13 +373,15 @@ vector<pair<uint32_t, double>> CMS_ccnr::get_bump_based_on_cls()
 vector<pair<uint32_t, double>> CMS_ccnr::get_bump_based_on_var_scores()
 {
     vector<VarAndVal> vs;
-    for(uint32_t i = 1; i < ls_s->_vars.size(); i++) {
-        vs.push_back(VarAndVal(i-1, ls_s->_vars[i].score));
+    for(uint32_t i = 0; i < solver->nVars(); i++) {
+        const uint32_t outer = solver->map_inter_to_outer(i);
+        vs.push_back(VarAndVal(i, ls_s->_vars[outer+1].score));
     }
     std::sort(vs.begin(), vs.end(), VarValSorter());
 
     vector<pair<uint32_t, double>> tobump;
-    for(uint32_t i = 0; i < solver->conf.sls_how_many_to_bump; i++) {
+    const size_t to_bump = std::min<size_t>(solver->conf.sls_how_many_to_bump, vs.size());
+    for(uint32_t i = 0; i < to_bump; i++) {
 //         cout << "var: " << vs[i].var + 1 << " score: " <<  vs[i].val << endl;
         tobump.push_back(std::make_pair(vs[i].var, 3.0));
     }
@@ -286,12 +400,12 @@ vector<pair<uint32_t, double>> CMS_ccnr::get_bump_based_on_conflict_ct()
         mymax = std::max(mymax, ls_s->_conflict_ct[i]);
     }
 
-    for(uint32_t i = 1; i < ls_s->_conflict_ct.size(); i++) {
-        double val = ls_s->_conflict_ct[i];
+    for(uint32_t i = 0; i < solver->nVars(); i++) {
+        double val = ls_s->_conflict_ct[solver->map_inter_to_outer(i)+1];
         if (mymax > 0) {
-            tobump.push_back(std::make_pair(i-1, (double)val/(double)mymax * 3.0));
+            tobump.push_back(std::make_pair(i, (double)val/(double)mymax * 3.0));
         } else {
-            tobump.push_back(std::make_pair(i-1, 0));
+            tobump.push_back(std::make_pair(i, 0));
         }
 //         if (tobump.back().second > 0) {
 //             cout << "var: " << tobump.back().first << " bump by: " << tobump.back().second << endl;
@@ -311,9 +425,10 @@ lbool CMS_ccnr::deal_with_solution(int res, const uint32_t num_sls_called)
         }
 
         for(size_t i = 0; i < solver->nVars(); i++) {
-            solver->varData[i].stable_polarity = ls_s->_best_solution[i+1];
+            const bool val = ls_s->_best_solution[solver->map_inter_to_outer(i)+1];
+            solver->varData[i].stable_polarity = val;
             if (res) {
-                solver->varData[i].best_polarity = ls_s->_best_solution[i+1];
+                solver->varData[i].best_polarity = val;
             }
         }
     }
@@ -23,6 +23,7 @@ THE SOFTWARE.
 #ifndef CMS_ccnr_H
 #define CMS_ccnr_H
 
+#include <atomic>
 #include <cstdint>
 #include <cstdio>
 #include <utility>
@@ -44,8 +45,21 @@ public:
     CMS_ccnr(Solver* _solver);
     ~CMS_ccnr();
 
+    //main() in three steps, so the flipping can run on a different thread.
+    //snapshot() and apply() read and write the solver, search() does not
+    bool snapshot();
+    void search(const std::atomic<bool>* interrupt = nullptr);
+    lbool apply(const uint32_t num_sls_called);
+    bool found_solution() const { return sls_res; }
+    uint64_t mem_used() const;
+
 private:
     Solver* solver;
+    vector<bool> phases;
+    long long mems_limit = 0;
+    uint32_t num_walkers = 1;
+    void search_walkers(const std::atomic<bool>* interrupt);
+    int sls_res = 0;
 
     /************************************/
     /* Main                             */
@@ -64,8 +78,9 @@ private:
 
     enum class add_cl_ret {added_cl, skipped_cl, unsat};
     template<class T>
-    add_cl_ret add_this_clause(const T& cl);
+    add_cl_ret add_this_clause(const T& cl, const int32_t ID);
     vector<int> yals_lits;
+    vector<lbool> fixed_at_build; //value or assumption of outer vars at the last build
     vector<uint32_t>& seen;
     vector<Lit>& toClear;
 
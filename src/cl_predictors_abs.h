@@ -28,7 +28,6 @@ THE SOFTWARE.
 #include <cassert>
 #include <string>
 #include <cmath>
-#include <xgboost/c_api.h>
 #include "clause.h"
 
 #define PRED_COLS 22
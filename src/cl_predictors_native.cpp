@@ -0,0 +1,91 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#include "cl_predictors_native.h"
+#include "clause.h"
+#include "solver.h"
+
+extern char predictor_short_json[];
+extern unsigned int predictor_short_json_len;
+
+extern char predictor_long_json[];
+extern unsigned int predictor_long_json_len;
+
+extern char predictor_forever_json[];
+extern unsigned int predictor_forever_json_len;
+
+using namespace CMSat;
+using std::string;
+
+ClPredictorsNative::ClPredictorsNative()
+{
+}
+
+ClPredictorsNative::~ClPredictorsNative()
+{
+}
+
+int ClPredictorsNative::load_models(const std::string& short_fname,
+                               const std::string& long_fname,
+                               const std::string& forever_fname,
+                               const std::string& /*best_feats_fname*/)
+{
+    if (!forests[predict_type::short_pred].load_file(short_fname, PRED_COLS)
+        || !forests[predict_type::long_pred].load_file(long_fname, PRED_COLS)
+        || !forests[predict_type::forever_pred].load_file(forever_fname, PRED_COLS)
+    ) {
+        return 0;
+    }
+    return 1;
+}
+
+int ClPredictorsNative::load_models_from_buffers()
+{
+    if (!forests[predict_type::short_pred].load(predictor_short_json, predictor_short_json_len, PRED_COLS)
+        || !forests[predict_type::long_pred].load(predictor_long_json, predictor_long_json_len, PRED_COLS)
+        || !forests[predict_type::forever_pred].load(predictor_forever_json, predictor_forever_json_len, PRED_COLS)
+    ) {
+        return 1;
+    }
+    return 0;
+}
+
+void ClPredictorsNative::predict_all(
+    float* const data,
+    const uint32_t num)
+{
+    for(uint32_t i = 0; i < 3; i++) {
+        out_result[i].resize(num);
+        forests[i].predict(data, num, out_result[i].data());
+    }
+}
+
+void ClPredictorsNative::get_prediction_at(ClauseStatsExtra& extdata, const uint32_t at)
+{
+    extdata.pred_short_use   = out_result[predict_type::short_pred][at];
+    extdata.pred_long_use    = out_result[predict_type::long_pred][at];
+    extdata.pred_forever_use = out_result[predict_type::forever_pred][at];
+}
+
+void CMSat::ClPredictorsNative::finish_all_predict()
+{
+}
@@ -41,6 +41,12 @@ THE SOFTWARE.
 #include "valgrind/memcheck.h"
 #endif
 
+#if !defined(_WIN32) && !defined(__EMSCRIPTEN__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define CLAUSE_ARENA_MMAP
+#endif
+
 using namespace CMSat;
 
 using std::pair;
@@ -59,6 +65,22 @@ using std::endl;
 
 #define MAXSIZE ((1ULL << (EFFECTIVELY_USEABLE_BITS))-1)
 
+//Address space reserved for the clause arena: ARENA_RESERVE_MULT times what is
+//needed now, within the limits below. Only pages actually committed (and
+//touched) cost memory. When the range runs out, the clauses move to a new one
+#ifdef LARGE_OFFSETS
+#define ARENA_MAX_RESERVE_BYTES (1ULL << 36)
+#else
+#define ARENA_MAX_RESERVE_BYTES (1ULL << 32)
+#endif
+#define ARENA_MIN_RESERVE_BYTES (16ULL*1024ULL*1024ULL)
+#define ARENA_RESERVE_MULT 8
+#define HUGEPAGE_BYTES (2ULL*1024ULL*1024ULL)
+
+//Small arenas are committed in normal pages, so small formulas don't pay for
+//a whole hugepage
+#define ARENA_HUGEPAGE_MIN_RESERVE_BYTES (64ULL*HUGEPAGE_BYTES)
+
 ClauseAllocator::ClauseAllocator() :
     dataStart(NULL)
     , size(0)
@@ -73,7 +95,168 @@ ClauseAllocator::ClauseAllocator() :
 */
 ClauseAllocator::~ClauseAllocator()
 {
-    free(dataStart);
+    if (dataStart != NULL) {
+        free_storage(dataStart, reserved);
+    }
+}
+
+void ClauseAllocator::set_backend(const bool arena, const bool hugepages)
+{
+    use_arena = arena;
+    use_hugepages = hugepages;
+}
+
+#ifdef CLAUSE_ARENA_MMAP
+static uint64_t arena_granule_bytes(const bool hugepages, const uint64_t reserve_bytes)
+{
+    if (hugepages && reserve_bytes >= ARENA_HUGEPAGE_MIN_RESERVE_BYTES) {
+        return HUGEPAGE_BYTES;
+    }
+    return sysconf(_SC_PAGESIZE);
+}
+#endif
+
+bool ClauseAllocator::uses_arena() const
+{
+    return reserved != 0;
+}
+
+/**
+@brief Allocates storage for at least min_capacity BASE_DATA_TYPE-s
+
+If the arena is on, tries to reserve a range of address space a few times
+larger than min_capacity, with nothing committed but the first min_capacity
+worth of pages, so that it can later grow in place. If that is not possible
+(e.g. due to ulimit -v), it falls back to malloc. In that case new_reserved
+is 0.
+*/
+BASE_DATA_TYPE* ClauseAllocator::new_storage(
+    const uint64_t min_capacity
+    , uint64_t& new_capacity
+    , uint64_t& new_reserved
+) {
+    #ifdef CLAUSE_ARENA_MMAP
+    if (use_arena && sizeof(void*) >= 8) {
+        //The range is aligned to, and is a multiple of, the commit granule.
+        //It never goes over MAXSIZE so offsets inside it are always valid
+        uint64_t reserve_elems = min_capacity*ARENA_RESERVE_MULT;
+        reserve_elems = std::max<uint64_t>(
+            reserve_elems, ARENA_MIN_RESERVE_BYTES/sizeof(BASE_DATA_TYPE));
+        reserve_elems = std::min<uint64_t>(
+            reserve_elems, ARENA_MAX_RESERVE_BYTES/sizeof(BASE_DATA_TYPE));
+        reserve_elems = std::max<uint64_t>(reserve_elems, min_capacity);
+        reserve_elems = std::min<uint64_t>(reserve_elems, MAXSIZE);
+        const uint64_t granule = arena_granule_bytes(
+            use_hugepages, reserve_elems*sizeof(BASE_DATA_TYPE));
+        const uint64_t reserve_bytes =
+            (reserve_elems*sizeof(BASE_DATA_TYPE)/granule)*granule;
+
+        const uint64_t map_bytes = reserve_bytes + granule;
+        void* mem = mmap(NULL, map_bytes, PROT_NONE
+            , MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (mem != MAP_FAILED) {
+            //Trim to an aligned range
+            char* const start = (char*)mem;
+            char* const end = start + map_bytes;
+            char* const aligned = (char*)
+                (((uintptr_t)start + granule - 1) & ~(uintptr_t)(granule - 1));
+            if (aligned != start) {
+                munmap(start, aligned - start);
+            }
+            if (aligned + reserve_bytes != end) {
+                munmap(aligned + reserve_bytes, end - (aligned + reserve_bytes));
+            }
+
+            #ifdef MADV_HUGEPAGE
+            if (granule == HUGEPAGE_BYTES) {
+                //Failure (e.g. THP disabled) is harmless
+                madvise(aligned, reserve_bytes, MADV_HUGEPAGE);
+            }
+            #endif
+
+            BASE_DATA_TYPE* data = (BASE_DATA_TYPE*)aligned;
+            new_reserved = reserve_bytes/sizeof(BASE_DATA_TYPE);
+            new_capacity = 0;
+            if (commit_storage(data, new_reserved, new_capacity, min_capacity)) {
+                return data;
+            }
+            free_storage(data, new_reserved);
+        }
+
+        //Don't try again
+        use_arena = false;
+    }
+    #endif
+
+    new_reserved = 0;
+    new_capacity = min_capacity;
+    BASE_DATA_TYPE* data = (BASE_DATA_TYPE*)malloc(
+        std::max<uint64_t>(min_capacity, 1)*sizeof(BASE_DATA_TYPE));
+    if (data == NULL) {
+        std::cerr
+        << "ERROR: while allocating clause space"
+        << endl;
+
+        throw std::bad_alloc();
+    }
+    return data;
+}
+
+/**
+@brief Makes sure at least min_capacity of the reserved range is usable
+
+Returns false if the reserved range is too small, or committing failed
+*/
+bool ClauseAllocator::commit_storage(
+    BASE_DATA_TYPE* data
+    , const uint64_t data_reserved
+    , uint64_t& data_capacity
+    , const uint64_t min_capacity
+) const {
+    #ifdef CLAUSE_ARENA_MMAP
+    if (min_capacity > data_reserved) {
+        return false;
+    }
+    if (min_capacity <= data_capacity) {
+        return true;
+    }
+
+    //Commit whole granules, so hugepages can back all of it
+    const uint64_t granule_elems = arena_granule_bytes(
+        use_hugepages, data_reserved*sizeof(BASE_DATA_TYPE))/sizeof(BASE_DATA_TYPE);
+    uint64_t new_capacity =
+        ((min_capacity + granule_elems - 1)/granule_elems)*granule_elems;
+    new_capacity = std::min(new_capacity, data_reserved);
+
+    if (mprotect(data + data_capacity
+        , (new_capacity - data_capacity)*sizeof(BASE_DATA_TYPE)
+        , PROT_READ | PROT_WRITE) != 0
+    ) {
+        return false;
+    }
+    data_capacity = new_capacity;
+    return true;
+    #else
+    (void)data;
+    (void)data_reserved;
+    (void)data_capacity;
+    (void)min_capacity;
+    return false;
+    #endif
+}
+
+void ClauseAllocator::free_storage(
+    BASE_DATA_TYPE* data
+    , const uint64_t data_reserved
+) const {
+    if (data_reserved == 0) {
+        free(data);
+        return;
+    }
+
+    #ifdef CLAUSE_ARENA_MMAP
+    munmap(data, data_reserved*sizeof(BASE_DATA_TYPE));
+    #endif
 }
 
 void* ClauseAllocator::allocEnough(
@@ -118,25 +301,43 @@ void* ClauseAllocator::allocEnough(
             throw std::bad_alloc();
         }
 
-        //Reallocate data
-        BASE_DATA_TYPE* new_dataStart;
-        new_dataStart = (BASE_DATA_TYPE*)realloc(
-            dataStart
-            , newcapacity*sizeof(BASE_DATA_TYPE)
-        );
-
-        //Realloc failed?
-        if (new_dataStart == NULL) {
-            std::cerr
-            << "ERROR: while reallocating clause space"
-            << endl;
+        if (dataStart == NULL) {
+            dataStart = new_storage(newcapacity, capacity, reserved);
+        } else if (reserved != 0) {
+            //Commit more of the reserved range, no copying needed
+            if (!commit_storage(dataStart, reserved, capacity, newcapacity)) {
+                //Reserved range exhausted, move to a larger one
+                uint64_t new_capacity;
+                uint64_t new_reserved;
+                BASE_DATA_TYPE* new_dataStart =
+                    new_storage(newcapacity, new_capacity, new_reserved);
+                memcpy(new_dataStart, dataStart, size*sizeof(BASE_DATA_TYPE));
+                free_storage(dataStart, reserved);
+                dataStart = new_dataStart;
+                capacity = new_capacity;
+                reserved = new_reserved;
+            }
+        } else {
+            //Reallocate data
+            BASE_DATA_TYPE* new_dataStart;
+            new_dataStart = (BASE_DATA_TYPE*)realloc(
+                dataStart
+                , newcapacity*sizeof(BASE_DATA_TYPE)
+            );
+
+            //Realloc failed?
+            if (new_dataStart == NULL) {
+                std::cerr
+                << "ERROR: while reallocating clause space"
+                << endl;
+
+                throw std::bad_alloc();
+            }
+            dataStart = new_dataStart;
 
-            throw std::bad_alloc();
+            //Update capacity to reflect the update
+            capacity = newcapacity;
         }
-        dataStart = new_dataStart;
-
-        //Update capacity to reflect the update
-        capacity = newcapacity;
     }
 
     //Add clause to the set
@@ -222,16 +423,54 @@ void ClauseAllocator::move_one_watchlist(
         if (w.isClause()) {
             Clause* old = ptr(w.get_offset());
             assert(!old->freed());
-            Lit blocked = w.getBlockedLit();
             if (old->reloced) {
                 ClOffset new_offset = (*old)[0].toInt();
                 #ifdef LARGE_OFFSETS
                 new_offset += ((uint64_t)(*old)[1].toInt())<<32;
                 #endif
-                w = Watched(new_offset, blocked);
+                w.setOffset(new_offset);
             } else {
                 ClOffset new_offset = move_cl(newDataStart, new_ptr, old);
-                w = Watched(new_offset, blocked);
+                w.setOffset(new_offset);
+            }
+        }
+    }
+}
+
+/**
+@brief Which part of the consolidated stack a clause goes into
+
+Hot tier-0 learnt clauses come first, then irredundant ones, then the colder
+tiers of learnt clauses
+*/
+uint32_t ClauseAllocator::layout_group(const Clause* cl)
+{
+    if (!cl->red()) {
+        return 1;
+    }
+    if (cl->stats.which_red_array == 0) {
+        return 0;
+    }
+    return cl->stats.which_red_array + 1;
+}
+
+/**
+@brief Moves the not-yet-moved clauses of the given group watched in ws
+
+Watches are NOT updated, that is left to move_one_watchlist()
+*/
+void ClauseAllocator::move_watched_of_group(
+    watch_subarray_const ws
+    , const uint32_t group
+    , ClOffset* newDataStart
+    , ClOffset*& new_ptr
+) {
+    for(const Watched& w: ws) {
+        if (w.isClause()) {
+            Clause* old = ptr(w.get_offset());
+            assert(!old->freed());
+            if (!old->reloced && layout_group(old) == group) {
+                move_cl(newDataStart, new_ptr, old);
             }
         }
     }
@@ -244,8 +483,14 @@ Firstly, the algorithm determines if the number of useless slots is large or
 small compared to the problem size. If it is small, it does nothing. If it is
 large, then it allocates new stacks, copies the non-freed clauses to these new
 stacks, updates all pointers and offsets, and frees the original stacks.
+
+Clauses are laid out in the order the watchlists are visited. With
+consolidate_order=1, the stack is also split into groups (see layout_group()),
+so clauses touched most by propagation are packed together.
+
+Returns whether it consolidated.
 */
-void ClauseAllocator::consolidate(
+bool ClauseAllocator::consolidate(
     Solver* solver
     , const bool force
     , bool lower_verb
@@ -263,17 +508,28 @@ void ClauseAllocator::consolidate(
         ) {
             cout << "c Not consolidating memory." << endl;
         }
-        return;
+        return false;
     }
     const double myTime = cpuTime();
 
     //Pointers that will be moved along
-    BASE_DATA_TYPE * const newDataStart = (BASE_DATA_TYPE*)malloc(currentlyUsedSize*sizeof(BASE_DATA_TYPE));
+    uint64_t new_capacity;
+    uint64_t new_reserved;
+    BASE_DATA_TYPE * const newDataStart =
+        new_storage(currentlyUsedSize, new_capacity, new_reserved);
     BASE_DATA_TYPE * new_ptr = newDataStart;
 
     assert(sizeof(BASE_DATA_TYPE) % sizeof(Lit) == 0);
 
-    vector<bool> visited(solver->watches.size(), 0);
+    if (solver->conf.consolidate_order == 1) {
+        //Groups 0..2 here, the last one (tier-2) is moved by the pass below
+        //that also updates the watches
+        for(uint32_t group = 0; group < 3; group++) {
+            for(const auto& ws: solver->watches) {
+                move_watched_of_group(ws, group, newDataStart, new_ptr);
+            }
+        }
+    }
     for(auto& ws: solver->watches) {
         move_one_watchlist(ws, newDataStart, new_ptr);
     }
@@ -309,10 +565,13 @@ void ClauseAllocator::consolidate(
     //Update sizes
     const uint64_t old_size = size;
     size = new_ptr-newDataStart;
-    capacity = currentlyUsedSize;
+    capacity = new_capacity;
     currentlyUsedSize = size;
-    free(dataStart);
+    if (dataStart != NULL) {
+        free_storage(dataStart, reserved);
+    }
     dataStart = newDataStart;
+    reserved = new_reserved;
 
     const double time_used = cpuTime() - myTime;
     if (solver->conf.verbosity >= 2
@@ -326,7 +585,8 @@ void ClauseAllocator::consolidate(
         cout << "c [mem] consolidate ";
         cout << " old-sz: " << print_value_kilo_mega(old_size*sizeof(BASE_DATA_TYPE))
         << " new-sz: " << print_value_kilo_mega(size*sizeof(BASE_DATA_TYPE))
-        << " new bits offs: " << std::fixed << std::setprecision(2) << log_2_size;
+        << " new bits offs: " << std::fixed << std::setprecision(2) << log_2_size
+        << " backend: " << (reserved ? "arena" : "malloc");
         cout << solver->conf.print_times(time_used)
         << endl;
     }
@@ -337,6 +597,8 @@ void ClauseAllocator::consolidate(
             , time_used
         );
     }
+
+    return true;
 }
 
 void ClauseAllocator::update_offsets(
@@ -51,6 +51,12 @@ needed. When instructed, it consolidates the unused space (i.e. clauses free()-e
 Essentially, it is a stack-like allocator for clauses. It is useful to have
 this, because this way, we can address clauses according to their number,
 which is 32-bit, instead of their address, which might be 64-bit
+
+By default the stack is malloc/realloc-ed. With the arena on (--clarena), it
+lives in a virtual address range reserved a few times larger than needed, and
+pages are committed on demand. Growing the stack then rarely copies, and large
+ranges can be backed by transparent hugepages to lower TLB misses when
+dereferencing clauses during propagation.
 */
 class ClauseAllocator {
     public:
@@ -79,13 +85,15 @@ class ClauseAllocator {
         void clauseFree(Clause* c);
         void clauseFree(ClOffset offset);
 
-        void consolidate(
+        bool consolidate(
             Solver* solver
             , const bool force = false
             , bool lower_verb = false
         );
 
         size_t mem_used() const;
+        void set_backend(const bool arena, const bool hugepages);
+        bool uses_arena() const;
 
     private:
         void update_offsets(
@@ -95,6 +103,13 @@ class ClauseAllocator {
         );
         void move_one_watchlist(
             watch_subarray& ws, ClOffset* newDataStart, ClOffset*& new_ptr);
+        void move_watched_of_group(
+            watch_subarray_const ws
+            , const uint32_t group
+            , ClOffset* newDataStart
+            , ClOffset*& new_ptr
+        );
+        static uint32_t layout_group(const Clause* cl);
 
         ClOffset move_cl(
             ClOffset* newDataStart
@@ -120,6 +135,23 @@ class ClauseAllocator {
         */
         uint64_t currentlyUsedSize;
 
+        //Storage backend
+        uint64_t reserved = 0; ///<Size of reserved address range in BASE_DATA_TYPE units, 0 if malloc-ed
+        bool use_arena = false;
+        bool use_hugepages = true;
+        BASE_DATA_TYPE* new_storage(
+            const uint64_t min_capacity
+            , uint64_t& new_capacity
+            , uint64_t& new_reserved
+        );
+        bool commit_storage(
+            BASE_DATA_TYPE* data
+            , const uint64_t data_reserved
+            , uint64_t& data_capacity
+            , const uint64_t min_capacity
+        ) const;
+        void free_storage(BASE_DATA_TYPE* data, const uint64_t data_reserved) const;
+
         void* allocEnough(const uint32_t num_lits);
 };
 
@@ -237,6 +237,16 @@ inline void CNF::updateWatch(
         } else {
             it->setElimedLit(blocked_lit);
         }
+
+        //Second blocker of 3-long clause is renumbered along with the clause
+        if (it->hasSecondBlocker()) {
+            const Lit second_blocker = getUpdatedLit(it->getSecondBlocker(), outerToInter);
+            if (std::find(cl.begin(), cl.end(), second_blocker) != cl.end()) {
+                it->setSecondBlocker(second_blocker);
+            } else {
+                it->setSecondBlocker(lit_Undef);
+            }
+        }
     }
 }
 
@@ -270,19 +280,6 @@ uint64_t CNF::mem_used_longclauses() const
     return mem;
 }
 
-uint64_t CNF::print_mem_used_longclauses(const size_t totalMem) const
-{
-    uint64_t mem = mem_used_longclauses();
-    print_stats_line("c Mem for longclauses"
-        , mem/(1024UL*1024UL)
-        , "MB"
-        , stats_line_percent(mem, totalMem)
-        , "%"
-    );
-
-    return mem;
-}
-
 size_t CNF::cl_size(const Watched& ws) const
 {
     switch(ws.getType()) {
@@ -776,7 +773,21 @@ bool CNF::no_marked_clauses() const
 
 void CNF::add_frat(FILE* os) {
     if (frat) delete frat;
-    frat = new DratFile<false>(interToOuterMain);
+    int compress = conf.frat_compress;
+    #ifndef USE_ZLIB
+    if (compress > 0) {
+        verb_print(1, "[frat] not compiled with zlib, FRAT will not be compressed");
+        compress = 0;
+    }
+    #endif
+    #ifdef USE_TBUDDY
+    //tbuddy writes straight to the file
+    if (compress > 0) {
+        verb_print(1, "[frat] tbuddy is in use, FRAT will not be compressed");
+        compress = 0;
+    }
+    #endif
+    frat = new DratFile<false>(interToOuterMain, conf.frat_async, compress);
     frat->setFile(os);
     frat->set_sumconflicts_ptr(&sumConflicts);
     frat->set_sqlstats_ptr(sqlStats);
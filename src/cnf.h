@@ -105,6 +105,7 @@ public:
         if (_conf != NULL) {
             conf = *_conf;
         }
+        cl_alloc.set_backend(conf.clause_alloc_arena, conf.clause_alloc_hugepages);
         frat = new Drat;
         assert(_must_interrupt_inter != NULL);
         must_interrupt_inter = _must_interrupt_inter;
@@ -267,7 +268,6 @@ public:
     string watches_to_string(const Lit lit, watch_subarray_const ws) const;
     bool satisfied(const ClOffset& off) const;
 
-    uint64_t print_mem_used_longclauses(size_t totalMem) const;
     uint64_t mem_used_longclauses() const;
     template<class Function>
     void for_each_lit(
@@ -373,6 +373,9 @@ public:
     void free_bdds(vector<Xor>& xors);
     #endif
 
+    void save_snapshot_bva(SimpleOutFile& f) const;
+    void load_snapshot_bva(SimpleInFile& f);
+
 #ifdef ARJUN_SERIALIZE
     template<class T> void unserialize(T& ar);
     template<class T> void serialize(T& ar) const;
@@ -799,6 +802,27 @@ inline size_t CNF::get_num_long_cls() const
     return longIrredCls.size() + longRedCls.size();
 }
 
+inline void CNF::save_snapshot_bva(SimpleOutFile& f) const
+{
+    f.put_uint32_t(num_bva_vars);
+    f.put_vector(outer_to_with_bva_map);
+}
+
+inline void CNF::load_snapshot_bva(SimpleInFile& f)
+{
+    num_bva_vars = f.get_uint32_t();
+    outer_to_with_bva_map.clear();
+    f.get_vector(outer_to_with_bva_map);
+    if (num_bva_vars > nVarsOuter()
+        || outer_to_with_bva_map.size() != nVarsOuter() - num_bva_vars
+    ) {
+        f.corrupt();
+    }
+    for(const uint32_t v: outer_to_with_bva_map) {
+        f.check_var(v, nVarsOuter());
+    }
+}
+
 #ifdef ARJUN_SERIALIZE
 template<class T> void CNF::unserialize(T& ar)
 {
@@ -24,14 +24,19 @@ THE SOFTWARE.
 #include "cryptominisat.h"
 #include "solver.h"
 #include "frat.h"
+#include "datasync.h"
 #include "shareddata.h"
 
 #include <fstream>
 #include <cstdint>
 #include <thread>
 #include <mutex>
+#include <condition_variable>
+#include <deque>
 #include <atomic>
 #include <cassert>
+#include <map>
+#include <sstream>
 using std::thread;
 using std::vector;
 
@@ -67,6 +72,10 @@ namespace CMSat {
 
             delete log; //this will also close the file
             delete shared_data;
+            delete frat_writer;
+            for(FILE* f: frat_tmp) {
+                fclose(f);
+            }
         }
         CMSatPrivateData(const CMSatPrivateData&) = delete;
         CMSatPrivateData& operator=(const CMSatPrivateData&) = delete;
@@ -98,6 +107,18 @@ namespace CMSat {
         uint32_t num_solve_simplify_calls = 0;
         bool promised_single_call = false;
 
+        //Multi-threaded FRAT: every thread writes to its own temporary file,
+        //these are merged into 'frat_out' after each solve
+        FILE* frat_out = NULL;
+        int frat_compress = 0;
+        FratWriter* frat_writer = NULL;
+        vector<FILE*> frat_tmp;
+        vector<long> frat_tmp_at;
+
+        //Split search: the final conflict is collected from all refuted cubes
+        bool conflict_from_split = false;
+        vector<Lit> split_conflict;
+
         //stats
         uint64_t previous_sum_conflicts = 0;
         uint64_t previous_sum_propagations = 0;
@@ -415,6 +436,58 @@ void update_config(SolverConf& conf, unsigned thread_num)
     }
 }
 
+//Gives every thread its own FRAT stream in a temporary file. Clause IDs are
+//interleaved between the threads, so they are unique in the merged proof.
+static void setup_multi_thread_frat(CMSatPrivateData* data)
+{
+    assert(data->frat_out != NULL);
+    assert(data->frat_tmp.empty());
+    const uint32_t num = data->solvers.size();
+    for(uint32_t i = 0; i < num; i++) {
+        FILE* f = tmpfile();
+        if (f == NULL) {
+            std::cerr << "ERROR: Could not create temporary FRAT file for thread " << i << endl;
+            exit(-1);
+        }
+        data->frat_tmp.push_back(f);
+        data->frat_tmp_at.push_back(0);
+
+        //Only the merged proof is compressed
+        Solver& s = *data->solvers[i];
+        s.conf.frat_compress = 0;
+        s.conf.doBreakid = false;
+        s.add_frat(f);
+        s.frat->set_thread_num(i, num);
+        s.conf.do_hyperbin_and_transred = true;
+    }
+}
+
+static void merge_multi_thread_frat(CMSatPrivateData* data)
+{
+    if (data->frat_tmp.empty()) {
+        return;
+    }
+
+    const double my_time = cpuTime();
+    for(Solver* s: data->solvers) {
+        s->frat->flush();
+    }
+    if (data->frat_writer == NULL) {
+        data->frat_writer = new FratWriter(data->frat_out, 1024*1024, false, data->frat_compress);
+    }
+    vector<vector<FratImport>> imports;
+    for(Solver* s: data->solvers) {
+        imports.push_back(std::move(s->datasync->get_frat_imports()));
+        s->datasync->get_frat_imports().clear();
+    }
+    merge_frat_streams(data->frat_tmp, data->frat_tmp_at, imports, *data->frat_writer);
+    if (data->solvers[0]->conf.verbosity) {
+        cout << "c [frat] merged the proofs of " << data->solvers.size()
+        << " threads T: " << std::setprecision(2) << std::fixed
+        << (cpuTime() - my_time) << endl;
+    }
+}
+
 DLL_PUBLIC void SATSolver::set_num_threads(unsigned num)
 {
     if (num <= 0) {
@@ -431,10 +504,18 @@ DLL_PUBLIC void SATSolver::set_num_threads(unsigned num)
         throw std::runtime_error(err);
     }
 
+    #ifdef USE_TBUDDY
     if (data->solvers[0]->frat->enabled() ||
         data->solvers[0]->conf.simulate_frat
     ) {
-        const char err[] = "ERROR: FRAT cannot be used in multi-threaded mode";
+        const char err[] = "ERROR: FRAT with TBUDDY cannot be used in multi-threaded mode";
+        std::cerr << err << endl;
+        throw std::runtime_error(err);
+    }
+    #endif
+
+    if (data->solvers[0]->frat->enabled() && data->solvers[0]->frat->getFile() == NULL) {
+        const char err[] = "ERROR: FRAT in multi-threaded mode needs a file to merge the proofs into";
         std::cerr << err << endl;
         throw std::runtime_error(err);
     }
@@ -456,6 +537,7 @@ DLL_PUBLIC void SATSolver::set_num_threads(unsigned num)
     for(unsigned i = 1; i < num; i++) {
         SolverConf conf = data->solvers[0]->getConf();
         update_config(conf, i);
+        conf.checkpoint_fname.clear(); //only the first thread writes checkpoints
         data->solvers.push_back(new Solver(&conf, data->must_interrupt));
         data->cpu_times.push_back(0.0);
     }
@@ -474,6 +556,12 @@ DLL_PUBLIC void SATSolver::set_num_threads(unsigned num)
         data->solvers[i]->setConf(conf);
         data->solvers[i]->set_shared_data((SharedData*)data->shared_data);
     }
+
+    if (data->solvers[0]->frat->enabled()) {
+        data->frat_out = data->solvers[0]->frat->getFile();
+        data->frat_compress = data->solvers[0]->conf.frat_compress;
+        setup_multi_thread_frat(data);
+    }
 }
 
 struct OneThreadAddCls
@@ -763,6 +851,111 @@ DLL_PUBLIC bool SATSolver::add_clause(const vector< Lit >& lits)
     return ret;
 }
 
+//Add clauses from a flat, lit_Undef-terminated buffer to a single solver
+static bool add_flat_clauses(
+    Solver& solver, const Lit* lits, const size_t num_lits, unsigned& num_cls)
+{
+    bool ret = true;
+    size_t start = 0;
+    for(size_t at = 0; at <= num_lits && ret; at++) {
+        if (at == num_lits) {
+            //Last terminator is optional
+            if (start == num_lits) break;
+        } else if (lits[at] != lit_Undef) {
+            continue;
+        }
+
+        ret = solver.add_clause_outside(lits + start, at - start);
+        num_cls++;
+        start = at+1;
+    }
+
+    return ret;
+}
+
+DLL_PUBLIC bool SATSolver::add_clauses(const Lit* lits, size_t num_lits)
+{
+    //Nothing is added if any of the variables is out of range
+    const uint32_t num_vars = nVars();
+    for(size_t i = 0; i < num_lits; i++) {
+        if (lits[i] != lit_Undef && lits[i].var() >= num_vars) {
+            std::stringstream ss;
+            ss << "ERROR: Variable " << lits[i].var() + 1
+            << " inserted, but max var is " << num_vars;
+            std::cerr << ss.str() << endl;
+            throw std::runtime_error(ss.str());
+        }
+    }
+
+    if (data->log) {
+        for(size_t i = 0; i < num_lits; i++) {
+            if (lits[i] == lit_Undef) {
+                (*data->log) << "0" << endl;
+            } else {
+                (*data->log) << lits[i] << " ";
+            }
+        }
+        if (num_lits > 0 && lits[num_lits-1] != lit_Undef) {
+            (*data->log) << "0" << endl;
+        }
+    }
+
+    if (data->solvers.size() == 1) {
+        data->solvers[0]->new_vars(data->vars_to_add);
+        data->vars_to_add = 0;
+
+        return add_flat_clauses(*data->solvers[0], lits, num_lits, data->cls);
+    }
+
+    //Small batches go through the cache, like add_clause(), so no threads
+    //are started for them
+    bool ret = true;
+    if (num_lits < CACHE_SIZE) {
+        if (data->cls_lits.size() + num_lits + 1 > CACHE_SIZE) {
+            ret = actually_add_clauses_to_threads(data);
+        }
+
+        size_t start = 0;
+        for(size_t at = 0; at <= num_lits; at++) {
+            if (at == num_lits) {
+                if (start == num_lits) break;
+            } else if (lits[at] != lit_Undef) {
+                continue;
+            }
+
+            data->cls_lits.push_back(lit_Undef);
+            data->cls_lits.insert(data->cls_lits.end(), lits + start, lits + at);
+            start = at+1;
+        }
+        return ret;
+    }
+
+    //Flush cached clauses and variables first, so the order is kept
+    ret = actually_add_clauses_to_threads(data);
+    if (!ret) {
+        return false;
+    }
+
+    //Every thread reads the same buffer, no copies are made
+    vector<char> rets(data->solvers.size(), true);
+    vector<unsigned> num_cls(data->solvers.size(), 0);
+    vector<thread> thds;
+    for(size_t i = 0; i < data->solvers.size(); i++) {
+        thds.push_back(thread([&, i]() {
+            rets[i] = add_flat_clauses(*data->solvers[i], lits, num_lits, num_cls[i]);
+        }));
+    }
+    for(std::thread& t: thds){
+        t.join();
+    }
+    data->cls += num_cls[0];
+
+    for(const char r: rets) {
+        ret &= (bool)r;
+    }
+    return ret;
+}
+
 void add_xor_clause_to_log(const std::vector<unsigned>& vars, bool rhs, std::ofstream* file)
 {
     if (vars.size() == 0) {
@@ -910,6 +1103,368 @@ struct OneThreadCalc
     bool only_sampling_solution;
 };
 
+///////////////////////////
+// Split (cube-and-conquer) search
+///////////////////////////
+
+struct Cube
+{
+    vector<Lit> lits;
+    uint64_t confl_budget;
+};
+
+// Work-stealing queue of cubes. Every thread has its own deque: it pushes and
+// pops at the back (depth-first on its own subtree, good for the learnt
+// clauses it has), and when it runs dry it steals from the front of the
+// others' deques, i.e. the largest open subtrees. Cubes take thousands of
+// conflicts each, so one lock for all deques is not a bottleneck.
+class CubeQueue
+{
+public:
+    explicit CubeQueue(size_t num_threads) : deques(num_threads) {}
+
+    void push(size_t tid, Cube&& cube)
+    {
+        std::lock_guard<std::mutex> lock(mu);
+        deques[tid].push_back(std::move(cube));
+        open++;
+        cond.notify_one();
+    }
+
+    //Blocks until there is a cube to work on. Returns false when all cubes
+    //have been refuted or stop() was called
+    bool pop(size_t tid, Cube& cube)
+    {
+        std::unique_lock<std::mutex> lock(mu);
+        while(true) {
+            if (stopped || open == 0) return false;
+            if (!deques[tid].empty()) {
+                cube = std::move(deques[tid].back());
+                deques[tid].pop_back();
+                return true;
+            }
+            for(size_t i = 1; i < deques.size(); i++) {
+                auto& victim = deques[(tid+i) % deques.size()];
+                if (!victim.empty()) {
+                    cube = std::move(victim.front());
+                    victim.pop_front();
+                    steals++;
+                    return true;
+                }
+            }
+            cond.wait(lock);
+        }
+    }
+
+    //The cube popped has been refuted, or replaced by the cubes it was
+    //split into
+    void finished()
+    {
+        std::lock_guard<std::mutex> lock(mu);
+        assert(open > 0);
+        open--;
+        if (open == 0) cond.notify_all();
+    }
+
+    void stop()
+    {
+        std::lock_guard<std::mutex> lock(mu);
+        stopped = true;
+        cond.notify_all();
+    }
+
+    //Every cube has been refuted, nothing was stopped by a result, an
+    //interrupt or a limit
+    bool all_refuted()
+    {
+        std::lock_guard<std::mutex> lock(mu);
+        return !stopped && open == 0;
+    }
+
+    uint64_t steals = 0;
+
+private:
+    std::mutex mu;
+    std::condition_variable cond;
+    vector<std::deque<Cube>> deques;
+    uint64_t open = 0; //in the queues or being worked on
+    bool stopped = false;
+};
+
+struct SplitData
+{
+    explicit SplitData(size_t num_threads) : queue(num_threads) {}
+
+    CubeQueue queue;
+    vector<double> max_time;
+    vector<uint64_t> max_confl;
+
+    //Protected by DataForThread::update_mutex
+    vector<Lit> conflict;
+    uint64_t cubes_refuted = 0;
+    uint64_t cubes_split = 0;
+    size_t max_cube_size = 0;
+};
+
+struct OneThreadSplit
+{
+    OneThreadSplit(
+        DataForThread& _data_for_thread,
+        SplitData& _split,
+        size_t _tid,
+        bool _only_sampling_solution
+    ) :
+        data_for_thread(_data_for_thread)
+        , split(_split)
+        , tid(_tid)
+        , only_sampling_solution(_only_sampling_solution)
+    {
+    }
+
+    void operator()()
+    {
+        Solver& solver = *data_for_thread.solvers[tid];
+        const size_t num_user_assumps =
+            data_for_thread.assumptions ? data_for_thread.assumptions->size() : 0;
+        vector<Lit> assumps;
+        Cube cube;
+        while(split.queue.pop(tid, cube)) {
+            assumps.clear();
+            if (data_for_thread.assumptions) assumps = *data_for_thread.assumptions;
+            assumps.insert(assumps.end(), cube.lits.begin(), cube.lits.end());
+
+            //Limits are reset at the end of every solve() call
+            const uint64_t confl_before = solver.get_stats().conflicts;
+            solver.conf.maxTime = split.max_time[tid];
+            solver.conf.max_confl = std::min<uint64_t>(
+                split.max_confl[tid], confl_before + cube.confl_budget);
+            const lbool ret = solver.solve_with_assumptions(&assumps, only_sampling_solution);
+
+            if (ret == l_True) {
+                found(ret);
+                break;
+            }
+
+            if (ret == l_False) {
+                //Either the cube (and maybe some assumptions) is refuted,
+                //or the assumptions alone are
+                bool cube_involved = false;
+                vector<Lit> user_part;
+                for(const Lit l: solver.get_final_conflict()) {
+                    if (std::find(cube.lits.begin(), cube.lits.end(), ~l) != cube.lits.end()) {
+                        cube_involved = true;
+                    } else {
+                        user_part.push_back(l);
+                    }
+                }
+                if (!cube_involved) {
+                    std::lock_guard<std::mutex> lock(*data_for_thread.update_mutex);
+                    split.conflict = user_part;
+                    found_locked(ret);
+                    break;
+                }
+                add_refuted(user_part);
+                split.queue.finished();
+                continue;
+            }
+
+            //Interrupted, or out of time/conflicts globally
+            assert(ret == l_Undef);
+            if (data_for_thread.solvers[0]->must_interrupt_asap()
+                || solver.get_stats().conflicts >= split.max_confl[tid]
+                || cpuTime() >= split.max_time[tid]
+            ) {
+                solver.set_must_interrupt_asap();
+                split.queue.stop();
+                break;
+            }
+
+            //Out of budget for this cube, split it further
+            Lit lit;
+            assumps.resize(num_user_assumps);
+            assumps.insert(assumps.end(), cube.lits.begin(), cube.lits.end());
+            if (solver.lookahead_split_lit(assumps, solver.conf.split_lookahead_cands, lit) == l_False) {
+                //Only propagation was involved, can't tell which assumptions
+                //were needed, be conservative
+                if (data_for_thread.assumptions) add_refuted(negated_user_assumps());
+                split.queue.finished();
+                continue;
+            }
+
+            const uint64_t budget = cube.confl_budget * solver.conf.split_cube_confl_mult;
+            if (lit == lit_Undef) {
+                cube.confl_budget = budget;
+                split.queue.push(tid, std::move(cube));
+            } else {
+                Cube c2;
+                c2.lits = cube.lits;
+                c2.lits.push_back(~lit);
+                c2.confl_budget = budget;
+                cube.lits.push_back(lit);
+                cube.confl_budget = budget;
+                {
+                    std::lock_guard<std::mutex> lock(*data_for_thread.update_mutex);
+                    split.cubes_split++;
+                    split.max_cube_size = std::max(split.max_cube_size, cube.lits.size());
+                }
+                split.queue.push(tid, std::move(c2));
+                split.queue.push(tid, std::move(cube));
+            }
+            split.queue.finished();
+        }
+        data_for_thread.cpu_times[tid] = cpuTime();
+    }
+
+    vector<Lit> negated_user_assumps() const
+    {
+        vector<Lit> ret;
+        for(const Lit l: *data_for_thread.assumptions) ret.push_back(~l);
+        return ret;
+    }
+
+    void add_refuted(const vector<Lit>& user_part)
+    {
+        std::lock_guard<std::mutex> lock(*data_for_thread.update_mutex);
+        split.cubes_refuted++;
+        for(const Lit l: user_part) {
+            if (std::find(split.conflict.begin(), split.conflict.end(), l) == split.conflict.end()) {
+                split.conflict.push_back(l);
+            }
+        }
+    }
+
+    void found(const lbool ret)
+    {
+        std::lock_guard<std::mutex> lock(*data_for_thread.update_mutex);
+        found_locked(ret);
+    }
+
+    void found_locked(const lbool ret)
+    {
+        if (*data_for_thread.ret != l_Undef) return;
+        *data_for_thread.which_solved = tid;
+        *data_for_thread.ret = ret;
+        //will interrupt all of them
+        data_for_thread.solvers[0]->set_must_interrupt_asap();
+        split.queue.stop();
+    }
+
+    DataForThread& data_for_thread;
+    SplitData& split;
+    const size_t tid;
+    bool only_sampling_solution;
+};
+
+static lbool calc_split(
+    const vector< Lit >* assumptions,
+    CMSatPrivateData *data,
+    bool only_sampling_solution
+) {
+    const double my_time = cpuTime();
+    const SolverConf& conf = data->solvers[0]->conf;
+    if (!actually_add_clauses_to_threads(data)) {
+        data->okay = false;
+        return l_False;
+    }
+
+    SplitData split(data->solvers.size());
+    for(Solver* s: data->solvers) {
+        split.max_time.push_back(s->conf.maxTime);
+        split.max_confl.push_back(s->conf.max_confl);
+        s->set_interrupt_at_end(false);
+    }
+
+    //Initial cubes, breadth-first lookahead on the first solver
+    vector<Lit> prefix;
+    if (assumptions) prefix = *assumptions;
+    vector<vector<Lit>> cubes(1);
+    vector<vector<Lit>> next;
+    const size_t want = data->solvers.size()*std::max<uint32_t>(1, conf.split_cubes_per_thread);
+    bool refuted_by_lookahead = false;
+    while(cubes.size() < want && !cubes.empty()) {
+        next.clear();
+        bool progress = false;
+        for(auto& c: cubes) {
+            vector<Lit> tmp = prefix;
+            tmp.insert(tmp.end(), c.begin(), c.end());
+            Lit lit;
+            if (data->solvers[0]->lookahead_split_lit(tmp, conf.split_lookahead_cands, lit) == l_False) {
+                refuted_by_lookahead = true;
+                continue;
+            }
+            if (lit == lit_Undef) {
+                next.push_back(c);
+                continue;
+            }
+            progress = true;
+            next.push_back(c);
+            next.back().push_back(lit);
+            next.push_back(c);
+            next.back().push_back(~lit);
+        }
+        std::swap(cubes, next);
+        if (!progress) break;
+    }
+    if (refuted_by_lookahead && assumptions) {
+        for(const Lit l: *assumptions) split.conflict.push_back(~l);
+    }
+    if (conf.verbosity) {
+        cout << "c [split] initial cubes: " << cubes.size()
+        << " depth: " << (cubes.empty() ? 0 : cubes[0].size())
+        << " threads: " << data->solvers.size()
+        << " T: " << std::fixed << std::setprecision(2) << (cpuTime() - my_time)
+        << endl;
+    }
+
+    DataForThread data_for_thread(data, assumptions);
+    for(size_t i = 0; i < cubes.size(); i++) {
+        Cube c;
+        c.lits = cubes[i];
+        c.confl_budget = conf.split_cube_confl;
+        split.queue.push(i % data->solvers.size(), std::move(c));
+    }
+
+    if (!cubes.empty()) {
+        vector<thread> thds;
+        for(size_t i = 0; i < data->solvers.size(); i++) {
+            thds.push_back(thread(OneThreadSplit(
+                data_for_thread, split, i, only_sampling_solution)));
+        }
+        for(std::thread& t: thds){
+            t.join();
+        }
+    }
+    data_for_thread.solvers[0]->unset_must_interrupt_asap();
+    for(Solver* s: data->solvers) {
+        s->set_interrupt_at_end(true);
+        s->conf.max_confl = numeric_limits<uint64_t>::max();
+        s->conf.maxTime = numeric_limits<double>::max();
+    }
+
+    lbool ret = *data_for_thread.ret;
+    if (ret == l_Undef && split.queue.all_refuted()) ret = l_False;
+    if (ret == l_False) {
+        data->conflict_from_split = true;
+        data->split_conflict = split.conflict;
+        if (split.conflict.empty()) {
+            //UNSAT without any assumptions, make it stick
+            for(Solver* s: data->solvers) s->add_clause_outside(vector<Lit>());
+        }
+    }
+
+    if (conf.verbosity) {
+        cout << "c [split] result: " << ret
+        << " cubes refuted: " << split.cubes_refuted
+        << " split further: " << split.cubes_split
+        << " max cube size: " << split.max_cube_size
+        << " steals: " << split.queue.steals
+        << endl;
+    }
+
+    data->okay = data->solvers[*data_for_thread.which_solved]->okay();
+    return ret;
+}
+
 lbool calc(
     const vector< Lit >* assumptions,
     Todo todo,
@@ -927,6 +1482,7 @@ lbool calc(
 
     //Reset the interrupt signal if it was set
     data->must_interrupt->store(false, std::memory_order_relaxed);
+    data->conflict_from_split = false;
 
     //Set timeout information
     if (data->timeout != numeric_limits<double>::max()) {
@@ -968,6 +1524,16 @@ lbool calc(
         return ret;
     }
 
+    #ifndef USE_GPU
+    //Cube refutations are not logged in the FRAT, so no split with FRAT
+    if (todo == Todo::todo_solve
+        && data->solvers[0]->conf.split_search
+        && data->frat_tmp.empty()
+    ) {
+        return calc_split(assumptions, data, only_sampling_solution);
+    }
+    #endif
+
     //Multi-threaded case
     DataForThread data_for_thread(data, assumptions);
     vector<thread> thds;
@@ -1000,6 +1566,7 @@ lbool calc(
     data->cls_lits.clear();
     data->vars_to_add = 0;
     data->okay = data->solvers[*data_for_thread.which_solved]->okay();
+    merge_multi_thread_frat(data);
     return real_ret;
 }
 
@@ -1052,6 +1619,7 @@ DLL_PUBLIC const vector< lbool >& SATSolver::get_model() const
 
 DLL_PUBLIC const std::vector<Lit>& SATSolver::get_conflict() const
 {
+    if (data->conflict_from_split) return data->split_conflict;
 
     return data->solvers[data->which_solved]->get_final_conflict();
 }
@@ -1169,15 +1737,29 @@ DLL_PUBLIC void SATSolver::set_find_xors(bool do_find_xors)
 
 DLL_PUBLIC void SATSolver::set_frat(FILE* os)
 {
+    #ifdef USE_TBUDDY
     if (data->solvers.size() > 1) {
-        std::cerr << "ERROR: FRAT cannot be used in multi-threaded mode" << endl;
+        std::cerr << "ERROR: FRAT with TBUDDY cannot be used in multi-threaded mode" << endl;
         exit(-1);
     }
+    #endif
     if (nVars() > 0) {
         std::cerr << "ERROR: FRAT cannot be set after variables have been added" << endl;
         exit(-1);
     }
 
+    if (data->solvers.size() > 1) {
+        if (os == NULL) {
+            const char err[] = "ERROR: FRAT in multi-threaded mode needs a file to merge the proofs into";
+            std::cerr << err << endl;
+            throw std::runtime_error(err);
+        }
+        data->frat_out = os;
+        data->frat_compress = data->solvers[0]->conf.frat_compress;
+        setup_multi_thread_frat(data);
+        return;
+    }
+
     data->solvers[0]->conf.doBreakid = false;
     data->solvers[0]->add_frat(os);
     data->solvers[0]->conf.do_hyperbin_and_transred = true;
@@ -1624,6 +2206,38 @@ DLL_PUBLIC void SATSolver::set_sls(int val)
     }
 }
 
+DLL_PUBLIC void SATSolver::set_sls_async(int val)
+{
+    for (size_t i = 0; i < data->solvers.size(); ++i) {
+        Solver& s = *data->solvers[i];
+        s.conf.sls_async = val;
+    }
+}
+
+DLL_PUBLIC void SATSolver::set_sls_walkers(unsigned n)
+{
+    for (size_t i = 0; i < data->solvers.size(); ++i) {
+        Solver& s = *data->solvers[i];
+        s.conf.sls_walkers = n;
+    }
+}
+
+DLL_PUBLIC void SATSolver::set_gauss_init_threads(unsigned n)
+{
+    for (size_t i = 0; i < data->solvers.size(); ++i) {
+        Solver& s = *data->solvers[i];
+        s.conf.gaussconf.init_threads = n;
+    }
+}
+
+DLL_PUBLIC void SATSolver::set_split_search(int val)
+{
+    for (size_t i = 0; i < data->solvers.size(); ++i) {
+        Solver& s = *data->solvers[i];
+        s.conf.split_search = val;
+    }
+}
+
 DLL_PUBLIC void SATSolver::reset_vsids()
 {
     for (size_t i = 0; i < data->solvers.size(); ++i) {
@@ -1892,6 +2506,112 @@ DLL_PUBLIC void SATSolver::set_seed(const uint32_t seed)
     }
 }
 
+DLL_PUBLIC void SATSolver::save_snapshot(const std::string& fname)
+{
+    actually_add_clauses_to_threads(data);
+    data->solvers[data->which_solved]->save_snapshot(fname);
+}
+
+DLL_PUBLIC void SATSolver::load_snapshot(const std::string& fname)
+{
+    if (nVars() != 0 || data->num_solve_simplify_calls > 0) {
+        cout << "ERROR: snapshots can only be loaded into a fresh solver" << endl;
+        exit(-1);
+    }
+
+    //Only the first thread continues the saved search, the others keep
+    //their own, different, configurations
+    for(size_t i = 0; i < data->solvers.size(); i++) {
+        data->solvers[i]->load_snapshot(fname, i == 0);
+    }
+    data->total_num_vars = data->solvers[0]->nVarsOutside();
+    data->okay = data->solvers[0]->okay();
+}
+
+DLL_PUBLIC void SATSolver::checkpoint(const std::string& fname)
+{
+    actually_add_clauses_to_threads(data);
+    Solver& s = *data->solvers[data->which_solved];
+    s.checkpoint(fname);
+    //Only the periodic checkpoints during solve() are written in the background
+    s.wait_for_checkpoint_write();
+}
+
+DLL_PUBLIC void SATSolver::restore(const std::string& fname)
+{
+    load_snapshot(fname);
+}
+
+DLL_PUBLIC void SATSolver::set_checkpoint(const std::string& fname, double every_secs)
+{
+    data->solvers[0]->conf.checkpoint_fname = fname;
+    data->solvers[0]->conf.checkpoint_every_secs = every_secs;
+}
+
+DLL_PUBLIC Instrumentation SATSolver::get_instrumentation() const
+{
+    Instrumentation ret;
+    std::map<string, PhaseStat> phases;
+    for(const Solver* s: data->solvers) {
+        for(const auto& it: s->get_phase_stats()) {
+            PhaseStat& p = phases[it.first];
+            p.calls += it.second.calls;
+            p.cpu_time += it.second.cpu_time;
+            p.free_vars_removed += it.second.free_vars_removed;
+            p.irred_lits_removed += it.second.irred_lits_removed;
+            p.red_lits_removed += it.second.red_lits_removed;
+            p.conflicts += it.second.conflicts;
+        }
+
+        vector<MemStat> mems;
+        s->get_mem_stats(mems);
+        for(const auto& m: mems) {
+            auto it = std::find_if(ret.mem.begin(), ret.mem.end(),
+                [&](const MemStat& other) { return other.name == m.name; });
+            if (it == ret.mem.end()) ret.mem.push_back(m);
+            else it->bytes += m.bytes;
+        }
+    }
+    for(auto& it: phases) {
+        it.second.name = it.first;
+        ret.phases.push_back(it.second);
+    }
+
+    double vm_mem_used = 0;
+    ret.rss_bytes = memUsedTotal(vm_mem_used);
+    ret.cpu_time = cpuTimeTotal();
+    return ret;
+}
+
+DLL_PUBLIC std::string SATSolver::get_instrumentation_json() const
+{
+    const Instrumentation ins = get_instrumentation();
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(6);
+    ss << "{\"cpu_time\": " << ins.cpu_time
+    << ", \"rss_bytes\": " << ins.rss_bytes
+    << ", \"phases\": [";
+    for(size_t i = 0; i < ins.phases.size(); i++) {
+        const PhaseStat& p = ins.phases[i];
+        if (i > 0) ss << ", ";
+        ss << "{\"name\": \"" << json_escape(p.name) << "\""
+        << ", \"calls\": " << p.calls
+        << ", \"cpu_time\": " << p.cpu_time
+        << ", \"free_vars_removed\": " << p.free_vars_removed
+        << ", \"irred_lits_removed\": " << p.irred_lits_removed
+        << ", \"red_lits_removed\": " << p.red_lits_removed
+        << ", \"conflicts\": " << p.conflicts << "}";
+    }
+    ss << "], \"mem\": [";
+    for(size_t i = 0; i < ins.mem.size(); i++) {
+        if (i > 0) ss << ", ";
+        ss << "{\"name\": \"" << json_escape(ins.mem[i].name) << "\""
+        << ", \"bytes\": " << ins.mem[i].bytes << "}";
+    }
+    ss << "]}";
+    return ss.str();
+}
+
 #ifdef ARJUN_SERIALIZE
 DLL_PUBLIC std::string SATSolver::serialize_solution_reconstruction_data() const
 {
@@ -59,6 +59,11 @@ namespace CMSat {
         void new_vars(const size_t n); //and many new variables to the solver -- much faster
         unsigned nVars() const; //get number of variables inside the solver
         bool add_clause(const std::vector<Lit>& lits);
+        //add many clauses at once from a flat buffer: each clause is terminated
+        //by lit_Undef (the very last terminator may be omitted). No per-clause
+        //copy is made, and with multiple threads each thread reads the same buffer.
+        //Throws std::runtime_error if a variable has not been created yet
+        bool add_clauses(const Lit* lits, size_t num_lits);
         bool add_red_clause(const std::vector<Lit>& lits);
         bool add_xor_clause(const std::vector<unsigned>& vars, bool rhs);
         bool add_bnn_clause(
@@ -140,6 +145,10 @@ namespace CMSat {
         void set_single_run(); //we promise to call solve() EXACTLY once
         void set_intree_probe(int val);
         void set_sls(int val);
+        void set_sls_async(int val); //run SLS on a helper thread, in parallel with CDCL
+        void set_sls_walkers(unsigned n); //run n CCNR walkers in parallel, sharing their best assignment
+        void set_gauss_init_threads(unsigned n); //(re-)initialize independent Gauss-Jordan matrices on n threads
+        void set_split_search(int val); //with multiple threads, split the search space into cubes instead of running a portfolio
         void set_full_bve(int val);
         void set_full_bve_iter_ratio(double val);
         void set_scc(int val);
@@ -262,6 +271,28 @@ namespace CMSat {
         static std::pair<lbool, std::vector<lbool>> extend_solution(void* s, const std::vector<lbool>& simp_sol);
         static void delete_extend_solution_setup(void* s);
 
+        // Binary snapshot of the (simplified) problem, to preprocess once and
+        // solve many times. Save after simplify() or solve(). Load into a
+        // fresh solver only, after set_num_threads() but before anything else
+        void save_snapshot(const std::string& fname);
+        void load_snapshot(const std::string& fname);
+
+        // Checkpoint = snapshot + search state (learnt clauses, activities,
+        // phases, restart and inprocessing schedules), for preemptible jobs.
+        // The file is written in the background, write-then-rename. Restore
+        // like load_snapshot(), then call solve() to continue the search.
+        // set_checkpoint() writes one every every_secs during solve()
+        void checkpoint(const std::string& fname);
+        void restore(const std::string& fname);
+        void set_checkpoint(const std::string& fname, double every_secs = 600);
+
+        // Time, call counts and effect of each simplification/inprocessing
+        // step, plus the current memory use by component, summed over the
+        // threads. Steps nest: "occ" contains the occ-* steps and "search"
+        // the steps run from within search. Call between solve() calls
+        Instrumentation get_instrumentation() const;
+        std::string get_instrumentation_json() const;
+
         /////////////////////
         // Backwards compatibility, implemented using the above "small clauses" functions
         void open_file_and_dump_irred_clauses(const char* fname);
@@ -33,6 +33,7 @@ static_assert(sizeof(Lit) == sizeof(c_Lit), "Lit layout not c-compatible");
 static_assert(alignof(Lit) == alignof(c_Lit), "Lit layout not c-compatible");
 static_assert(sizeof(lbool) == sizeof(c_lbool), "lbool layout not c-compatible");
 static_assert(alignof(lbool) == alignof(c_lbool), "lbool layout not c-compatible");
+static_assert(CMSAT_LIT_UNDEF == (var_Undef << 1), "CMSAT_LIT_UNDEF must match lit_Undef");
 
 const Lit* fromc(const c_Lit* x)
 {
@@ -92,6 +93,20 @@ extern "C"
         return self->add_clause(wrap(fromc(lits), num_lits));
     } NOEXCEPT_END
 
+    DLL_PUBLIC bool cmsat_add_clauses(SATSolver* self, const c_Lit* lits, size_t num_lits) NOEXCEPT_START {
+        //Checked here, SATSolver::add_clauses() would throw
+        const Lit* cls = fromc(lits);
+        const uint32_t num_vars = self->nVars();
+        for(size_t i = 0; i < num_lits; i++) {
+            if (cls[i] != lit_Undef && cls[i].var() >= num_vars) {
+                std::cerr << "ERROR: Variable " << cls[i].var() + 1
+                << " inserted, but max var is " << num_vars << std::endl;
+                return false;
+            }
+        }
+        return self->add_clauses(cls, num_lits);
+    } NOEXCEPT_END
+
     DLL_PUBLIC bool cmsat_add_xor_clause(SATSolver* self, const unsigned* vars, size_t num_vars, bool rhs) NOEXCEPT_START {
         return self->add_xor_clause(wrap(vars, num_vars), rhs);
     } NOEXCEPT_END
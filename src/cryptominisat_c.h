@@ -29,6 +29,9 @@ typedef struct c_lbool { uint8_t x; } c_lbool;
 typedef struct slice_Lit { const c_Lit* vals; size_t num_vals; } slice_Lit;
 typedef struct slice_lbool { const c_lbool* vals; size_t num_vals; } slice_lbool;
 
+// Clause terminator for cmsat_add_clauses(), same as CMSat::lit_Undef
+#define CMSAT_LIT_UNDEF (0x1ffffffeu)
+
 #ifdef __cplusplus
     #define NOEXCEPT noexcept
 
@@ -60,6 +63,9 @@ CMS_DLL_PUBLIC void cmsat_free(SATSolver* s) NOEXCEPT;
 
 CMS_DLL_PUBLIC unsigned cmsat_nvars(const SATSolver* self) NOEXCEPT;
 CMS_DLL_PUBLIC bool cmsat_add_clause(SATSolver* self, const c_Lit* lits, size_t num_lits) NOEXCEPT;
+// Flat buffer of clauses, each terminated by a c_Lit with x == CMSAT_LIT_UNDEF
+// Returns false, and adds nothing, if a variable is out of range
+CMS_DLL_PUBLIC bool cmsat_add_clauses(SATSolver* self, const c_Lit* lits, size_t num_lits) NOEXCEPT;
 CMS_DLL_PUBLIC bool cmsat_add_xor_clause(SATSolver* self, const unsigned* vars, size_t num_vars, bool rhs) NOEXCEPT;
 CMS_DLL_PUBLIC void cmsat_new_vars(SATSolver* self, const size_t n) NOEXCEPT;
 
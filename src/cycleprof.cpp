@@ -0,0 +1,129 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#include "cycleprof.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+
+using std::string;
+using std::cout;
+using std::endl;
+
+namespace CMSat {
+
+static const char* prof_names[prof_num] = {
+    "root",
+    "simplify",
+    "search",
+    "propagate",
+    "gauss",
+    "conflict",
+    "analyze",
+    "minimize",
+    "backtrack",
+    "learnt",
+    "decide",
+    "reduce-db",
+    "clean",
+    "restart",
+    "sync"
+};
+
+namespace {
+
+// Self cycles per folded stack, summed over all threads that have finished.
+// Written out when the library is unloaded.
+class CycleProfSummary {
+public:
+    ~CycleProfSummary() { dump(); }
+
+    void add(const string& stack, const uint64_t cycles) {
+        std::lock_guard<std::mutex> lock(mu);
+        stacks[stack] += cycles;
+    }
+
+private:
+    void dump() {
+        if (stacks.empty()) return;
+
+        const char* env = std::getenv("CMS_CYCLEPROF_FILE");
+        const string fname = env ? env : "cycleprof.folded";
+        std::ofstream f(fname);
+        if (!f) {
+            cout << "c WARNING: could not write cycle profile to " << fname << endl;
+            return;
+        }
+        uint64_t total = 0;
+        for(const auto& s: stacks) {
+            f << s.first << " " << s.second << "\n";
+            total += s.second;
+        }
+        cout << "c [cycleprof] " << stacks.size() << " stacks, "
+        << total << " cycles written to " << fname << endl;
+    }
+
+    std::mutex mu;
+    std::map<string, uint64_t> stacks;
+};
+
+CycleProfSummary& summary()
+{
+    static CycleProfSummary s;
+    return s;
+}
+
+}
+
+thread_local CycleProfThread cycleprof_thread;
+
+CycleProfThread::CycleProfThread()
+{
+    //Make sure the summary outlives the main thread's tree
+    summary();
+    nodes.push_back(CycleProfNode(prof_root, 0));
+}
+
+CycleProfThread::~CycleProfThread()
+{
+    std::vector<string> stack(nodes.size());
+    for(uint32_t i = 1; i < nodes.size(); i++) {
+        //Children are always created after their parent
+        const CycleProfNode& n = nodes[i];
+        stack[i] = n.parent == 0 ? string(prof_names[n.id])
+            : stack[n.parent] + ";" + prof_names[n.id];
+
+        uint64_t self = n.cycles;
+        for(const uint32_t c: n.child) {
+            if (c != 0) self -= std::min(self, nodes[c].cycles);
+        }
+        summary().add(stack[i], self);
+    }
+}
+
+}
@@ -0,0 +1,145 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#pragma once
+
+// Scoped cycle-counter timers for the hot parts of the search loop. Only
+// compiled in with -DCYCLE_PROF (cmake -DCYCLEPROF=ON); otherwise
+// CYCLE_PROF_SCOPE() expands to nothing and costs nothing.
+//
+// Every thread keeps its own calling-context tree, indexed by the enum below,
+// so entering a scope is an array lookup and two counter reads. At exit the
+// trees of all threads are merged and written in the folded-stack format
+// of flamegraph.pl ("search;conflict;minimize 123456"), where the count is
+// the self time in cycles. The file is "cycleprof.folded", or whatever the
+// CMS_CYCLEPROF_FILE environment variable says.
+
+#ifdef CYCLE_PROF
+
+#include <cstdint>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+
+namespace CMSat {
+
+enum ProfId : uint32_t {
+    prof_root = 0,
+    prof_simplify,
+    prof_search,
+    prof_propagate, //its self time is the watchlist walk
+    prof_gauss,
+    prof_conflict,
+    prof_analyze,
+    prof_minimize,
+    prof_backtrack,
+    prof_learnt,
+    prof_decide,
+    prof_reduce_db,
+    prof_clean,
+    prof_restart,
+    prof_sync,
+    prof_num
+};
+
+inline uint64_t cycleprof_now()
+{
+    #if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+    #else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    #endif
+}
+
+struct CycleProfNode {
+    CycleProfNode(uint32_t _id, uint32_t _parent) :
+        id(_id), parent(_parent)
+    {
+        for(auto& c: child) c = 0;
+    }
+    uint32_t id;
+    uint32_t parent;
+    uint64_t cycles = 0;
+    uint32_t child[prof_num]; //0 means not yet entered, node 0 is the root
+};
+
+class CycleProfThread {
+public:
+    CycleProfThread();
+    ~CycleProfThread(); //merges into the process-wide summary
+
+    uint32_t enter(const ProfId id) {
+        const uint32_t prev = cur;
+        uint32_t next = nodes[cur].child[id];
+        if (next == 0) {
+            next = nodes.size();
+            nodes.push_back(CycleProfNode(id, cur));
+            nodes[cur].child[id] = next;
+        }
+        cur = next;
+        return prev;
+    }
+
+    void leave(const uint32_t prev, const uint64_t cycles) {
+        nodes[cur].cycles += cycles;
+        cur = prev;
+    }
+
+private:
+    std::vector<CycleProfNode> nodes;
+    uint32_t cur = 0;
+};
+
+extern thread_local CycleProfThread cycleprof_thread;
+
+class CycleProfScope {
+public:
+    explicit CycleProfScope(const ProfId id) :
+        prev(cycleprof_thread.enter(id)),
+        start(cycleprof_now())
+    {}
+    ~CycleProfScope() {
+        cycleprof_thread.leave(prev, cycleprof_now()-start);
+    }
+    CycleProfScope(const CycleProfScope&) = delete;
+    CycleProfScope& operator=(const CycleProfScope&) = delete;
+
+private:
+    const uint32_t prev;
+    const uint64_t start;
+};
+
+}
+
+#define CYCLE_PROF_CAT2(a, b) a##b
+#define CYCLE_PROF_CAT(a, b) CYCLE_PROF_CAT2(a, b)
+#define CYCLE_PROF_SCOPE(id) \
+    CMSat::CycleProfScope CYCLE_PROF_CAT(cycle_prof_scope_, __LINE__)(CMSat::id)
+
+#else
+#define CYCLE_PROF_SCOPE(id) do {} while (0)
+#endif
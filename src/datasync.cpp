@@ -117,6 +117,35 @@ inline void DataSync::rebuild_bva_map_if_needed()
     }
 }
 
+bool DataSync::frat_enabled() const
+{
+    return solver->frat->enabled();
+}
+
+void DataSync::frat_sync_point()
+{
+    if (frat_enabled()) {
+        frat_last_sync = sharedData->frat_sync_at.fetch_add(1);
+        solver->frat->sync_point(frat_last_sync);
+    }
+}
+
+//With FRAT, clauses are only shared if all threads see exactly the same
+//literals, i.e. there is no replacement, renumbering or BVA in between
+bool DataSync::frat_same_lit(const Lit inter, const Lit outside) const
+{
+    return !frat_enabled() || inter == outside;
+}
+
+//Adds a copy of clause 'from_ID' of another thread to the proof
+int32_t DataSync::frat_import(const vector<Lit>& cl, const int64_t from_ID)
+{
+    const int32_t ID = ++solver->clauseID;
+    solver->frat->imported(ID, cl, from_ID);
+    frat_imports.push_back(FratImport{from_ID, frat_last_sync});
+    return ID;
+}
+
 bool DataSync::syncData()
 {
     if (!enabled()
@@ -130,6 +159,12 @@ bool DataSync::syncData()
     assert(solver->decisionLevel() == 0);
     rebuild_bva_map_if_needed();
 
+    //One FRAT sync point covers everything exported and imported below:
+    //all exported clauses are already in the proof, and imports are only
+    //written after it
+    frat_sync_point();
+    push_long_exports();
+
     //SEND data
     bool ok;
     sharedData->unit_mutex.lock();
@@ -153,6 +188,12 @@ bool DataSync::syncData()
         return false;
     }
 
+    #ifndef USE_GPU
+    if (!shareLongData()) {
+        return false;
+    }
+    #endif
+
     #ifdef USE_MPI
     if (solver->conf.is_mpi
         && solver->conf.thread_num == 0)
@@ -188,7 +229,6 @@ bool DataSync::syncData()
 bool DataSync::shareUnitData()
 {
     assert(solver->okay());
-    assert(!solver->frat->enabled());
 
     uint32_t thisGotUnitData = 0;
     uint32_t thisSentUnitData = 0;
@@ -199,6 +239,9 @@ bool DataSync::shareUnitData()
             shared.value.end(),
             solver->nVarsOutside()-shared.value.size(), l_Undef);
     }
+    if (frat_enabled() && shared.value_ID.size() < shared.value.size()) {
+        shared.value_ID.resize(shared.value.size(), 0);
+    }
     for (uint32_t var = 0; var < solver->nVarsOutside(); var++) {
         Lit thisLit = Lit(var, false);
         thisLit = solver->map_to_with_bva(thisLit);
@@ -210,9 +253,20 @@ bool DataSync::shareUnitData()
         if (thisVal == l_Undef && otherVal == l_Undef) {
             continue;
         }
+        if (!frat_same_lit(thisLit, Lit(var, false))) {
+            continue;
+        }
 
         if (thisVal != l_Undef && otherVal != l_Undef) {
             if (thisVal != otherVal) {
+                if (frat_enabled()) {
+                    const Lit other = thisLit ^ (otherVal == l_False);
+                    const int32_t ID = frat_import(vector<Lit>{other}, shared.value_ID[var]);
+                    *solver->frat << add << ++solver->clauseID << DratFlag::chain
+                        << ID << solver->unit_cl_IDs[thisLit.var()] << fin;
+                    solver->unsat_cl_ID = solver->clauseID;
+                    *solver->frat << del << ID << other << fin;
+                }
                 solver->ok = false;
                 return false;
             } else {
@@ -227,7 +281,13 @@ bool DataSync::shareUnitData()
                 continue;
             }
 
-            solver->enqueue<false>(litToEnqueue);
+            if (frat_enabled()) {
+                const int32_t ID = frat_import(vector<Lit>{litToEnqueue}, shared.value_ID[var]);
+                solver->unit_cl_IDs[litToEnqueue.var()] = ID;
+                solver->enqueue<false>(litToEnqueue, 0, PropBy(), false);
+            } else {
+                solver->enqueue<false>(litToEnqueue);
+            }
 
             thisGotUnitData++;
             continue;
@@ -235,6 +295,11 @@ bool DataSync::shareUnitData()
 
         if (thisVal != l_Undef) {
             assert(otherVal == l_Undef);
+            if (frat_enabled()) {
+                const int32_t ID = solver->unit_cl_IDs[thisLit.var()];
+                if (ID == 0) continue;
+                shared.value_ID[var] = solver->frat->global_ID(ID);
+            }
             shared.value[var] = thisVal;
             thisSentUnitData++;
             continue;
@@ -256,8 +321,11 @@ bool DataSync::shareUnitData()
     return true;
 }
 
-void CMSat::DataSync::signal_new_long_clause(const vector<Lit>& cl)
+void CMSat::DataSync::signal_new_long_clause(const vector<Lit>& cl, const uint32_t glue, const int32_t ID)
 {
+    if (ext.export_cl) {
+        export_to_external(cl);
+    }
     if (!enabled()) {
         return;
     }
@@ -282,7 +350,9 @@ void CMSat::DataSync::signal_new_long_clause(const vector<Lit>& cl)
     sharedData->gpuClauseSharer->addClause(thread_id, (int*)clause_tmp.data(), clause_tmp.size());
     #else
     if (cl.size() == 2) {
-        signal_new_bin_clause(cl[0], cl[1]);
+        signal_new_bin_clause(cl[0], cl[1], ID);
+    } else if (cl.size() > 2) {
+        signal_new_red_long_clause(cl, glue, ID);
     }
     #endif
 }
@@ -419,6 +489,165 @@ PropBy CMSat::DataSync::pop_clauses()
 }
 #endif
 
+////////////////////////////////////////
+// External callbacks
+////////////////////////////////////////
+void DataSync::set_external_callbacks(const ExternalCallbacks& cbs)
+{
+    ext = cbs;
+    ext_fixed_trail_at = 0;
+    ext_fixed_reported.clear();
+    rebuild_bva_map();
+}
+
+void DataSync::export_to_external(const vector<Lit>& cl)
+{
+    if (ext.export_max_len != -1 && cl.size() > (uint32_t)ext.export_max_len) {
+        return;
+    }
+    rebuild_bva_map_if_needed();
+
+    ext_tmp.clear();
+    for(Lit lit: cl) {
+        if (solver->varData[lit.var()].is_bva) {
+            return;
+        }
+        lit = solver->map_inter_to_outer(lit);
+        lit = map_outer_to_outside(lit);
+        ext_tmp.push_back(lit);
+    }
+    ext.export_cl(ext.data, ext_tmp);
+    stats.sentExtData++;
+}
+
+void DataSync::poll_terminate()
+{
+    if (ext.terminate && ext.terminate(ext.data)) {
+        solver->set_must_interrupt_asap();
+    }
+}
+
+bool DataSync::sync_external()
+{
+    assert(solver->decisionLevel() == 0);
+    if (!solver->okay()) {
+        return false;
+    }
+
+    poll_terminate();
+    if (ext.import_cl && !import_from_external()) {
+        return false;
+    }
+    if (ext.fixed) {
+        report_fixed_to_external();
+    }
+
+    return solver->okay();
+}
+
+bool DataSync::import_from_external()
+{
+    bool red;
+    while(ext.import_cl(ext.data, ext_tmp, red)) {
+        stats.recvExtData++;
+        if (!add_ext_clause(red)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//Adds the clause in 'ext_tmp'. Irredundant clauses that can't be added
+//during search (eliminated variables, FRAT) are deferred to the caller.
+bool DataSync::add_ext_clause(const bool red)
+{
+    assert(solver->okay());
+    bool can_add = !solver->frat->enabled();
+    for(const Lit lit: ext_tmp) {
+        if (lit.var() >= solver->nVarsOutside()) {
+            can_add = false;
+            break;
+        }
+    }
+    if (can_add) {
+        rebuild_bva_map_if_needed();
+        long_tmp.clear();
+        for(Lit lit: ext_tmp) {
+            lit = solver->map_to_with_bva(lit);
+            lit = solver->varReplacer->get_lit_replaced_with_outer(lit);
+            lit = solver->map_outer_to_inter(lit);
+            if (lit.var() >= solver->nVars()
+                || solver->varData[lit.var()].removed != Removed::none
+            ) {
+                can_add = false;
+                break;
+            }
+            long_tmp.push_back(lit);
+        }
+    }
+
+    if (!can_add) {
+        if (!red) {
+            ext_deferred_cls.push_back(ext_tmp);
+        }
+        return true;
+    }
+
+    ClauseStats cl_stats;
+    cl_stats.last_touched_any = solver->sumConflicts;
+    if (red) {
+        cl_stats.glue = long_tmp.size();
+        cl_stats.which_red_array = 2;
+    }
+    Clause* cl = solver->add_clause_int(long_tmp, red, &cl_stats, true, NULL, false);
+    if (cl) {
+        const ClOffset offset = solver->cl_alloc.get_offset(cl);
+        if (red) {
+            #if defined(STATS_NEEDED) || defined(FINAL_PREDICTOR)
+            ClauseStatsExtra stats_extra;
+            stats_extra.introduced_at_conflict = solver->sumConflicts;
+            stats_extra.orig_glue = cl->stats.glue;
+            stats_extra.orig_size = cl->size();
+            solver->red_stats_extra.push_back(stats_extra);
+            cl->stats.extra_pos = solver->red_stats_extra.size()-1;
+            #endif
+            solver->longRedCls[cl->stats.which_red_array].push_back(offset);
+        } else {
+            solver->longIrredCls.push_back(offset);
+        }
+    }
+
+    return solver->okay();
+}
+
+//The trail can shrink (and be re-filled) during simplification, so we keep
+//track of what has been reported, and report every variable only once
+void DataSync::report_fixed_to_external()
+{
+    if (ext_fixed_trail_at > solver->trail_size()) {
+        ext_fixed_trail_at = 0;
+    }
+    rebuild_bva_map_if_needed();
+    if (ext_fixed_reported.size() < solver->nVarsOutside()) {
+        ext_fixed_reported.resize(solver->nVarsOutside(), 0);
+    }
+
+    for(; ext_fixed_trail_at < solver->trail_size(); ext_fixed_trail_at++) {
+        Lit lit = solver->trail_at(ext_fixed_trail_at);
+        if (lit == lit_Undef || solver->varData[lit.var()].is_bva) {
+            continue;
+        }
+        lit = solver->map_inter_to_outer(lit);
+        lit = map_outer_to_outside(lit);
+        if (ext_fixed_reported[lit.var()]) {
+            continue;
+        }
+        ext_fixed_reported[lit.var()] = 1;
+        ext.fixed(ext.data, lit);
+    }
+}
+
 ////////////////////////////////////////
 // Non-GPU
 ////////////////////////////////////////
@@ -436,16 +665,18 @@ bool DataSync::syncBinFromOthers()
         lit1 = solver->map_outer_to_inter(lit1);
         if (solver->varData[lit1.var()].removed != Removed::none
             || solver->value(lit1.var()) != l_Undef
+            || !frat_same_lit(lit1, Lit::toLit(wsLit))
         ) {
             continue;
         }
 
         vector<Lit>& bins = *sharedData->bins[wsLit].data;
+        const vector<int64_t>* IDs = sharedData->bins[wsLit].IDs;
         watch_subarray ws = solver->watches[lit1];
 
         assert(syncFinish.size() > wsLit);
         if (bins.size() > syncFinish[wsLit]
-            && !syncBinFromOthers(lit1, bins, syncFinish[wsLit], ws)
+            && !syncBinFromOthers(lit1, bins, IDs, syncFinish[wsLit], ws)
         ) {
             return false;
         }
@@ -457,6 +688,7 @@ bool DataSync::syncBinFromOthers()
 bool DataSync::syncBinFromOthers(
     const Lit lit
     , const vector<Lit>& bins
+    , const vector<int64_t>* IDs
     , uint32_t& finished
     , watch_subarray ws
 ) {
@@ -480,6 +712,7 @@ bool DataSync::syncBinFromOthers(
         otherLit = solver->map_outer_to_inter(otherLit);
         if (solver->varData[otherLit.var()].removed != Removed::none
             || solver->value(otherLit) != l_Undef
+            || !frat_same_lit(otherLit, bins[i])
         ) {
             continue;
         }
@@ -489,8 +722,15 @@ bool DataSync::syncBinFromOthers(
             lits[0] = lit;
             lits[1] = otherLit;
 
-            //Don't add FRAT: it would add to the thread data, too
-            solver->add_clause_int(lits, true, NULL, true, NULL, false);
+            if (frat_enabled()) {
+                assert(IDs && IDs->size() == bins.size());
+                ClauseStats cl_stats;
+                cl_stats.ID = frat_import(lits, (*IDs)[i]);
+                solver->add_clause_int(lits, true, &cl_stats, true, NULL, true, lit_Undef, false, true);
+            } else {
+                //Don't add FRAT: it would add to the thread data, too
+                solver->add_clause_int(lits, true, NULL, true, NULL, false);
+            }
             if (!solver->okay()) {
                 goto end;
             }
@@ -509,27 +749,35 @@ bool DataSync::syncBinFromOthers(
 
 void DataSync::syncBinToOthers()
 {
-    for(const std::pair<Lit, Lit>& bin: newBinClauses) {
-        add_bin_to_threads(bin.first, bin.second);
+    for(size_t i = 0; i < newBinClauses.size(); i++) {
+        const std::pair<Lit, Lit>& bin = newBinClauses[i];
+        add_bin_to_threads(bin.first, bin.second, frat_enabled() ? newBinIDs[i] : 0);
     }
 
     newBinClauses.clear();
+    newBinIDs.clear();
 }
 
-bool DataSync::add_bin_to_threads(Lit lit1, Lit lit2)
+bool DataSync::add_bin_to_threads(Lit lit1, Lit lit2, const int64_t ID)
 {
     assert(lit1 < lit2);
-    if (sharedData->bins[lit1.toInt()].data == NULL) {
+    SharedData::Spec& spec = sharedData->bins[lit1.toInt()];
+    if (spec.data == NULL) {
         return false;
     }
 
-    vector<Lit>& bins = *sharedData->bins[lit1.toInt()].data;
+    vector<Lit>& bins = *spec.data;
     for (const Lit lit : bins) {
         if (lit == lit2)
             return false;
     }
 
     bins.push_back(lit2);
+    if (frat_enabled()) {
+        if (spec.IDs == NULL) spec.IDs = new vector<int64_t>;
+        spec.IDs->push_back(ID);
+        assert(spec.IDs->size() == bins.size());
+    }
     stats.sentBinData++;
     return true;
 }
@@ -580,7 +828,162 @@ bool DataSync::shareBinData()
     return ok;
 }
 
-void DataSync::signal_new_bin_clause(Lit lit1, Lit lit2)
+void DataSync::signal_new_red_long_clause(const vector<Lit>& cl, const uint32_t glue, const int32_t ID)
+{
+    if (glue > solver->conf.sync_long_max_glue
+        || cl.size() > solver->conf.sync_long_max_size
+        || cl.size() > LongClauseRing::max_cl_size
+    ) {
+        return;
+    }
+    rebuild_bva_map_if_needed();
+
+    //Don't signal clauses with BVA variables
+    long_tmp.clear();
+    for(Lit lit: cl) {
+        if (solver->varData[lit.var()].is_bva) {
+            return;
+        }
+        const Lit inter = lit;
+        lit = solver->map_inter_to_outer(lit);
+        lit = map_outer_to_outside(lit);
+        if (!frat_same_lit(inter, lit)) {
+            return;
+        }
+        long_tmp.push_back(lit);
+    }
+
+    //With FRAT, the clause may only be shared after a sync point that
+    //follows it in the proof. It is held back until the next sync
+    if (frat_enabled()) {
+        long_exports.push_back(LongExport{(uint32_t)long_tmp.size(), glue
+            , solver->frat->global_ID(ID)});
+        long_export_lits.insert(long_export_lits.end(), long_tmp.begin(), long_tmp.end());
+        return;
+    }
+
+    if (sharedData->long_cls.push(thread_id, long_tmp.data(), long_tmp.size()
+        , glue, solver->frat->global_ID(ID)))
+    {
+        stats.sentLongData++;
+    }
+}
+
+void DataSync::push_long_exports()
+{
+    const Lit* lits = long_export_lits.data();
+    for(const LongExport& e: long_exports) {
+        if (sharedData->long_cls.push(thread_id, lits, e.size, e.glue, e.ID)) {
+            stats.sentLongData++;
+        }
+        lits += e.size;
+    }
+    long_exports.clear();
+    long_export_lits.clear();
+}
+
+bool DataSync::shareLongData()
+{
+    assert(solver->okay());
+    assert(solver->decisionLevel() == 0);
+    const uint32_t oldRecvLongData = stats.recvLongData;
+    const LongClauseRing& ring = sharedData->long_cls;
+
+    //Anything older than 'capacity' has been overwritten, skip it
+    const uint64_t head = ring.get_head();
+    uint64_t at = long_cls_read_at;
+    if (head > ring.capacity && at < head - ring.capacity) {
+        at = head - ring.capacity;
+    }
+
+    int other_thread_id;
+    uint32_t glue;
+    int64_t ID;
+    for(; at < head; at++) {
+        const auto ret = ring.read(at, other_thread_id, long_tmp, glue, ID);
+        if (ret == LongClauseRing::ReadRet::pending) {
+            //Still being written, retry from here next time
+            break;
+        }
+        if (ret == LongClauseRing::ReadRet::gone
+            || other_thread_id == thread_id
+        ) {
+            continue;
+        }
+        if (!add_long_from_others(long_tmp, glue, ID)) {
+            break;
+        }
+    }
+    long_cls_read_at = at;
+
+    if (solver->conf.verbosity >= 5) {
+        cout
+        << "c [sync " << thread_id << "  ]"
+        << " got longs " << (stats.recvLongData - oldRecvLongData)
+        << " (total: " << stats.recvLongData << ")"
+        << " sent longs (total: " << stats.sentLongData << ")"
+        << endl;
+    }
+
+    return solver->okay();
+}
+
+bool DataSync::add_long_from_others(vector<Lit>& lits, const uint32_t glue, const int64_t ID)
+{
+    for(Lit& lit: lits) {
+        if (lit.var() >= solver->nVarsOutside()) {
+            return true;
+        }
+        const Lit outside = lit;
+        lit = solver->map_to_with_bva(lit);
+        lit = solver->varReplacer->get_lit_replaced_with_outer(lit);
+        lit = solver->map_outer_to_inter(lit);
+        if (solver->varData[lit.var()].removed != Removed::none
+            || !frat_same_lit(lit, outside)
+        ) {
+            return true;
+        }
+    }
+
+    ClauseStats cl_stats;
+    cl_stats.glue = glue;
+    cl_stats.last_touched_any = solver->sumConflicts;
+    if (glue <= solver->conf.glue_put_lev0_if_below_or_eq) {
+        cl_stats.which_red_array = 0;
+    } else if (glue <= solver->conf.glue_put_lev1_if_below_or_eq
+        && solver->conf.glue_put_lev1_if_below_or_eq != 0
+    ) {
+        cl_stats.which_red_array = 1;
+    } else {
+        cl_stats.which_red_array = 2;
+    }
+
+    Clause* cl;
+    if (frat_enabled()) {
+        cl_stats.ID = frat_import(lits, ID);
+        cl = solver->add_clause_int(lits, true, &cl_stats, true, NULL, true, lit_Undef, false, true);
+    } else {
+        //Don't add FRAT: it would add to the thread data, too
+        cl = solver->add_clause_int(lits, true, &cl_stats, true, NULL, false);
+    }
+    if (cl) {
+        #if defined(STATS_NEEDED) || defined(FINAL_PREDICTOR)
+        ClauseStatsExtra stats_extra;
+        stats_extra.introduced_at_conflict = solver->sumConflicts;
+        stats_extra.orig_glue = glue;
+        stats_extra.orig_size = cl->size();
+        solver->red_stats_extra.push_back(stats_extra);
+        cl->stats.extra_pos = solver->red_stats_extra.size()-1;
+        #endif
+        const ClOffset offset = solver->cl_alloc.get_offset(cl);
+        solver->longRedCls[cl->stats.which_red_array].push_back(offset);
+        stats.recvLongData++;
+    }
+
+    return solver->okay();
+}
+
+void DataSync::signal_new_bin_clause(Lit lit1, Lit lit2, const int32_t ID)
 {
     if (!enabled()) {
         return;
@@ -596,15 +999,23 @@ void DataSync::signal_new_bin_clause(Lit lit1, Lit lit2)
     if (solver->varData[lit2.var()].is_bva)
         return;
 
+    const Lit inter1 = lit1;
+    const Lit inter2 = lit2;
     lit1 = solver->map_inter_to_outer(lit1);
     lit1 = map_outer_to_outside(lit1);
     lit2 = solver->map_inter_to_outer(lit2);
     lit2 = map_outer_to_outside(lit2);
+    if (!frat_same_lit(inter1, lit1) || !frat_same_lit(inter2, lit2)) {
+        return;
+    }
 
     if (lit1.toInt() > lit2.toInt()) {
         std::swap(lit1, lit2);
     }
     newBinClauses.push_back(std::make_pair(lit1, lit2));
+    if (frat_enabled()) {
+        newBinIDs.push_back(solver->frat->global_ID(ID));
+    }
 }
 #endif
 
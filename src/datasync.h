@@ -27,6 +27,7 @@ THE SOFTWARE.
 #include "watched.h"
 #include "propby.h"
 #include "watcharray.h"
+#include "frat.h"
 #ifdef USE_MPI
 #include "mpi.h"
 #endif //USE_MPI
@@ -36,6 +37,23 @@ namespace CMSat {
 class Clause;
 class SharedData;
 class Solver;
+
+/**
+@brief Callbacks to an external clause-sharing party, e.g. an IPASIR2 user
+
+All literals passed are *outside* literals. Any of the callbacks may be NULL.
+'import_cl' must return FALSE if there are no more clauses to import.
+*/
+struct ExternalCallbacks
+{
+    void* data = NULL;
+    int32_t export_max_len = -1; // -1 means export all
+    void (*export_cl)(void* data, const vector<Lit>& cl) = NULL;
+    bool (*import_cl)(void* data, vector<Lit>& cl, bool& red) = NULL;
+    void (*fixed)(void* data, const Lit lit) = NULL;
+    int (*terminate)(void* data) = NULL;
+};
+
 class DataSync
 {
     public:
@@ -52,7 +70,16 @@ class DataSync
            const vector<uint32_t>& outerToInter
             , const vector<uint32_t>& interToOuter
         );
-        void signal_new_long_clause(const vector<Lit>& clause);
+        void signal_new_long_clause(const vector<Lit>& clause, const uint32_t glue, const int32_t ID);
+
+        //External callbacks
+        void set_external_callbacks(const ExternalCallbacks& cbs);
+        bool sync_external();
+        void poll_terminate();
+        vector<vector<Lit>>& get_deferred_ext_clauses();
+
+        //FRAT: the clauses imported since the last proof merge
+        vector<FratImport>& get_frat_imports() { return frat_imports; }
 
         #ifdef USE_GPU
         vector<Lit> clause_tmp;
@@ -70,6 +97,10 @@ class DataSync
             uint32_t recvUnitData = 0;
             uint32_t sentBinData = 0;
             uint32_t recvBinData = 0;
+            uint32_t sentLongData = 0;
+            uint32_t recvLongData = 0;
+            uint64_t sentExtData = 0;
+            uint64_t recvExtData = 0;
         };
         const Stats& get_stats() const;
 
@@ -79,13 +110,33 @@ class DataSync
         bool shareUnitData();
         bool shareBinData();
         bool syncBinFromOthers();
-        bool syncBinFromOthers(const Lit lit, const vector<Lit>& bins, uint32_t& finished, watch_subarray ws);
+        bool syncBinFromOthers(
+            const Lit lit
+            , const vector<Lit>& bins
+            , const vector<int64_t>* IDs
+            , uint32_t& finished
+            , watch_subarray ws
+        );
         void syncBinToOthers();
         void clear_set_binary_values();
-        bool add_bin_to_threads(const Lit lit1, const Lit lit2);
-        void signal_new_bin_clause(Lit lit1, Lit lit2);
+        bool add_bin_to_threads(const Lit lit1, const Lit lit2, const int64_t ID);
+        void signal_new_bin_clause(Lit lit1, Lit lit2, const int32_t ID);
+        void signal_new_red_long_clause(const vector<Lit>& cl, const uint32_t glue, const int32_t ID);
+        void push_long_exports();
+        bool shareLongData();
+        bool add_long_from_others(vector<Lit>& lits, const uint32_t glue, const int64_t ID);
+        void export_to_external(const vector<Lit>& cl);
+        bool import_from_external();
+        void report_fixed_to_external();
+        bool add_ext_clause(const bool red);
         void rebuild_bva_map_if_needed();
 
+        //FRAT
+        bool frat_enabled() const;
+        void frat_sync_point();
+        bool frat_same_lit(const Lit inter, const Lit outside) const;
+        int32_t frat_import(const vector<Lit>& cl, const int64_t from_ID);
+
 
         #ifdef USE_GPU
         uint32_t trailCopiedUntil = 0;
@@ -94,6 +145,29 @@ class DataSync
 
         //stuff to sync
         vector<std::pair<Lit, Lit> > newBinClauses;
+        vector<int64_t> newBinIDs; //only with FRAT
+        uint64_t long_cls_read_at = 0;
+        vector<Lit> long_tmp;
+
+        //Long clauses held back until the next FRAT sync point
+        struct LongExport {
+            uint32_t size;
+            uint32_t glue;
+            int64_t ID;
+        };
+        vector<LongExport> long_exports;
+        vector<Lit> long_export_lits;
+
+        //FRAT
+        uint64_t frat_last_sync = 0;
+        vector<FratImport> frat_imports;
+
+        //External callbacks
+        ExternalCallbacks ext;
+        vector<Lit> ext_tmp;
+        uint32_t ext_fixed_trail_at = 0;
+        vector<char> ext_fixed_reported; //indexed by outside var
+        vector<vector<Lit>> ext_deferred_cls;
 
         //stats
         uint64_t lastSyncConf = 0;
@@ -151,6 +225,11 @@ inline bool DataSync::enabled()
     return sharedData != NULL;
 }
 
+inline vector<vector<Lit>>& DataSync::get_deferred_ext_clauses()
+{
+    return ext_deferred_cls;
+}
+
 }
 
 #endif
@@ -42,6 +42,8 @@ using std::endl;
 
 namespace CMSat {
 
+template <class S> class MMapDimacsParser;
+
 template <class C, class S>
 class DimacsParser
 {
@@ -52,6 +54,10 @@ class DimacsParser
             T input_stpeam,
             const bool strict_header,
             uint32_t offset_vars = 0);
+
+        //Parse more input, keeping the state (header, line number, sampling
+        //vars, etc.) from previous calls. Prints no stats.
+        template <class T> bool parse_DIMACS_more(T input_stream);
         uint64_t max_var = numeric_limits<uint64_t>::max();
         vector<uint32_t> sampling_vars;
         bool sampling_vars_found = false;
@@ -61,6 +67,7 @@ class DimacsParser
         const std::string please_read_dimacs = "\nPlease read DIMACS specification at http://www.satcompetition.org/2009/format-benchmarks2009.html";
 
     private:
+        template <class S2> friend class MMapDimacsParser;
         bool parse_DIMACS_main(C& in);
         bool readClause(C& in);
         bool parse_and_add_clause(C& in);
@@ -713,6 +720,14 @@ bool DimacsParser<C, S>::parse_DIMACS(
     return true;
 }
 
+template <class C, class S>
+template <class T>
+bool DimacsParser<C, S>::parse_DIMACS_more(T input_stream)
+{
+    C in(input_stream);
+    return parse_DIMACS_main(in);
+}
+
 template <class C, class S>
 bool DimacsParser<C, S>::parseIndependentSet(C& in)
 {
@@ -0,0 +1,400 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#include "flatforest.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <utility>
+
+using namespace CMSat;
+using std::string;
+using std::cout;
+using std::endl;
+
+namespace {
+
+//Just enough JSON to read XGBoost's model files
+struct JVal
+{
+    enum class Type {null_t, boolean_t, num_t, str_t, arr_t, obj_t};
+    Type type = Type::null_t;
+    double num = 0;
+    string str;
+    vector<JVal> arr;
+    vector<std::pair<string, JVal>> obj;
+
+    const JVal& operator[](const char* key) const
+    {
+        static const JVal none;
+        for(const auto& kv: obj) {
+            if (kv.first == key) return kv.second;
+        }
+        return none;
+    }
+
+    double as_num() const
+    {
+        //XGBoost stores some numbers as strings, e.g. "5E-1" or "[5E-1]"
+        if (type == Type::str_t) {
+            const char* at = str.c_str();
+            if (*at == '[') at++;
+            return strtod(at, NULL);
+        }
+        return num;
+    }
+};
+
+class JsonParser
+{
+public:
+    JsonParser(const char* _at, const char* _end) :
+        at(_at)
+        , end(_end)
+    {}
+
+    bool parse(JVal& v)
+    {
+        ws();
+        if (at >= end) return false;
+        switch(*at) {
+            case '{': return parse_obj(v);
+            case '[': return parse_arr(v);
+            case '"':
+                v.type = JVal::Type::str_t;
+                return parse_str(v.str);
+            case 't':
+            case 'f':
+                v.type = JVal::Type::boolean_t;
+                v.num = (*at == 't');
+                return word(*at == 't' ? "true" : "false");
+            case 'n':
+                v.type = JVal::Type::null_t;
+                return word("null");
+            default: {
+                char* num_end;
+                v.type = JVal::Type::num_t;
+                v.num = strtod(at, &num_end);
+                if (num_end == at) return false;
+                at = num_end;
+                return true;
+            }
+        }
+    }
+
+private:
+    void ws()
+    {
+        while(at < end && (*at == ' ' || *at == '\n' || *at == '\r' || *at == '\t')) at++;
+    }
+
+    bool word(const char* w)
+    {
+        const size_t len = strlen(w);
+        if ((size_t)(end-at) < len || strncmp(at, w, len) != 0) return false;
+        at += len;
+        return true;
+    }
+
+    bool parse_str(string& s)
+    {
+        assert(*at == '"');
+        at++;
+        s.clear();
+        while(at < end && *at != '"') {
+            if (*at != '\\') {
+                s += *at++;
+                continue;
+            }
+            at++;
+            if (at >= end) return false;
+            switch(*at++) {
+                case 'b': s += '\b'; break;
+                case 'f': s += '\f'; break;
+                case 'n': s += '\n'; break;
+                case 'r': s += '\r'; break;
+                case 't': s += '\t'; break;
+                case 'u': if (!parse_unicode(s)) return false; break;
+                default: s += at[-1]; break; //'"', '\\' and '/'
+            }
+        }
+        if (at >= end) return false;
+        at++;
+        return true;
+    }
+
+    bool hex4(uint32_t& c)
+    {
+        if (end-at < 4) return false;
+        c = 0;
+        for(int i = 0; i < 4; i++, at++) {
+            c <<= 4;
+            if (*at >= '0' && *at <= '9') c |= *at - '0';
+            else if (*at >= 'a' && *at <= 'f') c |= *at - 'a' + 10;
+            else if (*at >= 'A' && *at <= 'F') c |= *at - 'A' + 10;
+            else return false;
+        }
+        return true;
+    }
+
+    //The XXXX of a \uXXXX escape, as UTF-8. UTF-16 surrogate pairs are
+    //two escapes in a row
+    bool parse_unicode(string& s)
+    {
+        uint32_t c;
+        if (!hex4(c)) return false;
+        if (c >= 0xD800 && c <= 0xDBFF) {
+            uint32_t low;
+            if (end-at < 2 || at[0] != '\\' || at[1] != 'u') return false;
+            at += 2;
+            if (!hex4(low) || low < 0xDC00 || low > 0xDFFF) return false;
+            c = 0x10000 + ((c - 0xD800) << 10) + (low - 0xDC00);
+        } else if (c >= 0xDC00 && c <= 0xDFFF) {
+            return false;
+        }
+
+        if (c < 0x80) {
+            s += (char)c;
+        } else if (c < 0x800) {
+            s += (char)(0xC0 | (c >> 6));
+            s += (char)(0x80 | (c & 0x3F));
+        } else if (c < 0x10000) {
+            s += (char)(0xE0 | (c >> 12));
+            s += (char)(0x80 | ((c >> 6) & 0x3F));
+            s += (char)(0x80 | (c & 0x3F));
+        } else {
+            s += (char)(0xF0 | (c >> 18));
+            s += (char)(0x80 | ((c >> 12) & 0x3F));
+            s += (char)(0x80 | ((c >> 6) & 0x3F));
+            s += (char)(0x80 | (c & 0x3F));
+        }
+        return true;
+    }
+
+    bool parse_arr(JVal& v)
+    {
+        v.type = JVal::Type::arr_t;
+        at++;
+        ws();
+        if (at < end && *at == ']') {
+            at++;
+            return true;
+        }
+        for(;;) {
+            v.arr.emplace_back();
+            if (!parse(v.arr.back())) return false;
+            ws();
+            if (at >= end) return false;
+            if (*at == ']') {
+                at++;
+                return true;
+            }
+            if (*at++ != ',') return false;
+        }
+    }
+
+    bool parse_obj(JVal& v)
+    {
+        v.type = JVal::Type::obj_t;
+        at++;
+        ws();
+        if (at < end && *at == '}') {
+            at++;
+            return true;
+        }
+        for(;;) {
+            ws();
+            if (at >= end || *at != '"') return false;
+            v.obj.emplace_back();
+            if (!parse_str(v.obj.back().first)) return false;
+            ws();
+            if (at >= end || *at++ != ':') return false;
+            if (!parse(v.obj.back().second)) return false;
+            ws();
+            if (at >= end) return false;
+            if (*at == '}') {
+                at++;
+                return true;
+            }
+            if (*at++ != ',') return false;
+        }
+    }
+
+    const char* at;
+    const char* end;
+};
+
+//Adds the tree to the forest, children of a node next to each other
+bool add_tree(const JVal& tree, FlatForest& f)
+{
+    const JVal& lefts = tree["left_children"];
+    const JVal& rights = tree["right_children"];
+    const JVal& conds = tree["split_conditions"];
+    const JVal& feats = tree["split_indices"];
+    const JVal& defs = tree["default_left"];
+    const size_t num = lefts.arr.size();
+    if (num == 0
+        || rights.arr.size() != num
+        || conds.arr.size() != num
+        || feats.arr.size() != num
+        || defs.arr.size() != num
+    ) {
+        return false;
+    }
+
+    const uint32_t base = f.left.size();
+    f.left.resize(base+num);
+    f.feat.resize(base+num);
+    f.thresh.resize(base+num);
+    f.flags.resize(base+num);
+    f.value.resize(base+num);
+
+    //Breadth-first, with the depth of each node
+    vector<std::pair<uint32_t, uint32_t>> queue; //(old node, depth)
+    vector<uint32_t> new_at(num);
+    queue.push_back(std::make_pair(0, 0));
+    new_at[0] = base;
+    uint32_t next_free = base+1;
+    uint32_t depth = 0;
+    for(size_t i = 0; i < queue.size(); i++) {
+        const uint32_t old = queue[i].first;
+        const uint32_t n = new_at[old];
+        depth = std::max(depth, queue[i].second);
+        const int l = lefts.arr[old].as_num();
+        const int r = rights.arr[old].as_num();
+        if (l == -1) {
+            f.left[n] = n;
+            f.feat[n] = 0;
+            f.thresh[n] = 0;
+            f.flags[n] = 0;
+            f.value[n] = conds.arr[old].as_num();
+            continue;
+        }
+        if (l < 0 || r < 0 || (size_t)l >= num || (size_t)r >= num
+            || feats.arr[old].as_num() >= f.cols
+            || next_free+2 > base+num
+        ) {
+            return false;
+        }
+        new_at[l] = next_free;
+        new_at[r] = next_free+1;
+        f.left[n] = next_free;
+        f.feat[n] = feats.arr[old].as_num();
+        f.thresh[n] = conds.arr[old].as_num();
+        f.flags[n] = 2 | (defs.arr[old].as_num() != 0);
+        f.value[n] = 0;
+        next_free += 2;
+        queue.push_back(std::make_pair(l, queue[i].second+1));
+        queue.push_back(std::make_pair(r, queue[i].second+1));
+    }
+    if (next_free != base+num) return false;
+
+    f.roots.push_back(base);
+    f.depth.push_back(depth);
+    return true;
+}
+
+}
+
+bool FlatForest::load(const char* json, const size_t len, const uint32_t _cols)
+{
+    JVal model;
+    JsonParser parser(json, json+len);
+    if (!parser.parse(model)) return false;
+
+    const JVal& learner = model["learner"];
+    const JVal& trees = learner["gradient_booster"]["model"]["trees"];
+    if (trees.type != JVal::Type::arr_t) return false;
+
+    *this = FlatForest();
+    cols = _cols;
+    for(const JVal& tree: trees.arr) {
+        if (!add_tree(tree, *this)) return false;
+    }
+
+    const string& objective = learner["objective"]["name"].str;
+    const double base_score = learner["learner_model_param"]["base_score"].as_num();
+    if (objective == "reg:squarederror" || objective == "reg:linear") {
+        logistic = false;
+        base_margin = base_score;
+    } else if (objective == "binary:logistic" || objective == "reg:logistic") {
+        logistic = true;
+        base_margin = std::log(base_score/(1.0-base_score));
+    } else {
+        cout << "ERROR: native predictor does not support objective '"
+        << objective << "'" << endl;
+        return false;
+    }
+    return true;
+}
+
+bool FlatForest::load_file(const string& fname, const uint32_t _cols)
+{
+    std::ifstream in(fname.c_str());
+    if (!in) {
+        cout << "ERROR: cannot open predictor file '" << fname << "'" << endl;
+        return false;
+    }
+    std::stringstream ss;
+    ss << in.rdbuf();
+    const string json = ss.str();
+    if (!load(json.data(), json.size(), _cols)) {
+        cout << "ERROR: cannot read XGBoost JSON model from '" << fname << "'" << endl;
+        return false;
+    }
+    return true;
+}
+
+void FlatForest::predict(const float* data, const uint32_t num, float* out) const
+{
+    constexpr uint32_t batch = 64;
+    float acc[batch];
+    uint32_t at[batch];
+    for(uint32_t start = 0; start < num; start += batch) {
+        const uint32_t rows = std::min(batch, num-start);
+        const float* const rows_data = data + (size_t)start*cols;
+        for(uint32_t r = 0; r < rows; r++) acc[r] = base_margin;
+
+        //Tree by tree, so the tree's nodes stay in cache for the whole batch
+        for(uint32_t t = 0; t < roots.size(); t++) {
+            for(uint32_t r = 0; r < rows; r++) at[r] = roots[t];
+            for(uint32_t d = 0; d < depth[t]; d++) {
+                for(uint32_t r = 0; r < rows; r++) {
+                    const uint32_t n = at[r];
+                    const float x = rows_data[r*cols + feat[n]];
+                    const uint32_t right = std::isnan(x) ? !(flags[n] & 1) : !(x < thresh[n]);
+                    at[r] = left[n] + (right & (flags[n] >> 1));
+                }
+            }
+            for(uint32_t r = 0; r < rows; r++) acc[r] += value[at[r]];
+        }
+
+        for(uint32_t r = 0; r < rows; r++) {
+            out[start+r] = logistic ? 1.0f/(1.0f+std::exp(-acc[r])) : acc[r];
+        }
+    }
+}
@@ -0,0 +1,68 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#ifndef _FLATFOREST_H__
+#define _FLATFOREST_H__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using std::vector;
+
+namespace CMSat {
+
+/**
+@brief Tree ensemble, flattened for batch evaluation
+
+Nodes of all trees are in one structure-of-arrays. The children of a node
+are next to each other (right == left+1), so stepping is branchless:
+next = left[n] + !(x[feat[n]] < thresh[n]), with NaN (missing) going to
+the default child. Leaves never move, so all rows of a batch can be
+stepped in lockstep for 'depth' steps, no matter where they end up.
+*/
+struct FlatForest
+{
+    vector<uint32_t> left;
+    vector<uint32_t> feat;
+    vector<float> thresh;
+    vector<uint8_t> flags; //bit 0: NaN goes left, bit 1: inner node
+    vector<float> value; //leaf value, 0 for inner nodes
+
+    vector<uint32_t> roots;
+    vector<uint32_t> depth;
+    float base_margin = 0;
+    bool logistic = false;
+    uint32_t cols = 0; //features per row
+
+    //Reads an XGBoost JSON model over rows of 'cols' features. Returns
+    //FALSE if the model is malformed or not supported
+    bool load(const char* json, size_t len, uint32_t cols);
+    bool load_file(const std::string& fname, uint32_t cols);
+
+    //'data' is 'num' rows of 'cols' features
+    void predict(const float* data, uint32_t num, float* out) const;
+};
+
+}
+
+#endif //_FLATFOREST_H__
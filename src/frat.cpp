@@ -20,6 +20,350 @@ THE SOFTWARE.
 
 #include "frat.h"
 
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <map>
+
 namespace CMSat {
     void Drat::flush() {}
 }
+
+using namespace CMSat;
+
+FratWriter::FratWriter(
+    FILE* _file
+    , size_t buf_size
+    , bool _async
+    , int _compress
+) :
+    file(_file)
+    , async(_async)
+    , compress(_compress)
+{
+    #ifdef USE_ZLIB
+    if (compress > 0) {
+        memset(&zs, 0, sizeof(zs));
+        //15+16: gzip header and trailer instead of raw zlib
+        if (deflateInit2(&zs, std::min(compress, 9), Z_DEFLATED, 15+16, 8
+            , Z_DEFAULT_STRATEGY) != Z_OK)
+        {
+            std::cerr << "ERROR: Could not set up FRAT compression" << std::endl;
+            exit(-1);
+        }
+        zbuf.resize(256*1024);
+    }
+    #else
+    compress = 0;
+    #endif
+
+    if (async) {
+        spare = new unsigned char[buf_size];
+        thd = std::thread(&FratWriter::thread_loop, this);
+    }
+}
+
+FratWriter::~FratWriter()
+{
+    if (async) {
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cv.wait(lock, [this]{ return pending == NULL; });
+            stop = true;
+        }
+        cv.notify_all();
+        thd.join();
+        delete[] spare;
+    }
+
+    #ifdef USE_ZLIB
+    if (compress > 0) {
+        if (zs_open) deflate_out(Z_FINISH);
+        deflateEnd(&zs);
+    }
+    #endif
+}
+
+unsigned char* FratWriter::write(unsigned char* buf, size_t len)
+{
+    if (!async) {
+        write_out(buf, len);
+        return buf;
+    }
+
+    std::unique_lock<std::mutex> lock(mtx);
+    cv.wait(lock, [this]{ return pending == NULL; });
+    unsigned char* ret = spare;
+    spare = NULL;
+    pending = buf;
+    pending_len = len;
+    lock.unlock();
+    cv.notify_all();
+    return ret;
+}
+
+void FratWriter::write_copy(const unsigned char* buf, size_t len)
+{
+    if (async) {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv.wait(lock, [this]{ return pending == NULL; });
+    }
+    write_out(buf, len);
+}
+
+void FratWriter::sync()
+{
+    std::unique_lock<std::mutex> lock(mtx, std::defer_lock);
+    if (async) {
+        lock.lock();
+        cv.wait(lock, [this]{ return pending == NULL; });
+    }
+
+    #ifdef USE_ZLIB
+    if (compress > 0 && zs_open) {
+        deflate_out(Z_SYNC_FLUSH);
+    }
+    #endif
+}
+
+void FratWriter::thread_loop()
+{
+    std::unique_lock<std::mutex> lock(mtx);
+    for(;;) {
+        cv.wait(lock, [this]{ return pending != NULL || stop; });
+        if (pending == NULL) return;
+
+        unsigned char* buf = pending;
+        const size_t len = pending_len;
+        lock.unlock();
+        write_out(buf, len);
+        lock.lock();
+
+        spare = buf;
+        pending = NULL;
+        cv.notify_all();
+    }
+}
+
+void FratWriter::write_out(const unsigned char* buf, size_t len)
+{
+    #ifdef USE_ZLIB
+    if (compress > 0) {
+        zs.next_in = (Bytef*)buf;
+        zs.avail_in = len;
+        zs_open = true;
+        deflate_out(Z_NO_FLUSH);
+        return;
+    }
+    #endif
+
+    fwrite(buf, sizeof(unsigned char), len, file);
+}
+
+#ifdef USE_ZLIB
+void FratWriter::deflate_out(int flush)
+{
+    int ret;
+    do {
+        zs.next_out = zbuf.data();
+        zs.avail_out = zbuf.size();
+        ret = deflate(&zs, flush);
+        assert(ret != Z_STREAM_ERROR);
+        fwrite(zbuf.data(), sizeof(unsigned char), zbuf.size() - zs.avail_out, file);
+    } while (zs.avail_out == 0 || (flush == Z_FINISH && ret != Z_STREAM_END));
+}
+#endif
+
+namespace {
+
+//The lines of a stream up to its next sync point
+struct FratChunk
+{
+    uint64_t at; //sync point that ends the chunk, max() at end of stream
+    std::string lines;
+};
+
+//Reads one line (with its '\n') into 'line'. Returns FALSE at end of file
+bool read_frat_line(FILE* f, std::string& line)
+{
+    char tmp[4096];
+    line.clear();
+    while (fgets(tmp, sizeof(tmp), f) != NULL) {
+        line += tmp;
+        if (line.back() == '\n') break;
+    }
+    return !line.empty();
+}
+
+int64_t frat_line_ID(const std::string& line)
+{
+    return strtoll(line.c_str()+2, NULL, 10);
+}
+
+//The literals of an "o ID lits 0" line, sorted, as a hash key
+std::string frat_orig_key(const std::string& line)
+{
+    vector<long long> lits;
+    const char* at = line.c_str()+2;
+    char* next;
+    strtoll(at, &next, 10);
+    for(;;) {
+        at = next;
+        const long long l = strtoll(at, &next, 10);
+        if (next == at || l == 0) break;
+        lits.push_back(l);
+    }
+    std::sort(lits.begin(), lits.end());
+    std::string key;
+    for(const long long l: lits) {
+        key += std::to_string(l);
+        key += ' ';
+    }
+    return key;
+}
+
+//Reads the next chunk of 'f', moving 'pos' past it. Returns FALSE at end
+//of file
+bool read_frat_chunk(FILE* f, long& pos, FratChunk& c, std::string& line)
+{
+    c.at = std::numeric_limits<uint64_t>::max();
+    c.lines.clear();
+    unsigned long long at;
+    bool any = false;
+    while (read_frat_line(f, line)) {
+        any = true;
+        pos += line.size();
+        if (sscanf(line.c_str(), "c sync %llu", &at) == 1) {
+            c.at = at;
+            break;
+        }
+        c.lines += line;
+    }
+    return any;
+}
+
+}
+
+void CMSat::merge_frat_streams(
+    const vector<FILE*>& streams
+    , vector<long>& read_at
+    , const vector<vector<FratImport>>& imports
+    , FratWriter& writer
+) {
+    const uint32_t n = streams.size();
+    assert(read_at.size() == n);
+    assert(imports.size() == n);
+    std::string line;
+
+    //Every stream is read once, front to back. Its current chunk waits
+    //until it is the one with the lowest sync point
+    vector<FratChunk> cur(n);
+    vector<char> live(n);
+    for(uint32_t s = 0; s < n; s++) {
+        fflush(streams[s]);
+        fseek(streams[s], read_at[s], SEEK_SET);
+        live[s] = read_frat_chunk(streams[s], read_at[s], cur[s], line);
+    }
+
+    std::string obuf;
+    auto emit = [&](const std::string& l) {
+        obuf += l;
+        if (obuf.size() > 1024*1024) {
+            writer.write_copy((const unsigned char*)obuf.data(), obuf.size());
+            obuf.clear();
+        }
+    };
+
+    //A clause that thread 't' imported after its sync point 'at' may only
+    //be deleted once t's chunk ending after 'at' is written. Deletions that
+    //must wait are kept in waiting[t], keyed by 'at'
+    std::unordered_map<int64_t, vector<std::pair<uint32_t, uint64_t>>> imported;
+    for(uint32_t t = 0; t < n; t++) {
+        for(const FratImport& imp: imports[t]) {
+            imported[imp.ID].push_back(std::make_pair(t, imp.at));
+        }
+    }
+    vector<uint64_t> written(n, 0); //sync point of the last chunk written
+    vector<std::multimap<uint64_t, std::string>> waiting(n);
+
+    //Later threads' copies of an original clause refer to the first copy,
+    //so deleting that copy waits until the end
+    std::unordered_map<std::string, int64_t> origs;
+    std::unordered_set<int64_t> first_origs;
+    vector<std::string> at_end;
+
+    auto emit_del = [&](const std::string& l) {
+        const int64_t ID = frat_line_ID(l);
+        const auto it = imported.find(ID);
+        if (it != imported.end()) {
+            for(const auto& imp: it->second) {
+                if (written[imp.first] <= imp.second) {
+                    waiting[imp.first].emplace(imp.second, l);
+                    return;
+                }
+            }
+        }
+        if (first_origs.count(ID)) {
+            at_end.push_back(l);
+            return;
+        }
+        emit(l);
+    };
+
+    for(;;) {
+        uint32_t s = n;
+        for(uint32_t i = 0; i < n; i++) {
+            if (live[i] && (s == n || cur[i].at < cur[s].at)) s = i;
+        }
+        if (s == n) break;
+
+        const std::string& lines = cur[s].lines;
+        size_t begin = 0;
+        while (begin < lines.size()) {
+            size_t end = lines.find('\n', begin);
+            end = (end == std::string::npos) ? lines.size() : end+1;
+            line.assign(lines, begin, end - begin);
+            begin = end;
+            if (line[0] == 'o') {
+                const int64_t ID = frat_line_ID(line);
+                const auto ret = origs.insert(std::make_pair(frat_orig_key(line), ID));
+                if (ret.second) {
+                    first_origs.insert(ID);
+                    emit(line);
+                } else {
+                    emit("a " + line.substr(2, line.size()-3)
+                        + " l " + std::to_string(ret.first->second) + " 0\n");
+                }
+            } else if (line[0] == 'd' || line[0] == 'f') {
+                emit_del(line);
+            } else {
+                emit(line);
+            }
+        }
+
+        written[s] = cur[s].at;
+        auto& w = waiting[s];
+        while (!w.empty() && w.begin()->first < written[s]) {
+            const std::string l = std::move(w.begin()->second);
+            w.erase(w.begin());
+            emit_del(l);
+        }
+        live[s] = read_frat_chunk(streams[s], read_at[s], cur[s], line);
+    }
+
+    //Everything is written, nothing has to wait any more
+    for(uint32_t t = 0; t < n; t++) {
+        written[t] = std::numeric_limits<uint64_t>::max();
+    }
+    for(auto& w: waiting) {
+        for(const auto& it: w) emit_del(it.second);
+    }
+    for(const std::string& l: at_end) emit(l);
+
+    if (!obuf.empty()) writer.write_copy((const unsigned char*)obuf.data(), obuf.size());
+    writer.sync();
+
+    for(FILE* f: streams) fseek(f, 0, SEEK_END);
+}
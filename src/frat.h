@@ -30,6 +30,13 @@ THE SOFTWARE.
 #include <vector>
 #include <iostream>
 #include <stdio.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#ifdef USE_ZLIB
+#include <zlib.h>
+#endif
 
 using std::vector;
 // #define DEBUG_FRAT
@@ -128,24 +135,128 @@ public:
 
     virtual void flush();
 
+    //Multi-threaded FRAT: each thread writes its own stream, and clause IDs
+    //are made globally unique by interleaving them between the threads
+    virtual void set_thread_num(uint32_t /*thread_num*/, uint32_t /*num_threads*/)
+    {
+    }
+
+    virtual int64_t global_ID(const int32_t ID) const
+    {
+        return ID;
+    }
+
+    //Adds clause 'ID', a copy of clause 'from_ID' of another thread
+    virtual void imported(const int32_t /*ID*/, const vector<Lit>& /*cl*/, const int64_t /*from_ID*/)
+    {
+    }
+
+    //Everything written before this point is merged before everything
+    //any other thread writes after a higher sync point
+    virtual void sync_point(const uint64_t /*at*/)
+    {
+    }
+
     int buf_len;
     unsigned char* drup_buf = NULL;
     unsigned char* buf_ptr = NULL;
 };
 
+//Moves filled proof buffers to the file. When async, a helper thread does
+//the writing (and compressing), so the solver thread only waits if it fills
+//a buffer before the previous one has been written out
+class FratWriter
+{
+public:
+    //compress: 0 = plain, 1..9 = gzip at that level
+    FratWriter(FILE* file, size_t buf_size, bool async, int compress);
+    ~FratWriter();
+    FratWriter(const FratWriter&) = delete;
+    FratWriter& operator=(const FratWriter&) = delete;
+
+    //Takes over buf, returns the buffer the caller must fill next
+    unsigned char* write(unsigned char* buf, size_t len);
+
+    //Writes buf before returning, the caller keeps it
+    void write_copy(const unsigned char* buf, size_t len);
+
+    //Returns once everything handed over is in the FILE. When compressing,
+    //the deflate stream is flushed to a byte boundary but kept open, so the
+    //whole proof is one gzip member that is only finished by the destructor
+    void sync();
+
+    FILE* get_file() const
+    {
+        return file;
+    }
+
+private:
+    void write_out(const unsigned char* buf, size_t len);
+    void thread_loop();
+
+    FILE* file;
+    const bool async;
+    int compress;
+
+    //Protected by mtx. When pending is NULL, spare is not NULL
+    std::mutex mtx;
+    std::condition_variable cv;
+    unsigned char* spare = NULL;
+    unsigned char* pending = NULL;
+    size_t pending_len = 0;
+    bool stop = false;
+    std::thread thd;
+
+    #ifdef USE_ZLIB
+    void deflate_out(int flush);
+    z_stream zs;
+    vector<unsigned char> zbuf;
+    bool zs_open = false;
+    #endif
+};
+
+//A clause of another thread that was copied into this thread's proof after
+//this thread's sync point 'at'
+struct FratImport
+{
+    int64_t ID;
+    uint64_t at;
+};
+
+//Merges the text FRAT streams written by the threads of a multi-threaded
+//solve into one proof. Only the part of stream 'i' from read_at[i] onwards
+//is merged, and read_at[i] is moved to its end. Streams are cut at their
+//sync points and the pieces are ordered by them, reading every stream only
+//once. imports[i] are the clauses thread 'i' imported since the last merge:
+//their deletion is held back until the import is written. Original clauses
+//that several threads added are only kept once.
+//The same writer must be passed to every merge of a proof.
+void merge_frat_streams(
+    const vector<FILE*>& streams
+    , vector<long>& read_at
+    , const vector<vector<FratImport>>& imports
+    , FratWriter& writer
+);
+
 template<bool binfrat = false>
 class DratFile: public Drat
 {
 public:
-    DratFile(vector<uint32_t>& _interToOuterMain) :
-        interToOuterMain(_interToOuterMain)
-    {
-        drup_buf = new unsigned char[2 * 1024 * 1024];
+    DratFile(
+        vector<uint32_t>& _interToOuterMain
+        , bool _async = false
+        , int _compress = 0
+    ) :
+        async(_async)
+        , compress(_compress)
+        , interToOuterMain(_interToOuterMain)
+    {
+        drup_buf = new unsigned char[buf_size];
         buf_ptr = drup_buf;
         buf_len = 0;
-        memset(drup_buf, 0, 2 * 1024 * 1024);
+        memset(drup_buf, 0, buf_size);
 
-        del_buf = new unsigned char[2 * 1024 * 1024];
+        del_buf = new unsigned char[buf_size];
         del_ptr = del_buf;
         del_len = 0;
     }
@@ -153,6 +264,7 @@ public:
     virtual ~DratFile()
     {
         flush();
+        delete writer;
         delete[] drup_buf;
         delete[] del_buf;
     }
@@ -182,20 +294,57 @@ public:
         return drup_file;
     }
 
+    //Everything so far is in the FILE once this returns
     void flush() override
     {
+        if (!writer) return;
         binDRUP_flush();
+        writer->sync();
     }
 
+    //Hands the buffer to the writer, which may still be writing it when
+    //this returns
     void binDRUP_flush() {
-        fwrite(drup_buf, sizeof(unsigned char), buf_len, drup_file);
+        if (buf_len > 0) drup_buf = writer->write(drup_buf, buf_len);
         buf_ptr = drup_buf;
         buf_len = 0;
     }
 
     void setFile(FILE* _file) override
     {
+        flush();
+        delete writer;
         drup_file = _file;
+        writer = new FratWriter(drup_file, buf_size, async, compress);
+    }
+
+    void set_thread_num(uint32_t _thread_num, uint32_t _num_threads) override
+    {
+        assert(_thread_num < _num_threads);
+        thread_num = _thread_num;
+        num_threads = _num_threads;
+    }
+
+    //Thread 'i' of 'n' gets IDs i+1, n+i+1, 2n+i+1, ...
+    int64_t global_ID(const int32_t ID) const override
+    {
+        if (num_threads == 1 || ID <= 0) return ID;
+        return ((int64_t)ID-1)*num_threads + thread_num + 1;
+    }
+
+    void imported(const int32_t ID, const vector<Lit>& cl, const int64_t from_ID) override
+    {
+        *this << add << ID << cl << DratFlag::chain;
+        byteDRUPaGlobalID(from_ID);
+        *this << fin;
+    }
+
+    void sync_point(const uint64_t at) override
+    {
+        if (binfrat) return;
+        uint32_t num = sprintf((char*)buf_ptr, "c sync %llu\n", (unsigned long long)at);
+        buf_ptr+=num;
+        buf_len+=num;
     }
 
     bool something_delayed() override
@@ -430,27 +579,33 @@ private:
     void byteDRUPaID(const int32_t id)
     {
         if (adding && cl_id == 0) cl_id = id;
+        byteDRUPaGlobalID(global_ID(id));
+    }
+
+    void byteDRUPaGlobalID(const int64_t id)
+    {
         if (binfrat) {
             for(unsigned i = 0; i < 6; i++) {
                 *buf_ptr++ = (id>>(8*i))&0xff;
                 buf_len++;
             }
         } else {
-            uint32_t num = sprintf((char*)buf_ptr, "%d ", id);
+            uint32_t num = sprintf((char*)buf_ptr, "%lld ", (long long)id);
             buf_ptr+=num;
             buf_len+=num;
         }
     }
 
-    void byteDRUPdID(const int32_t id)
+    void byteDRUPdID(const int32_t _id)
     {
+        const int64_t id = global_ID(_id);
         if (binfrat) {
             for(unsigned i = 0; i < 6; i++) {
                 *del_ptr++ = (id>>(8*i))&0xff;
                 del_len++;
             }
         } else {
-            uint32_t num = sprintf((char*)del_ptr, "%d ", id);
+            uint32_t num = sprintf((char*)del_ptr, "%lld ", (long long)id);
             del_ptr+=num;
             del_len+=num;
         }
@@ -478,9 +633,15 @@ private:
         }
     }
 
+    static constexpr size_t buf_size = 2 * 1024 * 1024;
     bool adding = false;
     int32_t cl_id = 0;
     FILE* drup_file = nullptr;
+    FratWriter* writer = nullptr;
+    const bool async;
+    const int compress;
+    uint32_t thread_num = 0;
+    uint32_t num_threads = 1;
     vector<uint32_t>& interToOuterMain;
     uint64_t* sumConflicts = nullptr;
     SQLStats* sqlStats = NULL;
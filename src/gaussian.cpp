@@ -287,45 +287,71 @@ bool EGaussian::full_init(bool& created) {
     uint32_t trail_before;
     while (true) {
         trail_before = solver->trail_size();
-        solver->clauseCleaner->clean_xor_clauses(xorclauses);
-
-        fill_matrix();
-        before_init_density = get_density();
-        if (num_rows == 0 || num_cols == 0) {
+        if (!init_fill()) {
             created = false;
             return solver->okay();
         }
-
         eliminate();
+        if (!init_adjust()) return false;
 
-        // find some row already true false, and insert watch list
-        gret ret = init_adjust_matrix();
+        //Let's exit if nothing new happened
+        if (solver->trail_size() == trail_before) break;
+    }
+    init_finish();
 
-        switch (ret) {
-            case gret::confl:
-                return false;
-                break;
-            case gret::prop:
-                assert(solver->decisionLevel() == 0);
-                solver->ok = solver->propagate<false>().isNULL();
-                if (!solver->ok) {
-                    if (solver->conf.verbosity >= 5) {
-                        cout << "c eliminate & adjust matrix during init lead to UNSAT" << endl;
-                    }
-                    return false;
-                }
-                break;
-            default:
-                break;
-        }
+    *solver->frat << __PRETTY_FUNCTION__ << " end\n";
+    return solver->okay();
+}
 
-        assert(solver->prop_at_head());
+bool EGaussian::in_matrix(const uint32_t var) const
+{
+    return var < var_to_col.size() && var_to_col[var] != unassigned_col;
+}
 
-        //Let's exit if nothing new happened
-        if (solver->trail_size() == trail_before) break;
+//Returns FALSE if the matrix is empty
+bool EGaussian::init_fill()
+{
+    assert(solver->decisionLevel() == 0);
+    solver->clauseCleaner->clean_xor_clauses(xorclauses);
+
+    fill_matrix();
+    before_init_density = get_density();
+    return num_rows != 0 && num_cols != 0;
+}
+
+//Returns FALSE in case of UNSAT
+bool EGaussian::init_adjust()
+{
+    // find some row already true false, and insert watch list
+    gret ret = init_adjust_matrix();
+
+    switch (ret) {
+        case gret::confl:
+            return false;
+            break;
+        case gret::prop:
+            assert(solver->decisionLevel() == 0);
+            solver->ok = solver->propagate<false>().isNULL();
+            if (!solver->ok) {
+                if (solver->conf.verbosity >= 5) {
+                    cout << "c eliminate & adjust matrix during init lead to UNSAT" << endl;
+                }
+                return false;
+            }
+            break;
+        default:
+            break;
     }
+
+    assert(solver->prop_at_head());
+    return true;
+}
+
+void EGaussian::init_finish()
+{
     SLOW_DEBUG_DO(check_watchlist_sanity());
-    verb_print(2, "c [gauss] initialised matrix " << matrix_no);
+    verb_print(2, "c [gauss] initialised matrix " << matrix_no
+        << " row kernels: " << packed_kernels.name);
 
     xor_reasons.resize(num_rows);
     uint32_t num_64b = num_cols/64+(bool)(num_cols%64);
@@ -363,9 +389,6 @@ bool EGaussian::full_init(bool& created) {
     initialized = true;
     update_cols_vals_set(true);
     SLOW_DEBUG_DO(check_invariants());
-
-    *solver->frat << __PRETTY_FUNCTION__ << " end\n";
-    return solver->okay();
 }
 
 #ifdef USE_TBUDDY
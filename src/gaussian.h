@@ -94,6 +94,14 @@ class EGaussian {
     );
     void canceling();
     bool full_init(bool& created);
+
+    //full_init() in steps, so that the eliminations of independent matrices
+    //can run in parallel. Only eliminate() leaves the solver alone
+    bool init_fill();
+    void eliminate();
+    bool init_adjust();
+    void init_finish();
+    bool in_matrix(const uint32_t var) const;
     void update_cols_vals_set(bool force = false);
     void print_matrix_stats(uint32_t verbosity);
     bool must_disable(GaussQData& gqd);
@@ -101,6 +109,8 @@ class EGaussian {
     void update_matrix_no(uint32_t n);
     void check_watchlist_sanity();
     uint32_t get_matrix_no();
+    //Each row as its (sorted) vars and rhs, e.g. to compare two matrices
+    vector<pair<vector<uint32_t>, bool>> get_rows();
     void finalize_frat();
     void move_back_xor_clauses();
 
@@ -128,7 +138,6 @@ class EGaussian {
     uint32_t get_max_level(const GaussQData& gqd, const uint32_t row_n);
 
     //Initialisation
-    void eliminate();
     void fill_matrix();
     void select_columnorder();
     gret init_adjust_matrix(); // adjust matrix, include watch, check row is zero, etc.
@@ -239,6 +248,21 @@ inline double EGaussian::get_density()
     return (double)pop/(double)(num_rows*num_cols);
 }
 
+inline vector<pair<vector<uint32_t>, bool>> EGaussian::get_rows()
+{
+    vector<pair<vector<uint32_t>, bool>> ret;
+    for (uint32_t r = 0; r < num_rows; r++) {
+        PackedRow row = mat[r];
+        vector<uint32_t> vars;
+        for (uint32_t c = 0; c < num_cols; c++) {
+            if (row[c]) vars.push_back(col_to_var[c]);
+        }
+        std::sort(vars.begin(), vars.end());
+        ret.push_back(std::make_pair(vars, (bool)row.rhs()));
+    }
+    return ret;
+}
+
 inline void EGaussian::update_matrix_no(uint32_t n)
 {
     matrix_no = n;
@@ -621,7 +621,9 @@ PropResult HyperEngine::prop_normal_cl_with_ancestor_info(
     , PropBy& confl
 ) {
     //Blocked literal is satisfied, so clause is satisfied
-    if (value(i->getBlockedLit()) == l_True) {
+    if (value(i->getBlockedLit()) == l_True
+        || (i->hasSecondBlocker() && value(i->getSecondBlocker()) == l_True)
+    ) {
         *j++ = *i;
         return PROP_NOTHING;
     }
@@ -30,7 +30,9 @@ IN THE SOFTWARE.
 #include "cryptominisat.h"
 #include "solverconf.h"
 #include "solver.h"
+#include "datasync.h"
 #include <vector>
+#include <deque>
 #include <complex>
 #include <cassert>
 #include <string.h>
@@ -49,6 +51,98 @@ class SolverWrapper {
 
     ipasir2_state state;
 
+    // External callbacks, see ipasir2_set_*()
+    void* terminate_data = nullptr;
+    int (*terminate_cb)(void* data) = nullptr;
+    void* export_data = nullptr;
+    int32_t export_max_len = -1;
+    void (*export_cb)(void* data, int32_t const* clause) = nullptr;
+    void* import_data = nullptr;
+    void (*import_cb)(void* data) = nullptr;
+    void* fixed_data = nullptr;
+    void (*fixed_cb)(void* data, int32_t fixed) = nullptr;
+
+    std::vector<int32_t> export_clause;
+    // Clauses given through ipasir2_add() during the import callback, and
+    // whether they are redundant. Handed to the solver one by one.
+    std::deque<std::pair<std::vector<CMSat::Lit>, bool>> import_queue;
+    bool in_import = false;
+
+    void createSolver() {
+        solver = new CMSat::Solver(conf, &terminate);
+        updateCallbacks();
+    }
+
+    void updateCallbacks() {
+        if (solver == nullptr) {
+            return;
+        }
+        CMSat::ExternalCallbacks cbs;
+        cbs.data = this;
+        cbs.export_max_len = export_max_len;
+        if (terminate_cb) cbs.terminate = &SolverWrapper::terminateCallback;
+        if (export_cb) cbs.export_cl = &SolverWrapper::exportCallback;
+        if (import_cb) cbs.import_cl = &SolverWrapper::importCallback;
+        if (fixed_cb) cbs.fixed = &SolverWrapper::fixedCallback;
+        solver->set_external_callbacks(cbs);
+    }
+
+    static int32_t toIpasirLit(CMSat::Lit lit) {
+        return lit.sign() ? -(int32_t)(lit.var()+1) : (int32_t)(lit.var()+1);
+    }
+
+    static int terminateCallback(void* data) {
+        SolverWrapper* w = (SolverWrapper*)data;
+        return w->terminate_cb(w->terminate_data);
+    }
+
+    static void exportCallback(void* data, const std::vector<CMSat::Lit>& cl) {
+        SolverWrapper* w = (SolverWrapper*)data;
+        w->export_clause.clear();
+        for (CMSat::Lit lit : cl) {
+            w->export_clause.push_back(toIpasirLit(lit));
+        }
+        w->export_clause.push_back(0);
+        w->export_cb(w->export_data, w->export_clause.data());
+    }
+
+    static bool importCallback(void* data, std::vector<CMSat::Lit>& cl, bool& red) {
+        SolverWrapper* w = (SolverWrapper*)data;
+        if (w->import_queue.empty()) {
+            w->in_import = true;
+            w->import_cb(w->import_data);
+            w->in_import = false;
+        }
+        if (w->import_queue.empty()) {
+            return false;
+        }
+        cl.swap(w->import_queue.front().first);
+        red = w->import_queue.front().second;
+        w->import_queue.pop_front();
+        return true;
+    }
+
+    static void fixedCallback(void* data, const CMSat::Lit lit) {
+        SolverWrapper* w = (SolverWrapper*)data;
+        w->fixed_cb(w->fixed_data, toIpasirLit(lit));
+    }
+
+    // Irredundant imported clauses that could not be added during search
+    bool addDeferredClauses() {
+        std::vector<std::vector<CMSat::Lit>>& deferred = solver->datasync->get_deferred_ext_clauses();
+        if (deferred.empty()) {
+            return false;
+        }
+        for (const std::vector<CMSat::Lit>& cl : deferred) {
+            for (CMSat::Lit lit : cl) {
+                createVarIfNotExists(toIpasirLit(lit));
+            }
+            solver->add_clause_outside(cl);
+        }
+        deferred.clear();
+        return true;
+    }
+
     void createVarIfNotExists(int32_t lit) {
         if (abs(lit) > solver->nVars()) {
             solver->new_vars(abs(lit) - solver->nVars());
@@ -80,12 +174,47 @@ public:
         return state;
     }
 
+    void setTerminate(void* data, int (*callback)(void* data)) {
+        terminate_data = data;
+        terminate_cb = callback;
+        updateCallbacks();
+    }
+
+    void setExport(void* data, int32_t max_length, void (*callback)(void* data, int32_t const* clause)) {
+        export_data = data;
+        export_max_len = max_length;
+        export_cb = callback;
+        updateCallbacks();
+    }
+
+    void setImport(void* data, void (*callback)(void* data)) {
+        import_data = data;
+        import_cb = callback;
+        updateCallbacks();
+    }
+
+    void setFixed(void* data, void (*callback)(void* data, int32_t fixed)) {
+        fixed_data = data;
+        fixed_cb = callback;
+        updateCallbacks();
+    }
+
+    // Called through ipasir2_add() from inside the import callback
+    void import(int32_t const* lits, int32_t len, int32_t forgettable) {
+        assert(in_import);
+        std::vector<CMSat::Lit> cl;
+        for (int32_t i = 0; i < len; i++) {
+            cl.push_back(toCMSatLit(lits[i]));
+        }
+        import_queue.emplace_back(std::move(cl), forgettable);
+    }
+
     void add(int32_t lit) {
         if (state == IPASIR2_S_UNSAT) {
             std::fill(is_failed_assumption.begin(), is_failed_assumption.end(), 0);
         }
         else if (solver == nullptr) {
-            solver = new CMSat::Solver(conf, &terminate);
+            createSolver();
         }
         state = IPASIR2_S_INPUT;
         createVarIfNotExists(lit);
@@ -103,7 +232,7 @@ public:
             std::fill(is_failed_assumption.begin(), is_failed_assumption.end(), 0);
         }
         else if (solver == nullptr) {
-            solver = new CMSat::Solver(conf, &terminate);
+            createSolver();
         }
         state = IPASIR2_S_INPUT;
         createVarIfNotExists(lit);
@@ -112,10 +241,16 @@ public:
 
     int solve() {
         if (solver == nullptr) {
-            solver = new CMSat::Solver(conf, &terminate);
-            state = IPASIR2_S_SOLVING;
+            createSolver();
         }
+        state = IPASIR2_S_SOLVING;
+        terminate.store(false);
         CMSat::lbool ret = solver->solve_with_assumptions(&assumptions);
+        while (ret == CMSat::l_True && addDeferredClauses()) {
+            // The model may violate the just-added imported clauses
+            terminate.store(false);
+            ret = solver->solve_with_assumptions(&assumptions);
+        }
         assumptions.clear();
         std::fill(is_failed_assumption.begin(), is_failed_assumption.end(), 0);
 
@@ -128,10 +263,12 @@ public:
                 is_failed_assumption[failed.toInt()] = 1;
             }
             state = IPASIR2_S_UNSAT;
+            addDeferredClauses();
             return 20;
         }
         else if (ret == CMSat::l_Undef) {
             state = IPASIR2_S_INPUT;
+            addDeferredClauses();
             return 0;
         }
         return -1;
@@ -260,6 +397,10 @@ extern "C" {
     }
 
     ipasir2_errorcode ipasir2_add(void* solver, int32_t const* clause, int32_t len, int32_t forgettable) {
+        if (((SolverWrapper*)solver)->getState() == IPASIR2_S_SOLVING) {
+            ((SolverWrapper*)solver)->import(clause, len, forgettable);
+            return IPASIR2_E_OK;
+        }
         for (int i = 0; i < len; i++) {
             ((SolverWrapper*)solver)->add(clause[i]);
         }
@@ -290,20 +431,24 @@ extern "C" {
 
     ipasir2_errorcode ipasir2_set_terminate(void* solver, void* state, 
             int (*callback)(void* state)) {
-        return IPASIR2_E_UNSUPPORTED;
+        ((SolverWrapper*)solver)->setTerminate(state, callback);
+        return IPASIR2_E_OK;
     }
 
     ipasir2_errorcode ipasir2_set_export(void* solver, void* state, int32_t max_length,
             void (*callback)(void* state, int32_t const* clause)) {
-        return IPASIR2_E_UNSUPPORTED;
+        ((SolverWrapper*)solver)->setExport(state, max_length, callback);
+        return IPASIR2_E_OK;
     }
 
     ipasir2_errorcode ipasir2_set_import(void* solver, void* data, void (*callback)(void* data)) {
-        return IPASIR2_E_UNSUPPORTED;
+        ((SolverWrapper*)solver)->setImport(data, callback);
+        return IPASIR2_E_OK;
     }
 
     ipasir2_errorcode ipasir2_set_fixed(void* solver, void* data, void (*callback)(void* data, int32_t fixed)) {
-        return IPASIR2_E_UNSUPPORTED;
+        ((SolverWrapper*)solver)->setFixed(data, callback);
+        return IPASIR2_E_OK;
     }
 
 }
@@ -51,6 +51,7 @@ THE SOFTWARE.
 #include "main_common.h"
 #include "time_mem.h"
 #include "dimacsparser.h"
+#include "mmapdimacsparser.h"
 #include "cryptominisat.h"
 #include "signalcode.h"
 
@@ -100,29 +101,49 @@ void Main::readInAFile(SATSolver* solver2, const string& filename)
     if (conf.verbosity) {
         cout << "c Reading file '" << filename << "'" << endl;
     }
-    #ifndef USE_ZLIB
-    FILE * in = fopen(filename.c_str(), "rb");
-    DimacsParser<StreamBuffer<FILE*, FN>, SATSolver> parser(solver2, &debugLib, conf.verbosity);
-    #else
-    gzFile in = gzopen(filename.c_str(), "rb");
-    DimacsParser<StreamBuffer<gzFile, GZ>, SATSolver> parser(solver2, &debugLib, conf.verbosity);
-    #endif
+    const bool strict_header = false;
+    vector<uint32_t> parsed_sampling_vars;
 
-    if (in == NULL) {
-        std::cerr
-        << "ERROR! Could not open file '"
-        << filename
-        << "' for reading: " << strerror(errno) << endl;
+    #ifndef _WIN32
+    MMapDimacsParser<SATSolver> mparser(solver2, &debugLib, conf.verbosity);
+    if (mmap_parse && mparser.map_file(filename)) {
+        if (!mparser.parse_DIMACS(strict_header)) {
+            exit(-1);
+        }
+        parsed_sampling_vars.swap(mparser.line_parser.sampling_vars);
+    } else
+    #endif
+    {
+        #ifndef USE_ZLIB
+        FILE * in = fopen(filename.c_str(), "rb");
+        DimacsParser<StreamBuffer<FILE*, FN>, SATSolver> parser(solver2, &debugLib, conf.verbosity);
+        #else
+        gzFile in = gzopen(filename.c_str(), "rb");
+        DimacsParser<StreamBuffer<gzFile, GZ>, SATSolver> parser(solver2, &debugLib, conf.verbosity);
+        #endif
+
+        if (in == NULL) {
+            std::cerr
+            << "ERROR! Could not open file '"
+            << filename
+            << "' for reading: " << strerror(errno) << endl;
+
+            std::exit(1);
+        }
 
-        std::exit(1);
-    }
+        if (!parser.parse_DIMACS(in, strict_header)) {
+            exit(-1);
+        }
+        parsed_sampling_vars.swap(parser.sampling_vars);
 
-    bool strict_header = false;
-    if (!parser.parse_DIMACS(in, strict_header)) {
-        exit(-1);
+        #ifndef USE_ZLIB
+            fclose(in);
+        #else
+            gzclose(in);
+        #endif
     }
 
-    if (!sampling_vars_str.empty() && !parser.sampling_vars.empty()) {
+    if (!sampling_vars_str.empty() && !parsed_sampling_vars.empty()) {
         cerr << "ERROR! Sampling vars set in console but also in CNF." << endl;
         exit(-1);
     }
@@ -141,7 +162,7 @@ void Main::readInAFile(SATSolver* solver2, const string& filename)
                 ss.ignore();
         }
     } else {
-        sampling_vars.swap(parser.sampling_vars);
+        sampling_vars.swap(parsed_sampling_vars);
     }
 
     if (sampling_vars.empty()) {
@@ -171,12 +192,6 @@ void Main::readInAFile(SATSolver* solver2, const string& filename)
     }
 
     call_after_parse();
-
-    #ifndef USE_ZLIB
-        fclose(in);
-    #else
-        gzclose(in);
-    #endif
 }
 
 void Main::readInStandardInput(SATSolver* solver2)
@@ -349,7 +364,11 @@ void Main::add_supported_options()
     ("predloc", po::value(&conf.pred_conf_location)->default_value(conf.pred_conf_location)
         , "Directory where predictor_short.json, predictor_long.json, predictor_forever.json are")
     ("predtype", po::value(&conf.predictor_type)->default_value(conf.predictor_type)
-        , "Type of predictor. Supported: py, xgb, lgbm")
+        , "Type of predictor. Supported: py, xgb, lgbm, native")
+    ("predthreads", po::value(&conf.pred_threads)->default_value(conf.pred_threads)
+        , "Predict TIER2 on this many helper threads while search goes on. 0 = predict in the search thread. Not supported by the py predictor")
+    ("predapply", po::value(&conf.pred_apply_confl)->default_value(conf.pred_apply_confl)
+        , "With predthreads, move TIER2 clauses at the first restart this many conflicts after the prediction started, waiting for the helper threads if needed. The next DB reduction applies them in any case, so the run does not depend on thread timing")
     ("predtables", po::value(&conf.pred_tables)->default_value(conf.pred_tables)
         , "000 = normal for all, 111 = ancestor for all")
     ("predbestfeats", po::value(&conf.predict_best_feat_fname)->default_value(conf.predict_best_feat_fname)
@@ -499,6 +518,10 @@ void Main::add_supported_options()
     sls_options.add_options()
     ("sls", po::value(&conf.doSLS)->default_value(conf.doSLS)
         , "Run SLS during simplification")
+    ("slsasync", po::value(&conf.sls_async)->default_value(conf.sls_async)
+        , "Run SLS on a helper thread while CDCL search continues. Phases and bumps are picked up at the next restart")
+    ("slswalkers", po::value(&conf.sls_walkers)->default_value(conf.sls_walkers)
+        , "Run this many CCNR walkers with different seeds on their own threads, sharing the formula and their best assignment")
     ("slstype", po::value(&conf.which_sls)->default_value(conf.which_sls)
         , "Which SLS to run. Allowed values: walksat, yalsat, ccnr, ccnr_yalsat")
     ("slsmaxmem", po::value(&conf.sls_memoutMB)->default_value(conf.sls_memoutMB)
@@ -613,6 +636,8 @@ void Main::add_supported_options()
         , "Time-out in bogoprops M of strengthening of long clauses with long clauses, after computing occur")
     ("sublonggothrough", po::value(&conf.subsume_gothrough_multip)->default_value(conf.subsume_gothrough_multip)
         , "How many times go through subsume")
+    ("subsumethreads", po::value(&conf.subsume_threads)->default_value(conf.subsume_threads)
+        , "Find backward-subsumed and strengthened long clauses on this many threads. Modifications are still applied in order, so the result is deterministic")
     ;
 
     po::options_description bva_options("BVA options");
@@ -645,6 +670,8 @@ void Main::add_supported_options()
         , "Eliminate this ratio of free variables at most per variable elimination iteration")
     ("varelimcheckres", po::value(&conf.varelim_check_resolvent_subs)->default_value(conf.varelim_check_resolvent_subs)
         , "BVE should check whether resolvents subsume others and check for exact size increase")
+    ("varelimthreads", po::value(&conf.varelim_threads)->default_value(conf.varelim_threads)
+        , "Calculate the resolvents of vars that share no clause on this many threads. Eliminations are still committed in order, so the result is deterministic")
 
     ;
 
@@ -743,6 +770,16 @@ void Main::add_supported_options()
         , "Print restart status lines at least every N conflicts")
     ("dumpresult", po::value(&resultFilename)
         , "Write solution(s) to this file")
+    ("savesnap", po::value(&snapshot_save_fname)
+        , "Only simplify the problem, then write the simplified solver to this file")
+    ("loadsnap", po::value(&snapshot_load_fname)
+        , "Start from the simplified solver in this file. Input files, if given, are added on top of it")
+    ("checkpoint", po::value(&conf.checkpoint_fname)
+        , "Periodically write the solver and its search state to this file")
+    ("checkpointevery", po::value(&conf.checkpoint_every_secs)->default_value(conf.checkpoint_every_secs)
+        , "Write a checkpoint every this many seconds (wallclock)")
+    ("restore", po::value(&checkpoint_restore_fname)
+        , "Continue solving from the checkpoint in this file. Input files, if given, are added on top of it")
     ;
 
     po::options_description distillOptions("Distill options");
@@ -784,6 +821,12 @@ void Main::add_supported_options()
         , "Treat all 'renumber' strategies as 'must-renumber'")
     ("fullwatchconseveryn", po::value(&conf.full_watch_consolidate_every_n_confl)->default_value(conf.full_watch_consolidate_every_n_confl)
         , "Consolidate watchlists fully once every N conflicts. Scheduled during simplification rounds.")
+    ("clarena", po::value(&conf.clause_alloc_arena)->default_value(conf.clause_alloc_arena)
+        , "Reserve address space for long clauses a few times larger than needed and commit it on demand, so growing rarely copies")
+    ("hugepages", po::value(&conf.clause_alloc_hugepages)->default_value(conf.clause_alloc_hugepages)
+        , "Ask for transparent hugepages for the clause arena")
+    ("consorder", po::value(&conf.consolidate_order)->default_value(conf.consolidate_order)
+        , "Clause layout when consolidating. 0 = watchlist order, 1 = tier-0 learnt, irred, tier-1, tier-2 learnt, each in watchlist order")
     ;
 
     po::options_description miscOptions("Misc options");
@@ -804,6 +847,22 @@ void Main::add_supported_options()
     hiddenOptions.add_options()
     ("sync", po::value(&conf.sync_every_confl)->default_value(conf.sync_every_confl)
         , "Sync threads every N conflicts")
+    ("synclongglue", po::value(&conf.sync_long_max_glue)->default_value(conf.sync_long_max_glue)
+        , "Share learnt long clauses between threads if glue is at most this. 0 = don't share")
+    ("synclongsize", po::value(&conf.sync_long_max_size)->default_value(conf.sync_long_max_size)
+        , "Share learnt long clauses between threads if size is at most this")
+    ("split", po::value(&conf.split_search)->default_value(conf.split_search)
+        , "With multiple threads, split the search space into cubes via lookahead and solve them in parallel instead of running a portfolio")
+    ("splitcubes", po::value(&conf.split_cubes_per_thread)->default_value(conf.split_cubes_per_thread)
+        , "Initial number of cubes per thread in split mode")
+    ("splitconfl", po::value(&conf.split_cube_confl)->default_value(conf.split_cube_confl)
+        , "Conflicts spent on a cube in split mode before it is split further")
+    ("splitconflmult", po::value(&conf.split_cube_confl_mult)->default_value(conf.split_cube_confl_mult)
+        , "Multiply the conflict budget of a cube by this when it is split further")
+    ("splitcands", po::value(&conf.split_lookahead_cands)->default_value(conf.split_lookahead_cands)
+        , "Number of variables to look ahead on when choosing the split variable")
+    ("mmapparse", po::value(&mmap_parse)->default_value(mmap_parse)
+        , "Parse uncompressed CNF files by mmap-ing them and tokenising chunks in parallel")
     ("clearinter", po::value(&need_clean_exit)->default_value(0)
         , "Interrupt threads cleanly, all the time")
     ("zero-exit-status", po::bool_switch(&zero_exit_status)
@@ -814,6 +873,10 @@ void Main::add_supported_options()
         , "The maximum for scc search depth")
     ("simfrat", po::value(&conf.simulate_frat)->default_value(conf.simulate_frat)
         , "Simulate FRAT")
+    ("fratasync", po::value(&conf.frat_async)->default_value(conf.frat_async)
+        , "Write the FRAT file from a helper thread, so the solver only waits when the writer falls behind")
+    ("fratgz", po::value(&conf.frat_compress)->default_value(conf.frat_compress)
+        , "Gzip the FRAT file at this level (1-9). 0 = don't compress")
     ("sampling", po::value(&sampling_vars_str)->default_value(sampling_vars_str)
         , "Sampling vars, separated by comma")
     ("onlysampling", po::bool_switch(&only_sampling_solution)
@@ -852,6 +915,8 @@ void Main::add_supported_options()
         " matrices are discarded for reasons of efficiency")
     ("maxnummatrices", po::value(&conf.gaussconf.max_num_matrices)->default_value(conf.gaussconf.max_num_matrices)
         , "Maximum number of matrices to treat.")
+    ("gaussthreads", po::value(&conf.gaussconf.init_threads)->default_value(conf.gaussconf.init_threads)
+        , "Number of threads eliminating independent matrices in parallel during (re-)initialization")
     ("detachxor", po::value(&conf.xor_detach_reattach)->default_value(conf.xor_detach_reattach)
         , "Detach and reattach XORs")
     ("useallmatrixes", po::value(&conf.force_use_all_matrixes)->default_value(conf.force_use_all_matrixes)
@@ -1247,7 +1312,17 @@ int Main::solve()
 
     //Parse in DIMACS (maybe gzipped) files
     //solver->log_to_file("mydump.cnf");
-    parseInAllFiles(solver);
+    if (!snapshot_load_fname.empty()) {
+        solver->load_snapshot(snapshot_load_fname);
+    }
+    if (!checkpoint_restore_fname.empty()) {
+        solver->restore(checkpoint_restore_fname);
+    }
+    if ((snapshot_load_fname.empty() && checkpoint_restore_fname.empty())
+        || fileNamePresent
+    ) {
+        parseInAllFiles(solver);
+    }
     if (!assump_filename.empty()) {
         std::ifstream* tmp = new std::ifstream;
         tmp->open(assump_filename.c_str());
@@ -1263,6 +1338,18 @@ int Main::solve()
         delete tmp;
     }
 
+    if (!snapshot_save_fname.empty()) {
+        const lbool ret = solver->simplify(&assumps);
+        solver->save_snapshot(snapshot_save_fname);
+        if (conf.verbosity) {
+            cout << "c Snapshot written to " << snapshot_save_fname << endl;
+        }
+        if (ret == l_False) {
+            printResultFunc(&cout, false, ret);
+        }
+        return correctReturnValue(ret);
+    }
+
     lbool ret = multi_solutions();
     if (ret == l_Undef && conf.verbosity) {
         cout
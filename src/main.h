@@ -45,12 +45,13 @@ class Main: public MainCommon
         Main(int argc, char** argv);
         ~Main()
         {
+            //The solver finishes the (possibly gzip-ed) proof on deletion
+            delete solver;
+
             if (fratf) {
                 fflush(fratf);
                 fclose(fratf);
             }
-
-            delete solver;
         }
 
         void parseCommandLine();
@@ -101,7 +102,11 @@ class Main: public MainCommon
 
         //Config
         std::string resultFilename;
+        std::string snapshot_save_fname;
+        std::string snapshot_load_fname;
+        std::string checkpoint_restore_fname;
         std::string debugLib;
+        int mmap_parse = true;
         int printResult = true;
         string commandLine;
         uint32_t max_nr_of_solutions = 1;
@@ -0,0 +1,447 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#pragma once
+
+// DIMACS parser for large, uncompressed files. The file is mmap-ed and cut
+// into chunks on line boundaries. Chunks are tokenised in parallel into flat
+// integer buffers, then the buffers are fed to the solver in file order.
+// Clause and XOR ('x') lines are handled here; every other line ('p cnf',
+// 'c ind', 'c red', 'b', etc.) is handed, in order, to a regular
+// DimacsParser so their semantics stay exactly the same.
+//
+// POSIX only. Compressed input or anything that can't be mapped should go
+// through DimacsParser directly, see map_file().
+
+#ifndef _WIN32
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <thread>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "dimacsparser.h"
+#include "streambuffer.h"
+
+namespace CMSat {
+
+template <class S>
+class MMapDimacsParser
+{
+    public:
+        MMapDimacsParser(
+            S* solver, const std::string* debugLib, unsigned verbosity,
+            unsigned num_threads = 0);
+        ~MMapDimacsParser();
+        MMapDimacsParser(const MMapDimacsParser&) = delete;
+        MMapDimacsParser& operator=(const MMapDimacsParser&) = delete;
+
+        //Returns false if the file can't be mapped, or is gzip-ed. The
+        //caller should then use the streaming DimacsParser
+        bool map_file(const std::string& fname);
+        bool parse_DIMACS(const bool strict_header, uint32_t offset_vars = 0);
+
+        //Handles all non-clause lines. Its sampling_vars, max_var, etc. are
+        //the results/settings of the whole parse
+        DimacsParser<StreamBuffer<MemSpan, MS>, S> line_parser;
+
+    private:
+        static constexpr int32_t xor_marker = std::numeric_limits<int32_t>::min();
+        static constexpr int32_t other_marker = std::numeric_limits<int32_t>::min()+1;
+        static constexpr size_t chunk_size = 32ULL*1024ULL*1024ULL;
+
+        struct Chunk
+        {
+            size_t start;
+            size_t end;
+            vector<int32_t> toks; //clause lits + 0, xor_marker + lits + 0, or other_marker
+            vector<size_t> others; //where the lines of the other_markers start
+
+            //Parse error, reported once all lines before it have been fed
+            const char* err_msg = NULL;
+        };
+        void tokenise(Chunk& ch) const;
+        bool tokenise_ints(const char*& p, Chunk& ch) const;
+        bool feed(const Chunk& ch);
+        bool feed_other(size_t at);
+        bool must_flush_before(size_t at) const;
+        void flush_clauses();
+        bool check_var(uint32_t var);
+        size_t next_line_start(size_t at) const;
+
+        S* solver;
+        unsigned verbosity;
+        unsigned num_threads;
+
+        const char* data = NULL;
+        size_t size = 0;
+        int fd = -1;
+
+        size_t line = 0;
+        uint32_t nvars_known = 0;
+        vector<Lit> lits;
+        vector<uint32_t> vars;
+        vector<Lit> bulk; //clauses for add_clauses(), lit_Undef-separated
+        size_t norm_clauses_added = 0;
+        size_t xor_clauses_added = 0;
+};
+
+template<class S>
+MMapDimacsParser<S>::MMapDimacsParser(
+    S* _solver
+    , const std::string* _debugLib
+    , unsigned _verbosity
+    , unsigned _num_threads
+) :
+    line_parser(_solver, _debugLib, _verbosity)
+    , solver(_solver)
+    , verbosity(_verbosity)
+    , num_threads(_num_threads)
+{
+    if (num_threads == 0) {
+        num_threads = std::max(1U, std::min(16U, std::thread::hardware_concurrency()));
+    }
+}
+
+template<class S>
+MMapDimacsParser<S>::~MMapDimacsParser()
+{
+    if (data) munmap((void*)data, size);
+    if (fd != -1) close(fd);
+}
+
+template<class S>
+bool MMapDimacsParser<S>::map_file(const std::string& fname)
+{
+    fd = open(fname.c_str(), O_RDONLY);
+    if (fd == -1) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size < 2) {
+        close(fd);
+        fd = -1;
+        return false;
+    }
+    size = st.st_size;
+    void* m = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (m == MAP_FAILED) {
+        close(fd);
+        fd = -1;
+        return false;
+    }
+    data = (const char*)m;
+    madvise(m, size, MADV_SEQUENTIAL);
+    madvise(m, size, MADV_WILLNEED);
+
+    //gzip magic
+    if ((unsigned char)data[0] == 0x1f && (unsigned char)data[1] == 0x8b) {
+        munmap(m, size);
+        data = NULL;
+        close(fd);
+        fd = -1;
+        return false;
+    }
+
+    return true;
+}
+
+template<class S>
+size_t MMapDimacsParser<S>::next_line_start(size_t at) const
+{
+    if (at == 0 || at >= size) return std::min(at, size);
+    const void* nl = memchr(data + at - 1, '\n', size - at + 1);
+    if (nl == NULL) return size;
+    return (const char*)nl - data + 1;
+}
+
+//Finds the end of a run of digits, 16 bytes at a time where possible
+static inline const char* mmap_dimacs_scan_digits(const char* p, const char* file_end)
+{
+    #if defined(__SSE2__)
+    const __m128i bias = _mm_set1_epi8((char)('0' + 128));
+    const __m128i limit = _mm_set1_epi8((char)(-128 + 10));
+    while (p + 16 <= file_end) {
+        const __m128i v = _mm_loadu_si128((const __m128i*)p);
+        //(c - '0') as unsigned < 10, done with signed compares
+        const __m128i is_digit = _mm_cmplt_epi8(_mm_sub_epi8(v, bias), limit);
+        const uint32_t mask = (uint32_t)_mm_movemask_epi8(is_digit);
+        if (mask != 0xffff) return p + __builtin_ctz(~mask);
+        p += 16;
+    }
+    #endif
+    while (p < file_end && *p >= '0' && *p <= '9') p++;
+    return p;
+}
+
+//Reads the integers of a clause or XOR line, up to and including the 0 and
+//the end of the line. Same rules as DimacsParser: every number but the last
+//must be followed by a space
+template<class S>
+bool MMapDimacsParser<S>::tokenise_ints(const char*& p, Chunk& ch) const
+{
+    const char* end = data + size;
+    for (;;) {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) p++;
+        bool neg = false;
+        if (p < end && (*p == '-' || *p == '+')) {
+            neg = (*p == '-');
+            p++;
+        }
+        const char* digits_end = mmap_dimacs_scan_digits(p, end);
+        if (digits_end == p) {
+            ch.err_msg = "we expected a number";
+            return false;
+        }
+        if (digits_end - p > 10) {
+            ch.err_msg = "the variable number is to high";
+            return false;
+        }
+        uint64_t val = 0;
+        for(; p != digits_end; p++) val = val*10 + (uint64_t)(*p - '0');
+
+        if (val == 0) {
+            ch.toks.push_back(0);
+            while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) p++;
+            if (p < end && *p != '\n') {
+                ch.err_msg = "we expected an end of line character (\\n or \\r + \\n)";
+                return false;
+            }
+            if (p < end) p++;
+            return true;
+        }
+        if (val > (1ULL<<28)) {
+            ch.err_msg = "variable requested is far too large";
+            return false;
+        }
+        if (p >= end || *p != ' ') {
+            ch.err_msg = "after last element on the line must be 0";
+            return false;
+        }
+        ch.toks.push_back(neg ? -(int32_t)val : (int32_t)val);
+    }
+}
+
+template<class S>
+void MMapDimacsParser<S>::tokenise(Chunk& ch) const
+{
+    const char* p = data + ch.start;
+    const char* end = data + ch.end;
+    ch.toks.reserve((ch.end - ch.start)/4);
+    while (p < end) {
+        const char* line_start = p;
+        const size_t toks_at = ch.toks.size();
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) p++;
+        if (p == end) break;
+
+        const char c = *p;
+        bool ok = true;
+        if (c == '-' || (c >= '0' && c <= '9')) {
+            ok = tokenise_ints(p, ch);
+        } else if (c == 'x') {
+            p++;
+            ch.toks.push_back(xor_marker);
+            ok = tokenise_ints(p, ch);
+        } else {
+            ch.toks.push_back(other_marker);
+            ch.others.push_back(line_start - data);
+            const void* nl = memchr(p, '\n', end - p);
+            p = nl ? (const char*)nl + 1 : end;
+        }
+        if (!ok) {
+            ch.toks.resize(toks_at);
+            return;
+        }
+    }
+}
+
+template<class S>
+bool MMapDimacsParser<S>::check_var(const uint32_t var)
+{
+    line_parser.lineNum = line;
+    if (!line_parser.check_var(var)) return false;
+    nvars_known = solver->nVars();
+    return true;
+}
+
+template<class S>
+bool MMapDimacsParser<S>::feed_other(size_t at)
+{
+    if (must_flush_before(at)) flush_clauses();
+
+    const void* nl = memchr(data + at, '\n', size - at);
+    const size_t line_end = nl ? (const char*)nl - data + 1 : size;
+    line_parser.lineNum = line;
+    if (!line_parser.parse_DIMACS_more(MemSpan{data + at, data + line_end})) return false;
+    nvars_known = solver->nVars();
+    return true;
+}
+
+//Only the 'c Solver::...' debug commands (e.g. solve) act on the clauses
+//given so far. Everything else is order-independent, so the bulk is kept and
+//handed to add_clauses() in a few large batches
+template<class S>
+bool MMapDimacsParser<S>::must_flush_before(size_t at) const
+{
+    const char* p = data + at;
+    const char* end = data + size;
+    while (p < end && (*p == ' ' || *p == '\t')) p++;
+    if (p == end || *p != 'c') return false;
+    p++;
+    while (p < end && (*p == ' ' || *p == '\t')) p++;
+    return (size_t)(end - p) >= 8 && memcmp(p, "Solver::", 8) == 0;
+}
+
+template<class S>
+void MMapDimacsParser<S>::flush_clauses()
+{
+    if (bulk.empty()) return;
+    solver->add_clauses(bulk.data(), bulk.size());
+    bulk.clear();
+}
+
+template<class S>
+bool MMapDimacsParser<S>::feed(const Chunk& ch)
+{
+    const bool strict = line_parser.strict_header;
+    const uint32_t offset_vars = line_parser.offset_vars;
+    size_t at_other = 0;
+    size_t i = 0;
+    while (i < ch.toks.size()) {
+        const int32_t t = ch.toks[i];
+        if (t == other_marker) {
+            if (!feed_other(ch.others[at_other++])) return false;
+            i++;
+            line++;
+            continue;
+        }
+
+        const bool is_xor = (t == xor_marker);
+        if (is_xor) i++;
+        vector<Lit>& to = is_xor ? lits : bulk;
+        if (is_xor) lits.clear();
+        for(; ch.toks[i] != 0; i++) {
+            const int32_t parsed_lit = ch.toks[i];
+            const uint32_t var = std::abs(parsed_lit) - 1 + offset_vars;
+            if (strict || var >= nvars_known || var > line_parser.max_var) {
+                if (!check_var(var)) return false;
+            }
+            to.push_back(Lit(var, parsed_lit < 0));
+        }
+        i++;
+
+        if (!is_xor) {
+            bulk.push_back(lit_Undef);
+            norm_clauses_added++;
+            if (bulk.size() >= 1ULL<<20) flush_clauses();
+        } else if (!lits.empty()) {
+            bool rhs = true;
+            vars.clear();
+            for(const Lit lit: lits) {
+                vars.push_back(lit.var());
+                rhs ^= lit.sign();
+            }
+            solver->add_xor_clause(vars, rhs);
+            xor_clauses_added++;
+        }
+        line++;
+    }
+
+    if (ch.err_msg) {
+        flush_clauses();
+        std::cerr
+        << "PARSE ERROR! At line " << line+1
+        << " " << ch.err_msg
+        << line_parser.please_read_dimacs
+        << endl;
+        return false;
+    }
+    return true;
+}
+
+template<class S>
+bool MMapDimacsParser<S>::parse_DIMACS(
+    const bool strict_header,
+    uint32_t offset_vars)
+{
+    assert(data != NULL);
+    line_parser.debugLibPart = 1;
+    line_parser.strict_header = strict_header;
+    line_parser.offset_vars = offset_vars;
+    const uint32_t origNumVars = solver->nVars();
+    nvars_known = origNumVars;
+
+    //Chunks are tokenised a wave at a time, so memory use stays bounded
+    size_t at = 0;
+    vector<Chunk> chunks(num_threads);
+    while (at < size) {
+        size_t num = 0;
+        for(; num < num_threads && at < size; num++) {
+            Chunk& ch = chunks[num];
+            ch = Chunk();
+            ch.start = at;
+            ch.end = next_line_start(std::min(size, at + chunk_size));
+            at = ch.end;
+        }
+
+        if (num == 1) {
+            tokenise(chunks[0]);
+        } else {
+            vector<std::thread> thds;
+            for(size_t i = 0; i < num; i++) {
+                thds.push_back(std::thread([this, &chunks, i]() { tokenise(chunks[i]); }));
+            }
+            for(std::thread& t: thds) t.join();
+        }
+
+        for(size_t i = 0; i < num; i++) {
+            if (!feed(chunks[i])) return false;
+        }
+    }
+    flush_clauses();
+
+    if (verbosity) {
+        cout
+        << "c -- clauses added: " << norm_clauses_added + line_parser.norm_clauses_added << endl
+        << "c -- xor clauses added: " << xor_clauses_added + line_parser.xor_clauses_added << endl
+        #ifdef ENABLE_BNN
+        << "c -- bnn clauses added: " << line_parser.bnn_clauses_added << endl
+        #endif
+        << "c -- vars added " << (solver->nVars() - origNumVars)
+        << endl;
+    }
+
+    return true;
+}
+
+}
+
+#endif //_WIN32
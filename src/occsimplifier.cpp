@@ -34,6 +34,7 @@ THE SOFTWARE.
 #include <limits>
 #include <cmath>
 #include <functional>
+#include <thread>
 
 #include "popcnt.h"
 #include "occsimplifier.h"
@@ -149,6 +150,41 @@ void OccSimplifier::save_on_var_memory()
     elimedClauses.shrink_to_fit();
 }
 
+void OccSimplifier::save_snapshot(SimpleOutFile& f) const
+{
+    f.put_vector(eClsLits);
+    f.put_uint64_t(elimedClauses.size());
+    for(const auto& elimed: elimedClauses) {
+        elimed.save_to_file(f);
+    }
+    f.put_uint64_t(bvestats_global.numVarsElimed);
+}
+
+void OccSimplifier::load_snapshot(SimpleInFile& f)
+{
+    eClsLits.clear();
+    f.get_vector(eClsLits);
+    const uint32_t n = solver->nVarsOuter();
+    for(const Lit l: eClsLits) {
+        //lit_Undef separates the clauses
+        if (l != lit_Undef) f.check_var(l.var(), n);
+    }
+
+    const uint64_t num = f.get_uint64_t();
+    if (num > eClsLits.size()) f.corrupt();
+    elimedClauses.resize(num);
+    for(auto& elimed: elimedClauses) {
+        elimed.load_from_file(f);
+        if (elimed.start >= elimed.end || elimed.end > eClsLits.size()) {
+            f.corrupt();
+        }
+        f.check_var(elimed.at(0, eClsLits).var(), n);
+    }
+    bvestats_global.numVarsElimed = f.get_uint64_t();
+    if (bvestats_global.numVarsElimed > n) f.corrupt();
+    elimedMapBuilt = false;
+}
+
 void OccSimplifier::print_elimed_clauses_reverse() const
 {
     for(vector<ElimedClauses>::const_reverse_iterator
@@ -1252,6 +1288,14 @@ bool OccSimplifier::eliminate_vars()
             ) {
                 assert(solver->prop_at_head());
                 assert(limit_to_decrease == &norm_varelim_time_limit);
+                if (solver->conf.varelim_threads > 1
+                    && !solver->conf.varelim_check_resolvent_subs
+                ) {
+                    if (!eliminate_vars_parallel(vars_elimed, last_elimed, wenThrough)) {
+                        goto end;
+                    }
+                    continue;
+                }
                 uint32_t var = velim_order.removeMin();
 
                 //Stats
@@ -2233,6 +2277,7 @@ bool OccSimplifier::execute_simplifier_strategy(const string& strategy)
             *solver->frat << __PRETTY_FUNCTION__ << " Executing OCC strategy token:" << token.c_str() << "\n";
         }
 
+        const Solver::PhaseMark mark = solver->phase_start();
         if (token == "occ-backw-sub-str") {
             backward_sub_str();
         } else if (token == "occ-backw-sub") {
@@ -2335,6 +2380,7 @@ bool OccSimplifier::execute_simplifier_strategy(const string& strategy)
              cout << "ERROR: occur strategy '" << token << "' not recognised!" << endl;
             exit(-1);
         }
+        if (token != "") solver->phase_end(token.c_str(), mark);
 
         #ifdef CHECK_N_OCCUR
         check_n_occur();
@@ -4511,6 +4557,11 @@ bool OccSimplifier::test_elim_and_fill_resolvents(const uint32_t var)
         cout << endl;
     }
 
+    //Resolution without gates was already tried (in parallel BVE), over the limit
+    if (!gates && skip_plain_resolution) {
+        return false;
+    }
+
     std::sort(gates_poss.begin(), gates_poss.end(), sort_smallest_first(solver->cl_alloc));
     std::sort(gates_negs.begin(), gates_negs.end(), sort_smallest_first(solver->cl_alloc));
     //TODO We could just filter negs, poss below
@@ -4896,7 +4947,14 @@ bool OccSimplifier::maybe_eliminate(const uint32_t var)
     if (solver->value(var) != l_Undef || !solver->okay()) return false;
     if (!test_elim_and_fill_resolvents(var) || *limit_to_decrease < 0) return false;  //didn't eliminate :( }
     bvestats.triedToElimVars++;
+    elim_var_with_resolvents(var);
+
+    return true; //eliminated!
+}
 
+void OccSimplifier::elim_var_with_resolvents(const uint32_t var)
+{
+    const Lit lit = Lit(var, false);
     print_var_eliminate_stat(lit);
 
     //Remove clauses
@@ -4909,15 +4967,433 @@ bool OccSimplifier::maybe_eliminate(const uint32_t var)
         if (!add_varelim_resolvent(resolvents.back_lits(),
             resolvents.back_stats(), resolvents.back_xor())
         ) {
-            goto end;
+            break;
         }
         resolvents.pop();
     }
-
-end:
     set_var_as_eliminated(var);
+}
 
-    return true; //eliminated!
+bool OccSimplifier::eliminate_vars_parallel(
+    size_t& vars_elimed,
+    int64_t& last_elimed,
+    size_t& wenThrough)
+{
+    pick_independent_vars(wenThrough);
+    calc_resolvents_parallel();
+    for(const BVECandidate& c: bve_cands) {
+        bve_var_taken[c.var] = 0;
+    }
+
+    //Commit in heap order. The candidates share no clauses, so the
+    //resolvents of one stay valid while the others are eliminated, unless
+    //a unit got propagated
+    const size_t trail_at = solver->trail_size();
+    size_t trail_cleaned = trail_at;
+    for(uint32_t i = 0; i < bve_cands.size(); i++) {
+        BVECandidate& c = bve_cands[i];
+        if (solver->trail_size() != trail_cleaned) {
+            trail_cleaned = solver->trail_size();
+            if (!clear_vars_from_cls_that_have_been_set()) return false;
+        }
+        if (!can_eliminate_var(c.var)) continue;
+        if (*limit_to_decrease <= 0
+            || varelim_num_limit <= 0
+            || varelim_linkin_limit_bytes <= 0
+            || solver->must_interrupt_asap()
+        ) {
+            velim_order.insert(c.var);
+            continue;
+        }
+
+        bool elimed;
+        const bool still_valid = (solver->trail_size() == trail_at);
+        if (still_valid) {
+            *limit_to_decrease -= c.cost;
+            weaken_time_limit -= c.weaken_cost;
+        }
+        if (c.ok && still_valid) {
+            print_var_elim_complexity_stats(c.var);
+            bvestats.testedToElimVars++;
+            bvestats.triedToElimVars++;
+            std::swap(resolvents, c.res);
+            elim_var_with_resolvents(c.var);
+            elimed = true;
+        } else {
+            //Gates may still make it work
+            skip_plain_resolution = still_valid;
+            elimed = maybe_eliminate(c.var);
+            skip_plain_resolution = false;
+        }
+        if (elimed) {
+            vars_elimed++;
+            varelim_num_limit--;
+            last_elimed++;
+        }
+        if (!solver->okay()) return false;
+        assert(solver->prop_at_head());
+    }
+
+    if (!clear_vars_from_cls_that_have_been_set()) return false;
+    if (!sub_str_with_added_long_and_bin(false)) return false;
+    assert(solver->okay());
+    assert(solver->prop_at_head());
+    update_varelim_complexity_heap();
+
+    return true;
+}
+
+void OccSimplifier::pick_independent_vars(size_t& wenThrough)
+{
+    //Not dependent on the number of threads, so the result is not either
+    const size_t max_cands = 512;
+    vector<uint32_t> picked;
+    vector<uint32_t> skipped;
+    vector<uint32_t> taken;
+    bve_var_taken.resize(solver->nVars(), 0);
+    const bool weaken = weaken_time_limit > 0;
+
+    while(!velim_order.empty()
+        && picked.size() < max_cands
+        && picked.size() + skipped.size() < 4*max_cands
+        && *limit_to_decrease > 0
+    ) {
+        const uint32_t var = velim_order.removeMin();
+        *limit_to_decrease -= 20;
+        if (!can_eliminate_var(var)) continue;
+
+        //Weakening also reads the binaries of the literals next to the var,
+        //and eliminating a picked var removes the ones it is in
+        if (bve_var_taken[var] || (weaken && bin_partner_picked(var))) {
+            skipped.push_back(var);
+            continue;
+        }
+        wenThrough++;
+
+        //Mark the var and all vars it shares a clause with
+        picked.push_back(var);
+        bve_var_taken[var] |= 2;
+        for(const Lit l: {Lit(var, false), Lit(var, true)}) {
+            *limit_to_decrease -= (long)solver->watches[l].size();
+            for(const Watched& w: solver->watches[l]) {
+                if (w.isBin()) {
+                    if (!bve_var_taken[w.lit2().var()]) taken.push_back(w.lit2().var());
+                    bve_var_taken[w.lit2().var()] |= 1;
+                    continue;
+                }
+                assert(w.isClause());
+                const Clause& cl = *solver->cl_alloc.ptr(w.get_offset());
+                if (cl.getRemoved()) continue;
+                *limit_to_decrease -= (long)cl.size()/2;
+                for(const Lit l2: cl) {
+                    if (!bve_var_taken[l2.var()]) taken.push_back(l2.var());
+                    bve_var_taken[l2.var()] |= 1;
+                }
+            }
+        }
+    }
+
+    //Only the picked marks are kept, for calc_resolvents_parallel()
+    for(const uint32_t v: taken) {
+        bve_var_taken[v] &= 2;
+    }
+
+    //Skipped ones go back, to be picked in the next batch
+    for(const uint32_t v: skipped) {
+        velim_order.insert(v);
+    }
+
+    bve_cands.resize(picked.size());
+    for(uint32_t i = 0; i < picked.size(); i++) {
+        bve_cands[i].var = picked[i];
+    }
+}
+
+//Whether a lit in a clause of 'var' has a binary with a picked var
+bool OccSimplifier::bin_partner_picked(const uint32_t var)
+{
+    for(const Lit l: {Lit(var, false), Lit(var, true)}) {
+        for(const Watched& w: solver->watches[l]) {
+            if (w.isBin()) {
+                *limit_to_decrease -= (long)solver->watches[w.lit2()].size();
+                for(const Watched& w2: solver->watches[w.lit2()]) {
+                    if (w2.isBin() && (bve_var_taken[w2.lit2().var()] & 2)) return true;
+                }
+                continue;
+            }
+            const Clause& cl = *solver->cl_alloc.ptr(w.get_offset());
+            if (cl.getRemoved()) continue;
+            for(const Lit l2: cl) {
+                if (l2.var() == var) continue;
+                *limit_to_decrease -= (long)solver->watches[l2].size();
+                for(const Watched& w2: solver->watches[l2]) {
+                    if (w2.isBin() && (bve_var_taken[w2.lit2().var()] & 2)) return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+void OccSimplifier::calc_resolvents_parallel()
+{
+    const uint32_t num_threads = std::min<size_t>(
+        solver->conf.varelim_threads, bve_cands.size());
+    if (bve_workers.size() < num_threads) {
+        bve_workers.resize(num_threads);
+    }
+    for(auto& d: bve_workers) {
+        d.seen.resize(solver->nVars()*2, 0);
+    }
+
+    //Same budget as the single-threaded overtime check
+    const int64_t budget = *limit_to_decrease + 10LL*1000LL;
+    const int64_t weaken_budget = weaken_time_limit;
+    auto work = [&](const uint32_t t) {
+        for(uint32_t i = t; i < bve_cands.size(); i += num_threads) {
+            calc_resolvents_no_gates(bve_cands[i], bve_workers[t], budget, weaken_budget);
+        }
+    };
+    vector<std::thread> thds;
+    for(uint32_t t = 1; t < num_threads; t++) {
+        thds.push_back(std::thread(work, t));
+    }
+    if (num_threads > 0) {
+        work(0);
+    }
+    for(auto& t: thds) {
+        t.join();
+    }
+}
+
+//Same as weaken(), but with the thread's own scratch and budget
+void OccSimplifier::weaken_no_gates(
+    const Lit lit,
+    const vector<Watched>& in,
+    vector<Lit>& out,
+    BVEWorkerData& d,
+    int64_t& budget) const
+{
+    out.clear();
+    uint32_t at = 0;
+    for(const auto& c: in) {
+        if (c.isBin()) {
+            out.push_back(lit);
+            out.push_back(c.lit2());
+            d.seen[c.lit2().toInt()] = 1;
+            d.to_clear.push_back(c.lit2());
+        } else {
+            assert(c.isClause());
+            const Clause* cl = solver->cl_alloc.ptr(c.get_offset());
+            for(auto const& l: *cl) {
+                if (l != lit) {
+                    d.seen[l.toInt()] = 1;
+                    d.to_clear.push_back(l);
+                }
+                out.push_back(l);
+            }
+        }
+        for(uint32_t i = at; i < out.size() && budget > 0; i++) {
+            const Lit l = out[i];
+            if (l == lit) continue;
+            budget -= 50;
+            budget -= solver->watches[l].size();
+            for(auto const& w: solver->watches[l]) {
+                if (!w.isBin() || w.red()) continue;
+                if (w.lit2().var() == lit.var()) continue;
+
+                //Gone once the picked var is eliminated
+                if (bve_var_taken[w.lit2().var()] & 2) continue;
+                if (d.seen[(~w.lit2()).toInt()] || d.seen[w.lit2().toInt()]) continue;
+                const Lit toadd = ~w.lit2();
+                out.push_back(toadd);
+                d.seen[toadd.toInt()] = 1;
+                d.to_clear.push_back(toadd);
+            }
+        }
+        out.push_back(lit_Undef);
+        for(auto const &l: d.to_clear) d.seen[l.toInt()] = 0;
+        d.to_clear.clear();
+        at = out.size();
+    }
+}
+
+//Resolvent of two clauses into d.dummy. Returns true if tautological
+bool OccSimplifier::resolve_no_gates(
+    const Watched& p,
+    const Watched& q,
+    const Lit lit,
+    BVEWorkerData& d,
+    int64_t& cost) const
+{
+    d.dummy.clear();
+    bool taut = false;
+    for(const Watched* w: {&p, &q}) {
+        const Lit skip = (w == &p) ? lit : ~lit;
+        if (w->isBin()) {
+            cost += 1;
+            const Lit l2 = w->lit2();
+            if (d.seen[(~l2).toInt()]) {
+                taut = true;
+            } else if (!d.seen[l2.toInt()]) {
+                d.seen[l2.toInt()] = 1;
+                d.dummy.push_back(l2);
+            }
+            continue;
+        }
+        const Clause& cl = *solver->cl_alloc.ptr(w->get_offset());
+        cost += (long)cl.size()/2;
+        for(const Lit l2: cl) {
+            if (l2 == skip) continue;
+            if (d.seen[(~l2).toInt()]) {
+                taut = true;
+                break;
+            }
+            if (!d.seen[l2.toInt()]) {
+                d.seen[l2.toInt()] = 1;
+                d.dummy.push_back(l2);
+            }
+        }
+        if (taut) break;
+    }
+    cost += (long)d.dummy.size()/2 + 1;
+    for(const Lit l2: d.dummy) {
+        d.seen[l2.toInt()] = 0;
+    }
+    return taut;
+}
+
+//Same as test_elim_and_fill_resolvents() without the gates. Thread-safe,
+//it only reads the occurrence lists
+void OccSimplifier::calc_resolvents_no_gates(
+    BVECandidate& c,
+    BVEWorkerData& d,
+    const int64_t budget,
+    const int64_t weaken_budget) const
+{
+    c.ok = false;
+    c.cost = 0;
+    c.weaken_cost = 0;
+    c.res.clear();
+    const Lit lit = Lit(c.var, false);
+    if (solver->value(lit) != l_Undef) return;
+
+    for(const Lit l: {lit, ~lit}) {
+        vector<Watched>& out = (l == lit) ? d.poss : d.negs;
+        out.clear();
+        for(const Watched& w: solver->watches[l]) {
+            if (solver->redundant_or_removed(w)) continue;
+            if (w.isBin() ? solver->value(w.lit2()) != l_Undef
+                : solver->satisfied(w.get_offset())
+            ) {
+                continue;
+            }
+            out.push_back(w);
+        }
+    }
+    const uint32_t pos = d.poss.size();
+    const uint32_t neg = d.negs.size();
+    if (pos == 0 || neg == 0) {
+        c.ok = true;
+        return;
+    }
+    if ((uint64_t)neg * (uint64_t)pos
+        >= solver->conf.varelim_cutoff_too_many_clauses
+    ) {
+        return;
+    }
+    std::sort(d.poss.begin(), d.poss.end(), sort_smallest_first(solver->cl_alloc));
+    std::sort(d.negs.begin(), d.negs.end(), sort_smallest_first(solver->cl_alloc));
+
+    const bool weakened = weaken_budget > 0;
+    if (weakened) {
+        int64_t left = weaken_budget;
+        weaken_no_gates(lit, d.poss, d.weak_poss, d, left);
+        weaken_no_gates(~lit, d.negs, d.weak_negs, d, left);
+        c.weaken_cost = weaken_budget - left;
+    }
+
+    const uint32_t limit = pos+neg+grow;
+    uint32_t weak_p_start = 0;
+    for(uint32_t pi = 0; pi < pos; pi++) {
+        const Watched& p = d.poss[pi];
+        uint32_t weak_p_end = weak_p_start;
+        if (weakened) {
+            while(d.weak_poss[weak_p_end] != lit_Undef) weak_p_end++;
+        }
+        c.cost += 3;
+
+        uint32_t weak_n_start = 0;
+        for(uint32_t ni = 0; ni < neg; ni++) {
+            const Watched& q = d.negs[ni];
+            c.cost += 3;
+            if (weakened) {
+                uint32_t weak_n_end = weak_n_start;
+                while(d.weak_negs[weak_n_end] != lit_Undef) weak_n_end++;
+
+                //Tautology and satisfied check on the weakened clauses
+                d.dummy.clear();
+                for(uint32_t x = weak_p_start; x < weak_p_end; x++) {
+                    const Lit l = d.weak_poss[x];
+                    if (l == lit) continue;
+                    d.seen[l.toInt()] = 1;
+                    d.dummy.push_back(l);
+                }
+                bool taut = false;
+                for(uint32_t x = weak_n_start; x < weak_n_end; x++) {
+                    const Lit l = d.weak_negs[x];
+                    if (l == ~lit) continue;
+                    if (d.seen[(~l).toInt()]) {
+                        taut = true;
+                        break;
+                    }
+                    if (!d.seen[l.toInt()]) {
+                        d.dummy.push_back(l);
+                        d.seen[l.toInt()] = 1;
+                    }
+                }
+                for(uint32_t x = weak_p_start; x < weak_p_end; x++) d.seen[d.weak_poss[x].toInt()] = 0;
+                for(uint32_t x = weak_n_start; x < weak_n_end; x++) d.seen[d.weak_negs[x].toInt()] = 0;
+                weak_n_start = weak_n_end+1;
+                if (taut || solver->satisfied(d.dummy)) continue;
+                if (resolve_no_gates(p, q, lit, d, c.cost)) continue;
+            } else {
+                if (resolve_no_gates(p, q, lit, d, c.cost)) continue;
+                if (solver->satisfied(d.dummy)) continue;
+            }
+
+            if (c.res.size()+1 > limit
+                || (solver->conf.velim_resolvent_too_large != -1
+                    && ((int)d.dummy.size() > solver->conf.velim_resolvent_too_large))
+                || c.cost > budget
+            ) {
+                return;
+            }
+
+            ClauseStats stats;
+            bool is_xor = false;
+            if (weakened) {
+                //Same as generate_resolvents_weakened()
+            } else if (p.isBin() && q.isClause()) {
+                const Clause* cl = solver->cl_alloc.ptr(q.get_offset());
+                stats = cl->stats;
+                is_xor |= cl->used_in_xor();
+            } else if (q.isBin() && p.isClause()) {
+                const Clause* cl = solver->cl_alloc.ptr(p.get_offset());
+                stats = cl->stats;
+                is_xor |= cl->used_in_xor();
+            } else if (q.isClause() && p.isClause()) {
+                const Clause* c1 = solver->cl_alloc.ptr(p.get_offset());
+                const Clause* c2 = solver->cl_alloc.ptr(q.get_offset());
+                stats = ClauseStats::combineStats(c1->stats, c2->stats);
+                is_xor |= c1->used_in_xor();
+                is_xor |= c2->used_in_xor();
+            }
+            c.res.add_resolvent(d.dummy, stats, is_xor);
+        }
+        weak_p_start = weak_p_end+1;
+    }
+    c.ok = true;
 }
 
 void OccSimplifier::add_pos_lits_to_dummy_and_seen(
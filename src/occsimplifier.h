@@ -304,6 +304,10 @@ public:
     //Ternary resolution. Should be private but testing needs it to be public
     bool ternary_res();
 
+    //Snapshots of the simplified solver
+    void save_snapshot(SimpleOutFile& f) const;
+    void load_snapshot(SimpleInFile& f);
+
 #ifdef ARJUN_SERIALIZE
     template<class T>
     void serialize_elimed_cls  (T& ar) const;
@@ -612,6 +616,44 @@ private:
         }
     };
     Resolvents resolvents;
+    void elim_var_with_resolvents(const uint32_t var);
+
+    //Parallel BVE. Vars that share no clause are picked from the heap and
+    //their resolvents are calculated on helper threads, then committed
+    //one-by-one, in heap order
+    struct BVEWorkerData {
+        vector<uint8_t> seen;
+        vector<Lit> dummy;
+        vector<Watched> poss;
+        vector<Watched> negs;
+        vector<Lit> weak_poss;
+        vector<Lit> weak_negs;
+        vector<Lit> to_clear;
+    };
+    struct BVECandidate {
+        uint32_t var;
+        bool ok; //resolvents are within limit
+        int64_t cost;
+        int64_t weaken_cost;
+        Resolvents res;
+    };
+    vector<BVEWorkerData> bve_workers;
+    vector<BVECandidate> bve_cands;
+    //Bit 0: shares a clause with a picked var, bit 1: picked. Picked bits
+    //stay set while the resolvents are calculated
+    vector<uint8_t> bve_var_taken;
+    bool skip_plain_resolution = false; //already known to be over the limit
+    bool eliminate_vars_parallel(size_t& vars_elimed, int64_t& last_elimed, size_t& wenThrough);
+    void pick_independent_vars(size_t& wenThrough);
+    bool bin_partner_picked(const uint32_t var);
+    void calc_resolvents_parallel();
+    void calc_resolvents_no_gates(BVECandidate& c, BVEWorkerData& d,
+        const int64_t budget, const int64_t weaken_budget) const;
+    bool resolve_no_gates(const Watched& p, const Watched& q, const Lit lit,
+        BVEWorkerData& d, int64_t& cost) const;
+    void weaken_no_gates(const Lit lit, const vector<Watched>& in,
+        vector<Lit>& out, BVEWorkerData& d, int64_t& budget) const;
+
     uint32_t calc_data_for_heuristic(const Lit lit);
     uint64_t time_spent_on_calc_otf_update;
     uint64_t num_otf_update_until_now;
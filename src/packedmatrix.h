@@ -38,42 +38,40 @@ THE SOFTWARE.
 
 namespace CMSat {
 
+// Rows are laid out as [rhs][numCols words of data], and the stride between
+// rows is padded to a whole number of cache lines. The base pointer is offset
+// by one word less than a cache line so that the data part of every row
+// starts on a 64B boundary: the XOR/AND/popcount sweeps in PackedRow then
+// never split a line.
 class PackedMatrix
 {
 public:
+    static const int row_align_words = 8; // 64B
+
     PackedMatrix() :
-        mp(NULL)
+        raw(NULL)
+        , mp(NULL)
         , numRows(0)
         , numCols(0)
+        , stride(0)
+        , capacity(0)
     {
     }
 
     ~PackedMatrix()
     {
-        #ifdef _WIN32
-        _aligned_free((void*)mp);
-        #else
-        free(mp);
-        #endif
+        free_raw();
     }
 
     void resize(const uint32_t num_rows, uint32_t num_cols)
     {
         num_cols = num_cols / 64 + (bool)(num_cols % 64);
-        if (numRows*(numCols+1) < (int)num_rows*((int)num_cols+1)) {
-            size_t size = sizeof(int64_t) * num_rows*(num_cols+1);
-            #ifdef _WIN32
-            _aligned_free((void*)mp);
-            mp =  (int64_t*)_aligned_malloc(size, 16);
-            #else
-            free(mp);
-            int ret = posix_memalign((void**)&mp, 16,  size);
-            release_assert(ret == 0);
-            #endif
-        }
+        const int new_stride = calc_stride(num_cols);
+        reserve((size_t)num_rows*new_stride);
 
         numRows = num_rows;
         numCols = num_cols;
+        stride = new_stride;
     }
 
     void resizeNumRows(const uint32_t num_rows)
@@ -84,20 +82,11 @@ public:
 
     PackedMatrix& operator=(const PackedMatrix& b)
     {
-        if (numRows*(numCols+1) < b.numRows*(b.numCols+1)) {
-            size_t size = sizeof(int64_t) * b.numRows*(b.numCols+1);
-            #ifdef _WIN32
-            _aligned_free((void*)mp);
-            mp =  (int64_t*)_aligned_malloc(size, 16);
-            #else
-            free(mp);
-            int ret = posix_memalign((void**)&mp, 16,  size);
-            release_assert(ret == 0);
-            #endif
-        }
+        reserve((size_t)b.numRows*b.stride);
         numRows = b.numRows;
         numCols = b.numCols;
-        memcpy(mp, b.mp, sizeof(int)*numRows*(numCols+1));
+        stride = b.stride;
+        memcpy(mp, b.mp, sizeof(int64_t)*(size_t)numRows*stride);
 
         return *this;
     }
@@ -108,7 +97,7 @@ public:
         assert(i <= numRows);
         #endif
 
-        return PackedRow(numCols, mp+i*(numCols+1));
+        return PackedRow(numCols, mp+(size_t)i*stride);
 
     }
 
@@ -118,7 +107,7 @@ public:
         assert(i <= numRows);
         #endif
 
-        return PackedRow(numCols, mp+i*(numCols+1));
+        return PackedRow(numCols, mp+(size_t)i*stride);
     }
 
     class iterator
@@ -133,25 +122,25 @@ public:
 
         iterator& operator++()
         {
-            mp += (numCols+1);
+            mp += stride;
             return *this;
         }
 
         iterator operator+(const uint32_t num) const
         {
             iterator ret(*this);
-            ret.mp += (numCols+1)*num;
+            ret.mp += (size_t)stride*num;
             return ret;
         }
 
         uint32_t operator-(const iterator& b) const
         {
-            return (mp - b.mp)/((numCols+1));
+            return (mp - b.mp)/stride;
         }
 
         void operator+=(const uint32_t num)
         {
-            mp += (numCols+1)*num;  // add by f4
+            mp += (size_t)stride*num;  // add by f4
         }
 
         bool operator!=(const iterator& it) const
@@ -165,23 +154,25 @@ public:
         }
 
     private:
-        iterator(int64_t* _mp, const uint32_t _numCols) :
+        iterator(int64_t* _mp, const uint32_t _numCols, const uint32_t _stride) :
             mp(_mp)
             , numCols(_numCols)
+            , stride(_stride)
         {}
 
         int64_t *mp;
         const uint32_t numCols;
+        const uint32_t stride;
     };
 
     inline iterator begin()
     {
-        return iterator(mp, numCols);
+        return iterator(mp, numCols, stride);
     }
 
     inline iterator end()
     {
-        return iterator(mp+numRows*(numCols+1), numCols);
+        return iterator(mp+(size_t)numRows*stride, numCols, stride);
     }
 
     inline uint32_t getSize() const
@@ -190,10 +181,48 @@ public:
     }
 
 private:
+    static int calc_stride(const int num_words)
+    {
+        // +1 for the RHS
+        return ((num_words + 1 + row_align_words - 1)/row_align_words)*row_align_words;
+    }
+
+    // Makes room for "words" words of row data, contents are NOT kept
+    void reserve(const size_t words)
+    {
+        if (words <= capacity) return;
+
+        free_raw();
+        const size_t size = sizeof(int64_t) * (words + row_align_words - 1);
+        #ifdef _WIN32
+        raw = (int64_t*)_aligned_malloc(size, 64);
+        release_assert(raw != NULL);
+        #else
+        int ret = posix_memalign((void**)&raw, 64,  size);
+        release_assert(ret == 0);
+        #endif
+        mp = raw + (row_align_words - 1);
+        capacity = words;
+    }
+
+    void free_raw()
+    {
+        #ifdef _WIN32
+        _aligned_free((void*)raw);
+        #else
+        free(raw);
+        #endif
+        raw = NULL;
+        mp = NULL;
+        capacity = 0;
+    }
 
-    int64_t *mp;
+    int64_t *raw; //what was allocated
+    int64_t *mp; //first row's RHS, data is at mp+1 and is 64B aligned
     int numRows;
     int numCols;
+    int stride; //in int64_t, multiple of row_align_words
+    size_t capacity; //in int64_t, not counting the alignment offset
 };
 
 }
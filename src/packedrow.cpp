@@ -29,6 +29,11 @@ THE SOFTWARE.
 
 #include "packedrow.h"
 
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define PACKEDROW_X86_SIMD
+#include <immintrin.h>
+#endif
+
 // #define VERBOSE_DEBUG
 // #define SLOW_DEBUG
 
@@ -50,6 +55,270 @@ inline int scan_fwd_64b(uint64_t value)
 }
 #endif
 
+//////////////////
+// Word-level kernels used by the PackedRow operations. Loads/stores are
+// unaligned since the temporary rows in EGaussian are plain new[]-ed, but
+// PackedMatrix aligns every row to 64B, so on the hot path these never split
+// a cache line.
+//////////////////
+
+static void xor_words_scalar(
+    int64_t* __restrict a, const int64_t* __restrict b, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++) a[i] ^= b[i];
+}
+
+static void and_inv_words_scalar(
+    int64_t* __restrict a, const int64_t* __restrict b, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++) a[i] &= ~b[i];
+}
+
+static void set_and_words_scalar(
+    int64_t* __restrict out, const int64_t* __restrict a,
+    const int64_t* __restrict b, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++) out[i] = a[i] & b[i];
+}
+
+static void set_and_inv_words_scalar(
+    int64_t* __restrict out, const int64_t* __restrict a,
+    const int64_t* __restrict b, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++) out[i] = a[i] & ~b[i];
+}
+
+static uint32_t set_and_popcnt_atleast2_scalar(
+    int64_t* __restrict out, const int64_t* __restrict a,
+    const int64_t* __restrict b, uint32_t n)
+{
+    uint32_t pop = 0;
+    for (uint32_t i = 0; i < n && pop < 2; i++) {
+        out[i] = a[i] & b[i];
+        pop += __builtin_popcountll((uint64_t)out[i]);
+    }
+    return pop;
+}
+
+#ifdef PACKEDROW_X86_SIMD
+
+// AVX2: 4 words per register, the popcount-until-2 scan goes in 64B blocks
+// (one cache line) and only counts bits when the block is non-zero.
+#define AVX2_TARGET __attribute__((target("avx2,popcnt")))
+
+AVX2_TARGET static void xor_words_avx2(
+    int64_t* __restrict a, const int64_t* __restrict b, uint32_t n)
+{
+    uint32_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i y = _mm256_loadu_si256((const __m256i*)(b + i));
+        _mm256_storeu_si256((__m256i*)(a + i), _mm256_xor_si256(x, y));
+    }
+    for (; i < n; i++) a[i] ^= b[i];
+}
+
+AVX2_TARGET static void and_inv_words_avx2(
+    int64_t* __restrict a, const int64_t* __restrict b, uint32_t n)
+{
+    uint32_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i y = _mm256_loadu_si256((const __m256i*)(b + i));
+        _mm256_storeu_si256((__m256i*)(a + i), _mm256_andnot_si256(y, x));
+    }
+    for (; i < n; i++) a[i] &= ~b[i];
+}
+
+AVX2_TARGET static void set_and_words_avx2(
+    int64_t* __restrict out, const int64_t* __restrict a,
+    const int64_t* __restrict b, uint32_t n)
+{
+    uint32_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i y = _mm256_loadu_si256((const __m256i*)(b + i));
+        _mm256_storeu_si256((__m256i*)(out + i), _mm256_and_si256(x, y));
+    }
+    for (; i < n; i++) out[i] = a[i] & b[i];
+}
+
+AVX2_TARGET static void set_and_inv_words_avx2(
+    int64_t* __restrict out, const int64_t* __restrict a,
+    const int64_t* __restrict b, uint32_t n)
+{
+    uint32_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i y = _mm256_loadu_si256((const __m256i*)(b + i));
+        _mm256_storeu_si256((__m256i*)(out + i), _mm256_andnot_si256(y, x));
+    }
+    for (; i < n; i++) out[i] = a[i] & ~b[i];
+}
+
+AVX2_TARGET static uint32_t set_and_popcnt_atleast2_avx2(
+    int64_t* __restrict out, const int64_t* __restrict a,
+    const int64_t* __restrict b, uint32_t n)
+{
+    uint32_t pop = 0;
+    uint32_t i = 0;
+    for (; i + 8 <= n && pop < 2; i += 8) {
+        __m256i x0 = _mm256_and_si256(
+            _mm256_loadu_si256((const __m256i*)(a + i)),
+            _mm256_loadu_si256((const __m256i*)(b + i)));
+        __m256i x1 = _mm256_and_si256(
+            _mm256_loadu_si256((const __m256i*)(a + i + 4)),
+            _mm256_loadu_si256((const __m256i*)(b + i + 4)));
+        _mm256_storeu_si256((__m256i*)(out + i), x0);
+        _mm256_storeu_si256((__m256i*)(out + i + 4), x1);
+        const __m256i any = _mm256_or_si256(x0, x1);
+        if (_mm256_testz_si256(any, any)) continue;
+        for (uint32_t j = i; j < i + 8; j++) {
+            pop += __builtin_popcountll((uint64_t)out[j]);
+        }
+    }
+    for (; i < n && pop < 2; i++) {
+        out[i] = a[i] & b[i];
+        pop += __builtin_popcountll((uint64_t)out[i]);
+    }
+    return pop;
+}
+
+// AVX-512F: one 64B block per register, the tail is done with masked
+// loads/stores so there is no scalar epilogue. The andnot is done in its
+// masked form, the plain _mm512_andnot_si512 trips -Wmaybe-uninitialized
+// in GCC 12 headers.
+#define AVX512_TARGET __attribute__((target("avx512f,popcnt")))
+
+static inline __mmask8 tail_mask(uint32_t left)
+{
+    return (__mmask8)((1U << left) - 1U);
+}
+
+AVX512_TARGET static void xor_words_avx512(
+    int64_t* __restrict a, const int64_t* __restrict b, uint32_t n)
+{
+    uint32_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512i x = _mm512_loadu_si512((const void*)(a + i));
+        __m512i y = _mm512_loadu_si512((const void*)(b + i));
+        _mm512_storeu_si512((void*)(a + i), _mm512_xor_si512(x, y));
+    }
+    if (i < n) {
+        const __mmask8 m = tail_mask(n - i);
+        __m512i x = _mm512_maskz_loadu_epi64(m, a + i);
+        __m512i y = _mm512_maskz_loadu_epi64(m, b + i);
+        _mm512_mask_storeu_epi64(a + i, m, _mm512_xor_si512(x, y));
+    }
+}
+
+AVX512_TARGET static void and_inv_words_avx512(
+    int64_t* __restrict a, const int64_t* __restrict b, uint32_t n)
+{
+    uint32_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512i x = _mm512_loadu_si512((const void*)(a + i));
+        __m512i y = _mm512_loadu_si512((const void*)(b + i));
+        _mm512_storeu_si512((void*)(a + i), _mm512_maskz_andnot_epi64(0xff, y, x));
+    }
+    if (i < n) {
+        const __mmask8 m = tail_mask(n - i);
+        __m512i x = _mm512_maskz_loadu_epi64(m, a + i);
+        __m512i y = _mm512_maskz_loadu_epi64(m, b + i);
+        _mm512_mask_storeu_epi64(a + i, m, _mm512_maskz_andnot_epi64(m, y, x));
+    }
+}
+
+AVX512_TARGET static void set_and_words_avx512(
+    int64_t* __restrict out, const int64_t* __restrict a,
+    const int64_t* __restrict b, uint32_t n)
+{
+    uint32_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512i x = _mm512_loadu_si512((const void*)(a + i));
+        __m512i y = _mm512_loadu_si512((const void*)(b + i));
+        _mm512_storeu_si512((void*)(out + i), _mm512_and_si512(x, y));
+    }
+    if (i < n) {
+        const __mmask8 m = tail_mask(n - i);
+        __m512i x = _mm512_maskz_loadu_epi64(m, a + i);
+        __m512i y = _mm512_maskz_loadu_epi64(m, b + i);
+        _mm512_mask_storeu_epi64(out + i, m, _mm512_and_si512(x, y));
+    }
+}
+
+AVX512_TARGET static void set_and_inv_words_avx512(
+    int64_t* __restrict out, const int64_t* __restrict a,
+    const int64_t* __restrict b, uint32_t n)
+{
+    uint32_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512i x = _mm512_loadu_si512((const void*)(a + i));
+        __m512i y = _mm512_loadu_si512((const void*)(b + i));
+        _mm512_storeu_si512((void*)(out + i), _mm512_maskz_andnot_epi64(0xff, y, x));
+    }
+    if (i < n) {
+        const __mmask8 m = tail_mask(n - i);
+        __m512i x = _mm512_maskz_loadu_epi64(m, a + i);
+        __m512i y = _mm512_maskz_loadu_epi64(m, b + i);
+        _mm512_mask_storeu_epi64(out + i, m, _mm512_maskz_andnot_epi64(m, y, x));
+    }
+}
+
+AVX512_TARGET static uint32_t set_and_popcnt_atleast2_avx512(
+    int64_t* __restrict out, const int64_t* __restrict a,
+    const int64_t* __restrict b, uint32_t n)
+{
+    uint32_t pop = 0;
+    for (uint32_t i = 0; i < n && pop < 2; i += 8) {
+        const __mmask8 m = (n - i >= 8) ? (__mmask8)0xff : tail_mask(n - i);
+        __m512i x = _mm512_maskz_loadu_epi64(m, a + i);
+        __m512i y = _mm512_maskz_loadu_epi64(m, b + i);
+        __m512i r = _mm512_and_si512(x, y);
+        _mm512_mask_storeu_epi64(out + i, m, r);
+        const __mmask8 nonzero = _mm512_test_epi64_mask(r, r);
+        if (!nonzero) continue;
+        for (uint32_t j = 0; j < 8; j++) {
+            if (nonzero & (1U << j)) {
+                pop += __builtin_popcountll((uint64_t)out[i + j]);
+            }
+        }
+    }
+    return pop;
+}
+#endif //PACKEDROW_X86_SIMD
+
+vector<PackedRowKernels> CMSat::all_packed_kernels()
+{
+    vector<PackedRowKernels> ret;
+    ret.push_back(PackedRowKernels{
+        xor_words_scalar, and_inv_words_scalar, set_and_words_scalar,
+        set_and_inv_words_scalar, set_and_popcnt_atleast2_scalar, "scalar"});
+
+    #ifdef PACKEDROW_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) {
+        ret.push_back(PackedRowKernels{
+            xor_words_avx2, and_inv_words_avx2, set_and_words_avx2,
+            set_and_inv_words_avx2, set_and_popcnt_atleast2_avx2, "avx2"});
+    }
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("popcnt")) {
+        ret.push_back(PackedRowKernels{
+            xor_words_avx512, and_inv_words_avx512, set_and_words_avx512,
+            set_and_inv_words_avx512, set_and_popcnt_atleast2_avx512, "avx512"});
+    }
+    #endif
+
+    return ret;
+}
+
+static PackedRowKernels select_packed_kernels()
+{
+    return all_packed_kernels().back();
+}
+
+PackedRowKernels CMSat::packed_kernels = select_packed_kernels();
+
 ///returns popcnt
 uint32_t PackedRow::find_watchVar(
     vector<Lit>& tmp_clause,
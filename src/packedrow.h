@@ -45,6 +45,28 @@ using std::vector;
 class PackedMatrix;
 class EGaussian;
 
+// Word-level kernels behind the row operations below. The table is filled in
+// once, at static init time, with the widest variant the CPU supports
+// (AVX-512, AVX2 or plain 64-bit), see packedrow.cpp. Rows shorter than
+// packed_simd_min_words stay on the inlined scalar loops, the indirect call
+// is not worth it for them.
+struct PackedRowKernels
+{
+    void (*xor_words)(int64_t* __restrict a, const int64_t* __restrict b, uint32_t n);
+    void (*and_inv_words)(int64_t* __restrict a, const int64_t* __restrict b, uint32_t n);
+    void (*set_and_words)(int64_t* __restrict out, const int64_t* __restrict a,
+                          const int64_t* __restrict b, uint32_t n);
+    void (*set_and_inv_words)(int64_t* __restrict out, const int64_t* __restrict a,
+                              const int64_t* __restrict b, uint32_t n);
+    uint32_t (*set_and_popcnt_atleast2)(int64_t* __restrict out, const int64_t* __restrict a,
+                                        const int64_t* __restrict b, uint32_t n);
+    const char* name;
+};
+extern PackedRowKernels packed_kernels;
+// Every variant the CPU can run, widest last. Used by the tests
+vector<PackedRowKernels> all_packed_kernels();
+static const int packed_simd_min_words = 8;
+
 /*
 
 See: https://stackoverflow.com/questions/1983303/using-bts-assembly-instruction-with-gcc-compiler
@@ -85,6 +107,12 @@ public:
         assert(b.size == size);
         #endif
 
+        if (size >= packed_simd_min_words) {
+            rhs_internal ^= b.rhs_internal;
+            packed_kernels.xor_words(mp, b.mp, size);
+            return *this;
+        }
+
         //start from -1, because that's wher RHS is
         for (int i = -1; i < size; i++) {
             *(mp + i) ^= *(b.mp + i);
@@ -101,6 +129,11 @@ public:
         assert(b.size == size);
         #endif
 
+        if (size >= packed_simd_min_words) {
+            packed_kernels.and_inv_words(mp, b.mp, size);
+            return;
+        }
+
         for (int i = 0; i < size; i++) {
             *(mp + i) &= ~(*(b.mp + i));
         }
@@ -114,6 +147,11 @@ public:
         assert(b.size == size);
         #endif
 
+        if (size >= packed_simd_min_words) {
+            packed_kernels.set_and_inv_words(mp, a.mp, b.mp, size);
+            return;
+        }
+
         for (int i = 0; i < size; i++) {
             *(mp + i) = *(a.mp + i) & (~(*(b.mp + i)));
         }
@@ -127,11 +165,19 @@ public:
         assert(b.size == size);
         #endif
 
+        if (size >= packed_simd_min_words) {
+            packed_kernels.set_and_words(mp, a.mp, b.mp, size);
+            return;
+        }
+
         for (int i = 0; i < size; i++) {
             *(mp + i) = *(a.mp + i) & *(b.mp + i);
         }
     }
 
+    // NOTE: stops early, words past the point where the popcount reached 2
+    //       may be stale. The return value is only meaningful as 0, 1 or
+    //       "at least 2" (the vectorised version checks per 64B block).
     uint32_t set_and_until_popcnt_atleast2(const PackedRow& a, const PackedRow& b)
     {
         #ifdef DEBUG_ROW
@@ -140,6 +186,10 @@ public:
         assert(b.size == size);
         #endif
 
+        if (size >= packed_simd_min_words) {
+            return packed_kernels.set_and_popcnt_atleast2(mp, a.mp, b.mp, size);
+        }
+
         uint32_t pop = 0;
         for (int i = 0; i < size && pop < 2; i++) {
             *(mp + i) = *(a.mp + i) & *(b.mp + i);
@@ -158,6 +208,11 @@ public:
         #endif
 
         rhs_internal ^= b.rhs_internal;
+        if (size >= packed_simd_min_words) {
+            packed_kernels.xor_words(mp, b.mp, size);
+            return;
+        }
+
         for (int i = 0; i < size; i++) {
             *(mp + i) ^= *(b.mp + i);
         }
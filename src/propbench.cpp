@@ -0,0 +1,495 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+// Propagation micro-benchmark. Loads a CNF (no simplification, no search),
+// then replays a decision sequence through Searcher::propagate() and
+// Searcher::cancelUntil(), and reports propagations per second. The sequence
+// is either generated from a seed or read from a trace file written by an
+// earlier run, so watch layout and allocator changes can be compared on the
+// exact same work.
+//
+// Trace format, one action per line:
+//   d <lit>    decide DIMACS literal <lit>, then propagate
+//   b <level>  backtrack to <level>
+//
+// Unit propagation reaches the same fixpoint (or finds a conflict) whatever
+// the order of the watches, so a trace stays valid across such changes.
+// Decisions that are already assigned on replay are counted and skipped.
+//
+// The library is built with PROP_WATCH_STATS alongside this binary, so the
+// watches visited are also reported by type. Those counters cost the same in
+// every PROPBENCH build, so A/B comparisons between such builds stay fair.
+
+#include <cstring>
+#include <cerrno>
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <atomic>
+#include <chrono>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "solver.h"
+#include "solverconf.h"
+#include "streambuffer.h"
+#include "MersenneTwister.h"
+#include "time_mem.h"
+
+using namespace CMSat;
+using std::cout;
+using std::cerr;
+using std::endl;
+using std::string;
+using std::vector;
+
+struct Action
+{
+    bool decide;
+    int32_t val; //DIMACS literal, or level
+};
+
+struct BenchConf
+{
+    string cnf_fname;
+    string trace_fname;
+    string save_fname;
+    uint64_t num_decisions = 100000;
+    uint32_t seed = 1;
+    uint32_t rounds = 3;
+    int verbosity = 0;
+};
+
+//Hardware counters, when the kernel lets us have them
+class PerfCounters
+{
+public:
+    PerfCounters()
+    {
+        #ifdef __linux__
+        open_one(0, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        open_one(1, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        open_one(2, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        open_one(3, PERF_TYPE_HW_CACHE,
+            PERF_COUNT_HW_CACHE_L1D
+            | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+            | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+        #endif
+    }
+
+    ~PerfCounters()
+    {
+        #ifdef __linux__
+        for(int fd: fds) if (fd != -1) close(fd);
+        #endif
+    }
+
+    static constexpr uint32_t num = 4;
+    static const char* name(uint32_t at)
+    {
+        static const char* names[num] =
+            {"cycles", "instructions", "cache-misses", "L1d-load-misses"};
+        return names[at];
+    }
+
+    bool available(uint32_t at) const { return fds[at] != -1; }
+    bool any_available() const
+    {
+        for(uint32_t i = 0; i < num; i++) if (available(i)) return true;
+        return false;
+    }
+
+    void start()
+    {
+        #ifdef __linux__
+        for(int fd: fds) {
+            if (fd == -1) continue;
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+        #endif
+    }
+
+    void stop()
+    {
+        #ifdef __linux__
+        for(uint32_t i = 0; i < num; i++) {
+            if (fds[i] == -1) continue;
+            ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0);
+            uint64_t val = 0;
+            if (read(fds[i], &val, sizeof(val)) == sizeof(val)) vals[i] += val;
+        }
+        #endif
+    }
+
+    uint64_t vals[num] = {0, 0, 0, 0};
+
+private:
+    int fds[num] = {-1, -1, -1, -1};
+
+    #ifdef __linux__
+    void open_one(uint32_t at, uint32_t type, uint64_t config)
+    {
+        struct perf_event_attr pe;
+        memset(&pe, 0, sizeof(pe));
+        pe.type = type;
+        pe.size = sizeof(pe);
+        pe.config = config;
+        pe.disabled = 1;
+        pe.exclude_kernel = 1;
+        pe.exclude_hv = 1;
+        fds[at] = syscall(__NR_perf_event_open, &pe, 0, -1, -1, 0);
+    }
+    #endif
+};
+
+#ifdef PROP_WATCH_STATS
+static void print_watch_line(const char* name, uint64_t val, uint64_t total)
+{
+    print_stats_line(string("c   ") + name, val
+        , stats_line_percent(val, total), "% of watches");
+}
+
+static void print_watch_breakdown(const PropStats& st)
+{
+    const uint64_t total = st.watchBin + st.watchBNN + st.watchBlocked
+        + st.watchBlocker2Sat + st.watchRead3 + st.watchReadIrred + st.watchReadRed;
+    cout << "c watches visited per round: " << total
+    << " (" << std::fixed << std::setprecision(2)
+    << ratio_for_stat(total, st.propagations) << " per prop)" << endl;
+    print_watch_line("binary", st.watchBin, total);
+    print_watch_line("BNN", st.watchBNN, total);
+    print_watch_line("long, blocker true", st.watchBlocked, total);
+    print_watch_line("3-long, blocker2 true", st.watchBlocker2Sat, total);
+    print_watch_line("3-long, clause read", st.watchRead3, total);
+    print_watch_line("long irred, clause read", st.watchReadIrred, total);
+    print_watch_line("long red, clause read", st.watchReadRed, total);
+}
+#endif
+
+static void print_usage(const char* prog)
+{
+    cout << "Usage: " << prog << " [options] <input-file> where input is plain DIMACS.\n";
+    cout << "Options:\n";
+    cout << "  --decisions=N  Decisions to generate (default 100000)\n";
+    cout << "  --seed=N       Seed of the generated decisions (default 1)\n";
+    cout << "  --trace=FILE   Replay this trace instead of generating one\n";
+    cout << "  --save=FILE    Write the trace used to FILE\n";
+    cout << "  --rounds=N     Timed replays of the trace (default 3)\n";
+    cout << "  --verb=N       Verbosity\n";
+    cout << "\n";
+}
+
+static const char* has_prefix(const char* str, const char* prefix)
+{
+    const size_t len = strlen(prefix);
+    if (strncmp(str, prefix, len) == 0) return str + len;
+    return NULL;
+}
+
+static bool parse_args(int argc, char** argv, BenchConf& bconf)
+{
+    for(int i = 1; i < argc; i++) {
+        const char* value;
+        if ((value = has_prefix(argv[i], "--decisions="))) {
+            bconf.num_decisions = strtoull(value, NULL, 10);
+        } else if ((value = has_prefix(argv[i], "--seed="))) {
+            bconf.seed = strtoul(value, NULL, 10);
+        } else if ((value = has_prefix(argv[i], "--trace="))) {
+            bconf.trace_fname = value;
+        } else if ((value = has_prefix(argv[i], "--save="))) {
+            bconf.save_fname = value;
+        } else if ((value = has_prefix(argv[i], "--rounds="))) {
+            bconf.rounds = strtoul(value, NULL, 10);
+        } else if ((value = has_prefix(argv[i], "--verb="))) {
+            bconf.verbosity = strtol(value, NULL, 10);
+        } else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            print_usage(argv[0]);
+            exit(0);
+        } else if (argv[i][0] == '-') {
+            cerr << "ERROR! unknown flag: " << argv[i] << endl;
+            return false;
+        } else if (bconf.cnf_fname.empty()) {
+            bconf.cnf_fname = argv[i];
+        } else {
+            cerr << "ERROR! more than one input file given" << endl;
+            return false;
+        }
+    }
+    if (bconf.cnf_fname.empty()) {
+        print_usage(argv[0]);
+        return false;
+    }
+    return true;
+}
+
+//Plain clauses only. XOR, BNN, etc. lines are not supported
+static bool read_cnf(Solver* s, const string& fname)
+{
+    FILE* in = fopen(fname.c_str(), "rb");
+    if (in == NULL) {
+        cerr << "ERROR! Could not open file: " << fname
+        << " reason: " << strerror(errno) << endl;
+        return false;
+    }
+
+    StreamBuffer<FILE*, FN> buf(in);
+    vector<Lit> lits;
+    size_t line_num = 0;
+    bool ok = true;
+    for(;;) {
+        buf.skipWhitespace();
+        const int c = *buf;
+        if (c == EOF) break;
+        if (c == 'p' || c == 'c' || c == '\n') {
+            buf.skipLine();
+            line_num++;
+            continue;
+        }
+        if (c != '-' && (c < '0' || c > '9')) {
+            cerr << "ERROR! Unsupported line " << line_num+1 << " starting with '"
+            << (char)c << "'" << endl;
+            ok = false;
+            break;
+        }
+
+        lits.clear();
+        int32_t parsed;
+        for(;;) {
+            if (!buf.parseInt(parsed, line_num)) {
+                ok = false;
+                break;
+            }
+            if (parsed == 0) break;
+            const uint32_t var = std::abs(parsed)-1;
+            if (var >= s->nVarsOutside()) {
+                s->new_vars(var+1-s->nVarsOutside());
+            }
+            lits.push_back(Lit(var, parsed < 0));
+        }
+        if (!ok) break;
+        buf.skipLine();
+        line_num++;
+        s->add_clause_outside(lits);
+    }
+    fclose(in);
+    return ok;
+}
+
+static bool read_trace(const string& fname, vector<Action>& trace)
+{
+    std::ifstream in(fname);
+    if (!in) {
+        cerr << "ERROR! Could not open trace file: " << fname << endl;
+        return false;
+    }
+    char type;
+    int32_t val;
+    while (in >> type >> val) {
+        if (type != 'd' && type != 'b') {
+            cerr << "ERROR! Trace file " << fname << " has unknown action '"
+            << type << "'" << endl;
+            return false;
+        }
+        trace.push_back(Action{type == 'd', val});
+    }
+    return true;
+}
+
+static bool write_trace(const string& fname, const vector<Action>& trace)
+{
+    std::ofstream out(fname);
+    if (!out) {
+        cerr << "ERROR! Could not open trace file for writing: " << fname << endl;
+        return false;
+    }
+    for(const Action& a: trace) out << (a.decide ? 'd' : 'b') << " " << a.val << "\n";
+    return (bool)out;
+}
+
+static Lit dimacs_to_inter(const Solver* s, int32_t dimacs_lit)
+{
+    const Lit outer(std::abs(dimacs_lit)-1, dimacs_lit < 0);
+    return s->map_outer_to_inter(outer);
+}
+
+//Random unassigned decision, propagate. Conflicts and full assignments
+//backtrack to a random, lower level
+static void generate_trace(Solver* s, const BenchConf& bconf, vector<Action>& trace)
+{
+    MTRand mtrand(bconf.seed);
+    const uint32_t nvars = s->nVars();
+    for(uint64_t i = 0; i < bconf.num_decisions; i++) {
+        if (s->trail_size() == nvars) {
+            trace.push_back(Action{false, 0});
+            s->cancelUntil(0);
+        }
+
+        uint32_t var = mtrand.randInt(nvars-1);
+        while (s->value(var) != l_Undef) {
+            var = (var+1 == nvars) ? 0 : var+1;
+        }
+        const Lit lit(var, mtrand.randInt(1));
+        const Lit outer = s->map_inter_to_outer(lit);
+        trace.push_back(Action{true, (int32_t)(outer.var()+1) * (outer.sign() ? -1 : 1)});
+
+        s->new_decision_level();
+        s->enqueue<false>(lit);
+        const PropBy confl = s->propagate<false>();
+        if (!confl.isNULL()) {
+            const uint32_t lev = mtrand.randInt(s->decisionLevel()-1);
+            trace.push_back(Action{false, (int32_t)lev});
+            s->cancelUntil(lev);
+        }
+    }
+    s->cancelUntil(0);
+}
+
+struct ReplayStats
+{
+    uint64_t decisions = 0;
+    uint64_t skipped = 0;
+    uint64_t conflicts = 0;
+};
+
+static ReplayStats replay(Solver* s, const vector<Action>& trace)
+{
+    ReplayStats stats;
+    for(const Action& a: trace) {
+        if (!a.decide) {
+            if ((uint32_t)a.val < s->decisionLevel()) s->cancelUntil(a.val);
+            continue;
+        }
+
+        const Lit lit = dimacs_to_inter(s, a.val);
+        if (s->value(lit) != l_Undef) {
+            stats.skipped++;
+            continue;
+        }
+        stats.decisions++;
+        s->new_decision_level();
+        s->enqueue<false>(lit);
+        const PropBy confl = s->propagate<false>();
+        if (!confl.isNULL()) stats.conflicts++;
+    }
+    s->cancelUntil(0);
+    return stats;
+}
+
+int main(int argc, char** argv)
+{
+    BenchConf bconf;
+    if (!parse_args(argc, argv, bconf)) return 1;
+
+    SolverConf conf;
+    conf.verbosity = bconf.verbosity;
+    std::atomic<bool> must_interrupt(false);
+    Solver s(&conf, &must_interrupt);
+
+    double my_time = cpuTime();
+    if (!read_cnf(&s, bconf.cnf_fname)) return 1;
+    cout << "c parsed " << s.nVars() << " vars, "
+    << s.longIrredCls.size() << " long and "
+    << s.binTri.irredBins << " binary clauses, T: "
+    << std::fixed << std::setprecision(2) << (cpuTime() - my_time) << endl;
+    if (!s.okay()) {
+        cout << "c CNF is UNSAT at decision level 0, nothing to propagate" << endl;
+        return 0;
+    }
+    if (s.nVars() == 0 || s.trail_size() == s.nVars()) {
+        cout << "c all variables are set at decision level 0, nothing to propagate" << endl;
+        return 0;
+    }
+
+    vector<Action> trace;
+    if (!bconf.trace_fname.empty()) {
+        if (!read_trace(bconf.trace_fname, trace)) return 1;
+    } else {
+        my_time = cpuTime();
+        generate_trace(&s, bconf, trace);
+        cout << "c generated " << bconf.num_decisions << " decisions with seed "
+        << bconf.seed << ", T: " << (cpuTime() - my_time) << endl;
+    }
+    if (!bconf.save_fname.empty()) {
+        if (!write_trace(bconf.save_fname, trace)) return 1;
+        cout << "c trace written to " << bconf.save_fname << endl;
+    }
+
+    PerfCounters perf;
+    ReplayStats stats;
+    PropStats round_stats;
+    double best_time = std::numeric_limits<double>::max();
+    double total_time = 0;
+    for(uint32_t r = 0; r < bconf.rounds; r++) {
+        const PropStats before = s.propStats;
+        const auto start = std::chrono::steady_clock::now();
+        perf.start();
+        stats = replay(&s, trace);
+        perf.stop();
+        const double t = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+        round_stats = s.propStats - before;
+        total_time += t;
+        best_time = std::min(best_time, t);
+        if (bconf.verbosity) {
+            cout << "c round " << r << " props: " << round_stats.propagations
+            << " T: " << std::setprecision(3) << t << endl;
+        }
+    }
+
+    cout << "c replayed " << stats.decisions << " decisions"
+    << " (" << stats.skipped << " skipped), "
+    << stats.conflicts << " conflicts, "
+    << round_stats.propagations << " props per round" << endl;
+    if (bconf.rounds > 0) {
+        const double total_props = (double)round_stats.propagations*bconf.rounds;
+        print_stats_line("c Mprops/s (best round)"
+            , ratio_for_stat(round_stats.propagations, best_time*1000.0*1000.0));
+        print_stats_line("c Mprops/s (all rounds)"
+            , ratio_for_stat(total_props, total_time*1000.0*1000.0));
+
+        if (perf.any_available()) {
+            for(uint32_t i = 0; i < PerfCounters::num; i++) {
+                if (!perf.available(i)) continue;
+                print_stats_line(string("c ") + PerfCounters::name(i)
+                    , perf.vals[i]
+                    , ratio_for_stat(perf.vals[i], total_props)
+                    , "per prop");
+            }
+        } else {
+            cout << "c hardware counters not available (perf_event_open failed)" << endl;
+        }
+    }
+
+    #ifdef PROP_WATCH_STATS
+    if (bconf.rounds > 0) print_watch_breakdown(round_stats);
+    #endif
+
+    return 0;
+}
@@ -37,6 +37,7 @@ THE SOFTWARE.
 #include "watchalgos.h"
 #include "sqlstats.h"
 #include "gaussian.h"
+#include "cycleprof.h"
 
 using namespace CMSat;
 using std::cout;
@@ -119,8 +120,8 @@ void PropEngine::attachClause(
     #endif //DEBUG_ATTACH
 
     const Lit blocked_lit = c[2];
-    watches[c[0]].push(Watched(offset, blocked_lit));
-    watches[c[1]].push(Watched(offset, blocked_lit));
+    watches[c[0]].push(clause_watch(c, offset, 0, blocked_lit));
+    watches[c[1]].push(clause_watch(c, offset, 1, blocked_lit));
 }
 
 /**
@@ -529,6 +530,17 @@ bool PropEngine::prop_long_cl_any_order(
 ) {
     //Blocked literal is satisfied, so clause is satisfied
     if (value(i->getBlockedLit()) == l_True) {
+        #ifdef PROP_WATCH_STATS
+        propStats.watchBlocked++;
+        #endif
+        *j++ = *i;
+        return true;
+    }
+    //Same for the second blocker of a 3-long clause
+    if (i->hasSecondBlocker() && value(i->getSecondBlocker()) == l_True) {
+        #ifdef PROP_WATCH_STATS
+        propStats.watchBlocker2Sat++;
+        #endif
         *j++ = *i;
         return true;
     }
@@ -537,6 +549,11 @@ bool PropEngine::prop_long_cl_any_order(
     }
     const ClOffset offset = i->get_offset();
     Clause& c = *cl_alloc.ptr(offset);
+    #ifdef PROP_WATCH_STATS
+    if (c.size() == 3) propStats.watchRead3++;
+    else if (c.red()) propStats.watchReadRed++;
+    else propStats.watchReadIrred++;
+    #endif
 
     #ifdef SLOW_DEBUG
     assert(!c.getRemoved());
@@ -593,7 +610,7 @@ bool PropEngine::prop_long_cl_any_order(
             if (nMaxInd != 1) {
                 std::swap(c[1], c[nMaxInd]);
                 j--; // undo last watch
-                watches[c[1]].push(*i);
+                watches[c[1]].push(clause_watch(c, offset, 1, c[0]));
             }
 
             enqueue<inprocess>(c[0], nMaxLevel, PropBy(offset));
@@ -644,6 +661,7 @@ void CMSat::PropEngine::reverse_prop(const CMSat::Lit l)
 template<bool inprocess, bool red_also, bool distill_use>
 PropBy PropEngine::propagate_any_order()
 {
+    CYCLE_PROF_SCOPE(prof_propagate);
     PropBy confl;
     VERBOSE_PRINT("propagate_any_order started");
 
@@ -664,6 +682,9 @@ PropBy PropEngine::propagate_any_order()
         for (; i != end; i++) {
             // propagate binary clause
             if (likely(i->isBin())) {
+                #ifdef PROP_WATCH_STATS
+                propStats.watchBin++;
+                #endif
                 *j++ = *i;
                 if (!red_also && i->red()) {
                     continue;
@@ -677,6 +698,9 @@ PropBy PropEngine::propagate_any_order()
 
             // propagate BNN constraint
             if (i->isBNN()) {
+                #ifdef PROP_WATCH_STATS
+                propStats.watchBNN++;
+                #endif
                 *j++ = *i;
                 const lbool val = bnn_prop(
                     i->get_bnn(), currLevel, p, i->get_bnn_prop_t());
@@ -696,7 +720,8 @@ PropBy PropEngine::propagate_any_order()
         VERBOSE_PRINT("prop went through watchlist of " << p);
 
         //distillation would need to generate TBDD proofs to simplify clauses with GJ
-        if (confl.isNULL() && !distill_use) {
+        if (confl.isNULL() && !distill_use && !gmatrices.empty()) {
+            CYCLE_PROF_SCOPE(prof_gauss);
             confl = gauss_jordan_elim(p, currLevel);
         }
 
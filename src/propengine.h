@@ -292,6 +292,12 @@ protected:
         const Clause& c
         , const bool checkAttach = true
     );
+    static Watched clause_watch(
+        const Clause& c
+        , const ClOffset offset
+        , const uint32_t at
+        , const Lit blocked
+    );
 
     void detach_bin_clause(
         Lit lit1
@@ -437,6 +443,32 @@ uint32_t PropEngine::calc_glue(const T& ps)
     return nblevels;
 }
 
+/**
+@brief Watch of clause c for the watchlist of c[at], where at is 0 or 1
+
+blocked must be another literal of c. With TERNARY_SECOND_BLOCKER, 3-long clauses
+also get their remaining literal as a second blocker, so a clause satisfied by
+either is skipped without being dereferenced.
+*/
+inline Watched PropEngine::clause_watch(
+    const Clause& c
+    , const ClOffset offset
+    , const uint32_t at
+    , const Lit blocked
+) {
+    #ifdef TERNARY_SECOND_BLOCKER
+    if (c.size() == 3) {
+        const Lit next = c[(at+1)%3];
+        const Lit other = (next == blocked) ? c[(at+2)%3] : next;
+        return Watched(offset, blocked, other);
+    }
+    #else
+    (void)c;
+    (void)at;
+    #endif
+    return Watched(offset, blocked);
+}
+
 template<bool inprocess>
 inline PropResult PropEngine::prop_normal_helper(
     Clause& c
@@ -453,7 +485,7 @@ inline PropResult PropEngine::prop_normal_helper(
 
     // If 0th watch is true, then clause is already satisfied.
     if (value(c[0]) == l_True) {
-        *j = Watched(offset, c[0]);
+        *j = clause_watch(c, offset, 1, c[0]);
         j++;
         return PROP_NOTHING;
     }
@@ -467,7 +499,7 @@ inline PropResult PropEngine::prop_normal_helper(
         if (value(*k) != l_False) {
             c[1] = *k;
             *k = ~p;
-            watches[c[1]].push(Watched(offset, c[0]));
+            watches[c[1]].push(clause_watch(c, offset, 1, c[0]));
             return PROP_NOTHING;
         }
     }
@@ -643,7 +675,9 @@ PropBy PropEngine::propagate_light()
             }
 
             if (!bin_only && i->isClause()) {
-                if (value(i->getBlockedLit()) == l_True) {
+                if (value(i->getBlockedLit()) == l_True
+                    || (i->hasSecondBlocker() && value(i->getSecondBlocker()) == l_True)
+                ) {
                     *j++ = *i;
                     continue;
                 }
@@ -656,7 +690,7 @@ PropBy PropEngine::propagate_light()
 
                 // If 0th watch is true, then clause is already satisfied.
                 if (value(c[0]) == l_True) {
-                    *j = Watched(offset, c[0]);
+                    *j = clause_watch(c, offset, 1, c[0]);
                     j++;
                     continue;
                 }
@@ -671,7 +705,7 @@ PropBy PropEngine::propagate_light()
                     if (value(*k) != l_False) {
                         c[1] = *k;
                         *k = ~p;
-                        watches[c[1]].push(Watched(offset, c[0]));
+                        watches[c[1]].push(clause_watch(c, offset, 1, c[0]));
                         cont = true;
                         break;
                     }
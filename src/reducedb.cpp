@@ -25,10 +25,13 @@ THE SOFTWARE.
 #include "solverconf.h"
 #include "sqlstats.h"
 #ifdef FINAL_PREDICTOR
+#ifndef NATIVE_PREDICTOR_ONLY
 #include "cl_predictors_xgb.h"
 #include "cl_predictors_lgbm.h"
 #include "cl_predictors_py.h"
 #endif
+#include "cl_predictors_native.h"
+#endif
 
 // #define VERBOSE_DEBUG
 
@@ -201,6 +204,12 @@ ReduceDB::~ReduceDB()
 {
     #ifdef FINAL_PREDICTOR
     //delete predictors;
+    for(auto& t: pred_workers) {
+        t.join();
+    }
+    for(auto& p: pool_predictors) {
+        delete p;
+    }
     #endif
 }
 
@@ -684,14 +693,12 @@ void ReduceDB::pred_move_to_lev1_and_lev0()
     solver->longRedCls[2].resize(j);
 }
 
-void ReduceDB::update_preds(const vector<ClOffset>& offs)
+uint32_t ReduceDB::fill_pred_input(
+    const vector<ClOffset>& offs,
+    float* data,
+    vector<int32_t>* IDs)
 {
-    int step_size = predictors->get_step_size();
-    float* data_orig = (float*)malloc(step_size*offs.size()*sizeof(float));
-    memset(data_orig, 0, step_size*offs.size()*sizeof(float));
-    float* data = data_orig;
-
-
+    const int step_size = predictors->get_step_size();
     uint32_t data_at = 0;
     for(size_t i = 0
         ; i < offs.size()
@@ -730,9 +737,22 @@ void ReduceDB::update_preds(const vector<ClOffset>& offs)
             assert(ret == step_size);
             data_at++;
             data += step_size;
+            if (IDs) {
+                IDs->push_back(cl->stats.ID);
+            }
         }
     }
 
+    return data_at;
+}
+
+void ReduceDB::update_preds(const vector<ClOffset>& offs)
+{
+    int step_size = predictors->get_step_size();
+    float* data_orig = (float*)malloc(step_size*offs.size()*sizeof(float));
+    memset(data_orig, 0, step_size*offs.size()*sizeof(float));
+
+    const uint32_t data_at = fill_pred_input(offs, data_orig, NULL);
     predictors->predict_all(data_orig, data_at);
 
     uint32_t retrieve_at = 0;
@@ -1048,6 +1068,76 @@ void ReduceDB::dump_pred_distrib(const vector<ClOffset>& offs, uint32_t lev) {
     }
 }
 
+ClPredictorsAbst* ReduceDB::new_predictor(const bool verbose)
+{
+    ClPredictorsAbst* p;
+    if (solver->conf.predictor_type == "native") {
+        p = new ClPredictorsNative;
+    #ifndef NATIVE_PREDICTOR_ONLY
+    } else if (solver->conf.predictor_type == "xgb") {
+        p = new ClPredictorsXGB;
+    } else if (solver->conf.predictor_type == "lgbm") {
+        p = new ClPredictorsLGBM;
+    } else if (solver->conf.predictor_type == "py") {
+        p = new ClPredictorsPy;
+    #endif
+    } else {
+        #ifdef NATIVE_PREDICTOR_ONLY
+        cout << "ERROR: This build only has the native predictor" << endl;
+        #else
+        cout << "ERROR: You must give either lgbm or xgboost for predictor" << endl;
+        #endif
+        exit(-1);
+    }
+    if (solver->conf.pred_conf_location.empty()) {
+        if (p->load_models_from_buffers() != 0) {
+            cout << "ERROR: cannot load models from buffers" << endl;
+            exit(-1);
+        }
+        if (solver->conf.verbosity && verbose) {
+            cout << "c [pred] predictor hashes: ";
+            for(const auto& h: p->get_hashes()) {
+                cout << h << " ";
+            }
+            cout << endl;
+        }
+    } else {
+        vector<string> locations;
+        vector<string> tiers = {"short", "long", "forever"};
+        for (uint32_t i = 0; i < 3; i ++) {
+            locations.push_back(solver->conf.pred_conf_location + "/" +
+            std::string("predictor-")
+            + (solver->conf.pred_tables[i] == '0' ? "used_later" : "used_later_anc")
+            + "-"
+            + tiers[i] + "-"
+            //native reads the XGBoost models
+            + (solver->conf.predictor_type == "native" ? std::string("xgb") : solver->conf.predictor_type)
+            + std::string(".json"));
+        }
+
+        int ret = p->load_models(
+            locations[0],
+            locations[1],
+            locations[2],
+            solver->conf.predict_best_feat_fname);
+
+        if (ret == 0) {
+            cout << "ERROR with python array loading!" << endl;
+            exit(-1);
+        }
+
+        if (solver->conf.verbosity && verbose) {
+            cout << "c [pred] loaded predictors from: ";
+            for(const auto& l: locations) {
+                cout << l << " ";
+            }
+            cout << endl;
+        }
+    }
+
+    return p;
+}
+
 void ReduceDB::handle_predictors()
 {
     if (solver->conf.dump_pred_distrib && num_times_pred_called == 0) {
@@ -1062,60 +1152,13 @@ void ReduceDB::handle_predictors()
     }
     num_times_pred_called++;
     if (predictors == NULL) {
-        if (solver->conf.predictor_type == "xgb") {
-            predictors = new ClPredictorsXGB;
-        } else if (solver->conf.predictor_type == "lgbm") {
-            predictors = new ClPredictorsLGBM;
-        } else if (solver->conf.predictor_type == "py") {
-            predictors = new ClPredictorsPy;
-        } else {
-            cout << "ERROR: You must give either lgbm or xgboost for predictor" << endl;
-            exit(-1);
-        }
-        if (solver->conf.pred_conf_location.empty()) {
-            if (predictors->load_models_from_buffers() != 0) {
-                cout << "ERROR: cannot load models from buffers" << endl;
-                exit(-1);
-            }
-            if (solver->conf.verbosity) {
-                cout << "c [pred] predictor hashes: ";
-                for(const auto& h: predictors->get_hashes()) {
-                    cout << h << " ";
-                }
-                cout << endl;
-            }
-        } else {
-            vector<string> locations;
-            vector<string> tiers = {"short", "long", "forever"};
-            for (uint32_t i = 0; i < 3; i ++) {
-                locations.push_back(solver->conf.pred_conf_location + "/" +
-                std::string("predictor-")
-                + (solver->conf.pred_tables[i] == '0' ? "used_later" : "used_later_anc")
-                + "-"
-                + tiers[i] + "-"
-                + solver->conf.predictor_type
-                + std::string(".json"));
-            }
-
-            int ret = predictors->load_models(
-                locations[0],
-                locations[1],
-                locations[2],
-                solver->conf.predict_best_feat_fname);
-
-            if (ret == 0) {
-                cout << "ERROR with python array loading!" << endl;
-                exit(-1);
-            }
-
-            if (solver->conf.verbosity) {
-                cout << "c [pred] loaded predictors from: ";
-                for(const auto& l: locations) {
-                    cout << l << " ";
-                }
-                cout << endl;
-            }
-        }
+        predictors = new_predictor(true);
+    }
+    //The python predictor cannot be called from other threads
+    const bool async = solver->conf.pred_threads > 0
+        && solver->conf.predictor_type != "py";
+    if (async) {
+        apply_async_preds(true);
     }
 
     assert(delayed_clause_free.empty());
@@ -1138,6 +1181,22 @@ void ReduceDB::handle_predictors()
         median_data);
 
     //Move clauses around
+    clear_pred_move_stats();
+    if (async) {
+        start_async_preds();
+    } else {
+        update_preds_lev2();
+        pred_move_to_lev1_and_lev0();
+        delete_from_lev2();
+    }
+    clean_lev0_once_in_a_while();
+    clean_lev1_once_in_a_while();
+    reset_predict_stats();
+    finish_predictors(myTime);
+}
+
+void ReduceDB::clear_pred_move_stats()
+{
     T2_deleted = 0;
     moved_from_T1_to_T2 = 0;
     kept_in_T1 = 0;
@@ -1148,18 +1207,103 @@ void ReduceDB::handle_predictors()
     kept_in_T2 = 0;
     kept_in_T2_due_to_dontmove = 0;
     T2_deleted_age = 0;
-
-
     moved_from_T2_to_T0 = 0;
     moved_from_T2_to_T1 = 0;
+}
+
+void ReduceDB::start_async_preds()
+{
+    assert(pred_workers.empty());
+    const uint32_t num_threads = solver->conf.pred_threads;
+    while(pool_predictors.size() < num_threads) {
+        pool_predictors.push_back(new_predictor(false));
+    }
+
+    //Features are taken now, the search thread is free to go on after
+    const vector<ClOffset>& offs = solver->longRedCls[2];
+    const int step_size = predictors->get_step_size();
+    pred_data.assign((size_t)step_size*offs.size(), 0);
+    pred_IDs.clear();
+    const uint32_t rows = fill_pred_input(offs, pred_data.data(), &pred_IDs);
+    pred_out.resize(3*rows);
+
+    const uint32_t chunk = (rows+num_threads-1)/num_threads;
+    pred_apply_at = solver->sumConflicts + solver->conf.pred_apply_confl;
+    for(uint32_t t = 0; t < num_threads; t++) {
+        const uint32_t from = std::min(rows, t*chunk);
+        const uint32_t num = std::min(rows, from+chunk)-from;
+        ClPredictorsAbst* p = pool_predictors[t];
+        pred_workers.push_back(std::thread([this, p, from, num, step_size] {
+            if (num > 0) {
+                p->predict_all(pred_data.data() + (size_t)from*step_size, num);
+                ClauseStatsExtra res;
+                for(uint32_t i = 0; i < num; i++) {
+                    p->get_prediction_at(res, i);
+                    pred_out[3*(from+i)+predict_type::short_pred] = res.pred_short_use;
+                    pred_out[3*(from+i)+predict_type::long_pred] = res.pred_long_use;
+                    pred_out[3*(from+i)+predict_type::forever_pred] = res.pred_forever_use;
+                }
+                p->finish_all_predict();
+            }
+        }));
+    }
+}
 
-    update_preds_lev2();
+bool ReduceDB::apply_async_preds(const bool force)
+{
+    if (pred_workers.empty()
+        || (!force && solver->sumConflicts < pred_apply_at)
+    ) {
+        return false;
+    }
+    for(auto& t: pred_workers) {
+        t.join();
+    }
+    pred_workers.clear();
+
+    assert(delayed_clause_free.empty());
+    double myTime = cpuTime();
+    vector<std::pair<int32_t, uint32_t>> ID_to_row;
+    ID_to_row.reserve(pred_IDs.size());
+    for(uint32_t i = 0; i < pred_IDs.size(); i++) {
+        ID_to_row.push_back(std::make_pair(pred_IDs[i], i));
+    }
+    std::sort(ID_to_row.begin(), ID_to_row.end());
+
+    //Clauses that got into TIER2 after the features were taken have no
+    //prediction yet. They stay where they are until the next round.
+    vector<ClOffset> not_predicted;
+    size_t j = 0;
+    for(const ClOffset offset: solver->longRedCls[2]) {
+        Clause* cl = solver->cl_alloc.ptr(offset);
+        const auto it = std::lower_bound(ID_to_row.begin(), ID_to_row.end(),
+            std::make_pair(cl->stats.ID, 0U));
+        if (it == ID_to_row.end() || it->first != cl->stats.ID) {
+            not_predicted.push_back(offset);
+            continue;
+        }
+        auto& stats_extra = solver->red_stats_extra[cl->stats.extra_pos];
+        stats_extra.pred_short_use = pred_out[3*it->second+predict_type::short_pred];
+        stats_extra.pred_long_use = pred_out[3*it->second+predict_type::long_pred];
+        stats_extra.pred_forever_use = pred_out[3*it->second+predict_type::forever_pred];
+        solver->longRedCls[2][j++] = offset;
+    }
+    solver->longRedCls[2].resize(j);
+    dump_pred_distrib(solver->longRedCls[2], 2);
+
+    clear_pred_move_stats();
     pred_move_to_lev1_and_lev0();
     delete_from_lev2();
-    clean_lev0_once_in_a_while();
-    clean_lev1_once_in_a_while();
-    reset_predict_stats();
+    for(const ClOffset offset: not_predicted) {
+        solver->longRedCls[2].push_back(offset);
+    }
+    finish_predictors(myTime);
 
+    return true;
+}
+
+void ReduceDB::finish_predictors(const double myTime)
+{
     //Cleanup
     solver->clean_occur_from_removed_clauses_only_smudged();
     for(ClOffset offset: delayed_clause_free) {
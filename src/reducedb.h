@@ -26,6 +26,7 @@ THE SOFTWARE.
 #include "clauseallocator.h"
 #ifdef FINAL_PREDICTOR
 #include "cl_predictors_abs.h"
+#include <thread>
 #endif
 
 namespace CMSat {
@@ -51,6 +52,7 @@ public:
     void gather_normal_cl_use_stats();
     #ifdef FINAL_PREDICTOR
     void handle_predictors();
+    bool apply_async_preds(const bool force);
     #endif
     void dump_sql_cl_data(const uint32_t cur_rst_type);
     uint32_t reduceDB_called = 0;
@@ -109,7 +111,22 @@ private:
     void clean_lev0_once_in_a_while();
     void reset_predict_stats();
     void update_preds(const vector<ClOffset>& offs);
+    uint32_t fill_pred_input(const vector<ClOffset>& offs, float* data, vector<int32_t>* IDs);
+    ClPredictorsAbst* new_predictor(const bool verbose);
+    void finish_predictors(const double myTime);
+    void clear_pred_move_stats();
     ReduceCommonData commdata;
+
+    //Predicting TIER2 on helper threads. The results are applied at a
+    //point that only depends on the conflict count, never on how fast the
+    //helpers are
+    void start_async_preds();
+    vector<ClPredictorsAbst*> pool_predictors;
+    vector<std::thread> pred_workers;
+    uint64_t pred_apply_at = 0; //sumConflicts
+    vector<float> pred_data;
+    vector<int32_t> pred_IDs; //clause ID of each row of pred_data
+    vector<float> pred_out; //short, long, forever for each row
     void dump_pred_distrib(const vector<ClOffset>& offs, uint32_t lev);
     #endif
 
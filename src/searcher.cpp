@@ -51,6 +51,7 @@ THE SOFTWARE.
 #include "str_impl_w_impl.h"
 #include "subsumeimplicit.h"
 #include "sls.h"
+#include "cycleprof.h"
 #ifdef USE_VALGRIND
 #include "valgrind/valgrind.h"
 #include "valgrind/memcheck.h"
@@ -94,6 +95,7 @@ Searcher::Searcher(const SolverConf *_conf, Solver* _solver, std::atomic<bool>*
 
 Searcher::~Searcher()
 {
+    delete sls_async;
     clear_gauss_matrices(true);
 }
 
@@ -838,43 +840,49 @@ void Searcher::analyze_conflict(
     assert(decisionLevel() > 0);
 
     print_debug_resolution_data(confl);
-    create_learnt_clause<inprocess>(confl);
+    {
+        CYCLE_PROF_SCOPE(prof_analyze);
+        create_learnt_clause<inprocess>(confl);
+    }
     stats.litsRedNonMin += learnt_clause.size();
     #if defined(STATS_NEEDED) || defined(FINAL_PREDICTOR)
     glue_before_minim = calc_glue(learnt_clause);
     size_before_minim = learnt_clause.size();
     #endif
-    minimize_learnt_clause<inprocess>();
-    stats.litsRedFinal += learnt_clause.size();
-
-    //further minimisation 1 -- short, small glue clauses
-    glue = numeric_limits<uint32_t>::max();
-    if (learnt_clause.size() <= conf.max_size_more_minim) {
-        glue = calc_glue(learnt_clause);
-        if (glue <= conf.max_glue_more_minim) {
-            minimize_using_bins();
-        }
-    }
-    if (glue == numeric_limits<uint32_t>::max()) {
-        glue = calc_glue(learnt_clause);
-    }
-    print_fully_minimized_learnt_clause();
+    {
+        CYCLE_PROF_SCOPE(prof_minimize);
+        minimize_learnt_clause<inprocess>();
+        stats.litsRedFinal += learnt_clause.size();
 
-    if (glue <= (conf.glue_put_lev0_if_below_or_eq+2)) {
-        bool doit = false;
-        if (conf.doMinimRedMoreMore == 1 && learnt_clause.size() <= conf.max_size_more_minim) {
-            doit = true;
-        }
-        if (conf.doMinimRedMoreMore == 2 && learnt_clause.size() > conf.max_size_more_minim) {
-            doit = true;
-        }
-        if (conf.doMinimRedMoreMore == 3) {
-            doit = true;
+        //further minimisation 1 -- short, small glue clauses
+        glue = numeric_limits<uint32_t>::max();
+        if (learnt_clause.size() <= conf.max_size_more_minim) {
+            glue = calc_glue(learnt_clause);
+            if (glue <= conf.max_glue_more_minim) {
+                minimize_using_bins();
+            }
         }
-        if (doit) {
-            minimise_redundant_more_more(learnt_clause);
+        if (glue == numeric_limits<uint32_t>::max()) {
             glue = calc_glue(learnt_clause);
         }
+        print_fully_minimized_learnt_clause();
+
+        if (glue <= (conf.glue_put_lev0_if_below_or_eq+2)) {
+            bool doit = false;
+            if (conf.doMinimRedMoreMore == 1 && learnt_clause.size() <= conf.max_size_more_minim) {
+                doit = true;
+            }
+            if (conf.doMinimRedMoreMore == 2 && learnt_clause.size() > conf.max_size_more_minim) {
+                doit = true;
+            }
+            if (conf.doMinimRedMoreMore == 3) {
+                doit = true;
+            }
+            if (doit) {
+                minimise_redundant_more_more(learnt_clause);
+                glue = calc_glue(learnt_clause);
+            }
+        }
     }
 
     #ifdef STATS_NEEDED_BRANCH
@@ -1264,6 +1272,7 @@ lbool Searcher::search()
     check_no_duplicate_lits_anywhere();
     check_order_heap_sanity();
     #endif
+    CYCLE_PROF_SCOPE(prof_search);
     const double myTime = cpuTime();
 
     //Stats reset & update
@@ -1302,23 +1311,33 @@ lbool Searcher::search()
                 search_ret = l_False;
                 goto end;
             }
-            check_need_restart();
-            check_need_gauss_jordan_disable();
+            {
+                CYCLE_PROF_SCOPE(prof_restart);
+                check_need_restart();
+                check_need_gauss_jordan_disable();
+            }
         } else {
             assert(ok);
             if (decisionLevel() == 0) {
                 SLOW_DEBUG_DO(for(const auto& bnn: bnns) if (bnn) assert(solver->check_bnn_sane(*bnn)););
+                CYCLE_PROF_SCOPE(prof_clean);
                 if (!clean_clauses_if_needed()) {
                     search_ret = l_False;
                     goto end;
                 }
             }
-            reduce_db_if_needed();
+            {
+                CYCLE_PROF_SCOPE(prof_reduce_db);
+                reduce_db_if_needed();
+            }
             lbool dec_ret;
-            if (fast_backw.fast_backw_on) {
-                dec_ret = new_decision_fast_backw();
-            } else {
-                dec_ret = new_decision<false>();
+            {
+                CYCLE_PROF_SCOPE(prof_decide);
+                if (fast_backw.fast_backw_on) {
+                    dec_ret = new_decision_fast_backw();
+                } else {
+                    dec_ret = new_decision<false>();
+                }
             }
             if (dec_ret != l_Undef) {
                 search_ret = dec_ret;
@@ -1336,9 +1355,19 @@ lbool Searcher::search()
         goto end;
     }
     assert(solver->prop_at_head());
-    if (!solver->datasync->syncData()) {
-        search_ret = l_False;
-        goto end;
+    #ifdef FINAL_PREDICTOR
+    if (solver->reduceDB->apply_async_preds(false)) {
+        consolidate_cls_and_measure();
+    }
+    #endif
+    {
+        CYCLE_PROF_SCOPE(prof_sync);
+        if (!solver->datasync->syncData()
+            || !solver->datasync->sync_external()
+        ) {
+            search_ret = l_False;
+            goto end;
+        }
     }
     assert(search_ret == l_Undef);
     SLOW_DEBUG_DO(check_no_zero_ID_bins());
@@ -1790,6 +1819,7 @@ Clause* Searcher::handle_last_confl(
 
 bool Searcher::handle_conflict(PropBy confl)
 {
+    CYCLE_PROF_SCOPE(prof_conflict);
     stats.conflicts++;
     hist.num_conflicts_this_restart++;
     sumConflicts++;
@@ -1823,7 +1853,6 @@ bool Searcher::handle_conflict(PropBy confl)
         , glue_before_minim         //return glue before minimization here
         , size_before_minim         //return glue before minimization here
     );
-    solver->datasync->signal_new_long_clause(learnt_clause);
     #ifdef USE_GPU
     solver->datasync->trySendAssignmentToGpu();
     #endif
@@ -1859,19 +1888,23 @@ bool Searcher::handle_conflict(PropBy confl)
     }
 
     // check chrono backtrack condition
-    if (conf.diff_declev_for_chrono > -1
-        && bnns.empty()
-        && (((int)decisionLevel() - (int)backtrack_level) >= conf.diff_declev_for_chrono)
-    ) {
-        chrono_backtrack++;
-        cancelUntil(data.nHighestLevel -1);
-    } else {
-        non_chrono_backtrack++;
-        cancelUntil(backtrack_level);
+    {
+        CYCLE_PROF_SCOPE(prof_backtrack);
+        if (conf.diff_declev_for_chrono > -1
+            && bnns.empty()
+            && (((int)decisionLevel() - (int)backtrack_level) >= conf.diff_declev_for_chrono)
+        ) {
+            chrono_backtrack++;
+            cancelUntil(data.nHighestLevel -1);
+        } else {
+            non_chrono_backtrack++;
+            cancelUntil(backtrack_level);
+        }
     }
 
     assert(value(learnt_clause[0]) == l_Undef);
     glue = std::min<uint32_t>(glue, numeric_limits<uint32_t>::max());
+    CYCLE_PROF_SCOPE(prof_learnt);
     int32_t ID;
     Clause* cl = handle_last_confl(
         glue,
@@ -1882,6 +1915,8 @@ bool Searcher::handle_conflict(PropBy confl)
         connects_num_communities,
         ID
     );
+    //After handle_last_confl(), so the clause is in the FRAT with its ID
+    solver->datasync->signal_new_long_clause(learnt_clause, glue, ID);
     attach_and_enqueue_learnt_clause<false>(cl, backtrack_level, true, ID);
 
     //Add decision-based clause
@@ -1936,6 +1971,11 @@ void Searcher::resetStats()
     #endif
 
     lastCleanZeroDepthAssigns = trail.size();
+
+    //propStats are reset, so is the window
+    cons_prop_rate.mark_props = 0;
+    cons_prop_rate.mark_time = startTime;
+    cons_prop_rate.last_rate = -1;
 }
 
 #ifdef STATS_NEEDED
@@ -2135,8 +2175,10 @@ void Searcher::reduce_db_if_needed()
         }
         #endif
         #ifdef FINAL_PREDICTOR
+        const Solver::PhaseMark mark = solver->phase_start();
         solver->reduceDB->handle_predictors();
-        cl_alloc.consolidate(solver);
+        consolidate_cls_and_measure();
+        solver->phase_end("reducedb-pred", mark);
         #endif
         next_pred_reduce = sumConflicts + conf.every_pred_reduce;
     }
@@ -2146,26 +2188,58 @@ void Searcher::reduce_db_if_needed()
     if (conf.every_lev1_reduce != 0
         && sumConflicts >= next_lev1_reduce
     ) {
+        const Solver::PhaseMark mark = solver->phase_start();
         solver->reduceDB->handle_lev1();
+        solver->phase_end("reducedb-lev1", mark);
         next_lev1_reduce = sumConflicts + conf.every_lev1_reduce;
     }
 
     if (conf.every_lev2_reduce != 0) {
         if (sumConflicts >= next_lev2_reduce) {
+            const Solver::PhaseMark mark = solver->phase_start();
             solver->reduceDB->handle_lev2();
-            cl_alloc.consolidate(solver);
+            consolidate_cls_and_measure();
+            solver->phase_end("reducedb-lev2", mark);
             next_lev2_reduce = sumConflicts + conf.every_lev2_reduce;
         }
     } else {
         if (longRedCls[2].size() > cur_max_temp_red_lev2_cls) {
+            const Solver::PhaseMark mark = solver->phase_start();
             solver->reduceDB->handle_lev2();
             cur_max_temp_red_lev2_cls *= conf.inc_max_temp_lev2_red_cls;
-            cl_alloc.consolidate(solver);
+            consolidate_cls_and_measure();
+            solver->phase_end("reducedb-lev2", mark);
         }
     }
     #endif
 }
 
+//The props/sec since the previous consolidation is the "after" rate of that
+//one and the "before" rate of this one. Both windows contain one reduceDB.
+//Windows too short to time reliably are not counted.
+void Searcher::consolidate_cls_and_measure()
+{
+    const double elapsed = cpuTime() - cons_prop_rate.mark_time;
+    const uint64_t props = propStats.propagations - cons_prop_rate.mark_props;
+
+    if (!cl_alloc.consolidate(solver)) {
+        return;
+    }
+
+    double rate = -1;
+    if (elapsed >= 0.05 && propStats.propagations >= cons_prop_rate.mark_props) {
+        rate = (double)props/elapsed;
+    }
+    if (cons_prop_rate.last_rate >= 0 && rate >= 0) {
+        cons_prop_rate.num++;
+        cons_prop_rate.sum_before += cons_prop_rate.last_rate;
+        cons_prop_rate.sum_after += rate;
+    }
+    cons_prop_rate.last_rate = rate;
+    cons_prop_rate.mark_props = propStats.propagations;
+    cons_prop_rate.mark_time = cpuTime();
+}
+
 bool Searcher::clean_clauses_if_needed()
 {
     #ifdef SLOW_DEBUG
@@ -2444,6 +2518,14 @@ void Searcher::sls_if_needed()
 {
     assert(okay());
     assert(decisionLevel() == 0);
+
+    //Only one CCNR at a time. Pick up its result at the first restart
+    //after it's done
+    if (sls_async) {
+        if (!sls_async->async_done()) return;
+        sls_async_finish(true);
+    }
+
     if (conf.doSLS &&
         // If XORs are detached, or there are BNNs, SLS will not work as intended
         // HOWEVER, it seems to STILL help, likely by setting values randomly
@@ -2452,14 +2534,40 @@ void Searcher::sls_if_needed()
 //         bnns.empty() &&
         sumConflicts > next_sls)
     {
-        SLS sls(solver);
-        const lbool ret = sls.run(num_sls_called);
-        assert(ret != l_False);
+        const Solver::PhaseMark mark = solver->phase_start();
+        if (conf.sls_async) {
+            sls_async = new SLS(solver);
+            if (!sls_async->start_async(num_sls_called)) {
+                delete sls_async;
+                sls_async = nullptr;
+            }
+        } else {
+            SLS sls(solver);
+            const lbool ret = sls.run(num_sls_called);
+            assert(ret != l_False);
+        }
+        solver->phase_end("sls", mark);
         num_sls_called++;
         next_sls = sumConflicts + 44000.0*conf.global_next_multiplier;
     }
 }
 
+void Searcher::sls_async_finish(const bool apply)
+{
+    assert(sls_async);
+    const Solver::PhaseMark mark = solver->phase_start();
+    const bool found_model = sls_async->async_found_model();
+    sls_async->stop_async(apply);
+    delete sls_async;
+    sls_async = nullptr;
+
+    //The best phases satisfy every irredundant clause, so follow them
+    if (apply && found_model && conf.polarity_mode == PolarityMode::polarmode_automatic) {
+        polarity_mode = PolarityMode::polarmode_best;
+    }
+    solver->phase_end("sls-apply", mark);
+}
+
 bool Searcher::intree_if_needed()
 {
     assert(okay());
@@ -2470,10 +2578,16 @@ bool Searcher::intree_if_needed()
     if (conf.doIntreeProbe && conf.doFindAndReplaceEqLits && !conf.never_stop_search &&
         sumConflicts > next_intree
     ) {
+        const Solver::PhaseMark mark = solver->phase_start();
         ret &= solver->clear_gauss_matrices();
         if (ret) ret &= solver->intree->intree_probe();
         if (ret) ret &= solver->find_and_init_all_matrices();
+        solver->phase_end("intree-probe", mark);
         next_intree = sumConflicts + 65000.0*conf.global_next_multiplier;
+
+        //Intree clears propStats, start the props/sec window over
+        cons_prop_rate.mark_props = propStats.propagations;
+        cons_prop_rate.mark_time = cpuTime();
     }
 
     return ret;
@@ -2487,8 +2601,10 @@ bool Searcher::str_impl_with_impl_if_needed()
     if (conf.doStrSubImplicit &&
         sumConflicts > next_str_impl_with_impl)
     {
+        const Solver::PhaseMark mark = solver->phase_start();
         ret &= solver->dist_impl_with_impl->str_impl_w_impl();
         if (ret) solver->subsumeImplicit->subsume_implicit();
+        solver->phase_end("str-impl", mark);
         next_str_impl_with_impl = sumConflicts + 60000.0*conf.global_next_multiplier;
     }
 
@@ -2503,7 +2619,9 @@ bool Searcher::distill_bins_if_needed()
     if (conf.do_distill_bin_clauses &&
         sumConflicts > next_bins_distill)
     {
+        const Solver::PhaseMark mark = solver->phase_start();
         ret = solver->distill_bin_cls->distill();
+        solver->phase_end("distill-bins", mark);
         next_bins_distill = sumConflicts + 20000.0*conf.global_next_multiplier;
     }
     return ret;
@@ -2518,7 +2636,9 @@ bool Searcher::sub_str_with_bin_if_needed()
     if (conf.do_distill_clauses &&
         sumConflicts > next_sub_str_with_bin)
     {
+        const Solver::PhaseMark mark = solver->phase_start();
         ret = solver->dist_long_with_impl->distill_long_with_implicit(true);
+        solver->phase_end("sub-str-cls-with-bin", mark);
         next_sub_str_with_bin = sumConflicts + 25000.0*conf.global_next_multiplier;
     }
 
@@ -2531,9 +2651,11 @@ lbool Searcher::distill_clauses_if_needed()
     if (conf.do_distill_clauses &&
         sumConflicts > next_cls_distill)
     {
+        const Solver::PhaseMark mark = solver->phase_start();
         if (!solver->distill_long_cls->distill(true, false)) {
             return l_False;
         }
+        solver->phase_end("distill-cls", mark);
         next_cls_distill = sumConflicts + 15000.0*conf.global_next_multiplier;
     }
 
@@ -2547,9 +2669,11 @@ lbool Searcher::full_probe_if_needed()
         sumConflicts > next_full_probe
     ) {
         full_probe_iter++;
+        const Solver::PhaseMark mark = solver->phase_start();
         if (!solver->full_probe(full_probe_iter % 2)) {
             return l_False;
         }
+        solver->phase_end("full-probe", mark);
         next_full_probe = sumConflicts + 20000.0*conf.global_next_multiplier;
     }
 
@@ -2625,6 +2749,10 @@ lbool Searcher::solve(
     }
 
     end:
+    //Variables may be renumbered once we return, so SLS can't outlive us
+    if (sls_async) {
+        sls_async_finish(status == l_Undef && okay() && decisionLevel() == 0);
+    }
     finish_up_solve(status);
 
     return status;
@@ -2759,11 +2887,21 @@ void Searcher::check_need_restart()
             params.needToStopSearch = true;
         }
 
+        //The external callback may be slow, it's also polled at every restart
+        if ((stats.conflicts & 0xfff) == 0xfff) {
+            solver->datasync->poll_terminate();
+        }
+
         if (must_interrupt_asap())  {
             if (conf.verbosity >= 3)
                 cout << "c must_interrupt_asap() is set, restartig as soon as possible!" << endl;
             params.needToStopSearch = true;
         }
+
+        //SLS found a model on its thread, restart to pick it up
+        if (sls_async && sls_async->async_found_model()) {
+            params.needToStopSearch = true;
+        }
     }
 
     //dynamic
@@ -3540,7 +3678,8 @@ ConflictData Searcher::find_conflict_level(PropBy& pb)
             std::swap(clause[0], clause[highestId]);
             if (highestId > 1 && pb.getType() == clause_t) {
                 removeWCl(watches[clause[highestId]], pb.get_offset());
-                watches[clause[0]].push(Watched(offs, clause[1]));
+                watches[clause[0]].push(
+                    clause_watch(*cl_alloc.ptr(offs), offs, 0, clause[1]));
             }
         }
     }
@@ -45,6 +45,7 @@ class SQLStats;
 class VarReplacer;
 class EGaussian;
 class DistillerLong;
+class SLS;
 
 using std::string;
 
@@ -244,6 +245,8 @@ class Searcher : public HyperEngine
         // SLS
         uint64_t next_sls = 0;
         void sls_if_needed();
+        SLS* sls_async = nullptr; //running on a helper thread, if not NULL
+        void sls_async_finish(const bool apply);
 
         // Fast backward for Arjun
         lbool new_decision_fast_backw();
@@ -337,10 +340,24 @@ class Searcher : public HyperEngine
         void  resetStats(); //For connection with Solver
         double   startTime; ///<When solve() was started
 
+        //Propagations/sec between search-time clause consolidations
+        struct ConsolidatePropRate {
+            uint64_t num = 0; ///<Consolidations with both rates measured
+            double sum_before = 0;
+            double sum_after = 0;
+
+            //Current measurement window
+            uint64_t mark_props = 0;
+            double mark_time = 0;
+            double last_rate = -1;
+        };
+        ConsolidatePropRate cons_prop_rate;
+
         /////////////////////
         // Clause database reduction
         /////////////////////
         void reduce_db_if_needed();
+        void consolidate_cls_and_measure();
         uint64_t next_lev1_reduce;
         uint64_t next_lev2_reduce;
         uint64_t next_pred_reduce;
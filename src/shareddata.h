@@ -31,22 +31,172 @@ THE SOFTWARE.
 #include <vector>
 #include <mutex>
 #include <atomic>
+#include <memory>
 using std::vector;
 using std::mutex;
 
 namespace CMSat {
 
+/**
+@brief Bounded, lock-free, multi-producer ring of short learnt clauses
+
+Every thread may push at any time and every thread reads all clauses (i.e. it's
+a broadcast, not a work queue). Each reader keeps its own position. If a reader
+falls more than 'capacity' clauses behind, the clauses it missed are lost --
+this is fine, they are redundant clauses after all.
+
+Each slot is protected by a sequence number used as a seqlock: it is 2*pos+1
+while clause number 'pos' is being written, and 2*(pos+1) once it is complete.
+A writer claims its slot with a CAS, and only from a complete, older clause.
+So two writers a lap apart never write the same slot at the same time: the
+one that loses drops its clause. Readers see a slot as pending until its
+writer is done, and come back to it at the next sync.
+Literals are stored as *outside* literals, i.e. without BVA variables.
+*/
+class LongClauseRing
+{
+public:
+    static constexpr uint32_t max_cl_size = 32;
+
+    explicit LongClauseRing(const uint32_t _capacity) :
+        capacity(_capacity)
+        , slots(new Slot[_capacity])
+    {
+        head.store(0);
+    }
+
+    LongClauseRing(const LongClauseRing&) = delete;
+    LongClauseRing& operator=(const LongClauseRing&) = delete;
+
+    enum class ReadRet {ok, pending, gone};
+
+    //Returns FALSE if the clause was dropped, its slot being still in use
+    bool push(
+        const int thread_id
+        , const Lit* lits
+        , const uint32_t size
+        , const uint32_t glue
+        , const int64_t ID = 0)
+    {
+        assert(size <= max_cl_size);
+        const uint64_t pos = head.fetch_add(1, std::memory_order_relaxed);
+        Slot& s = slots[pos % capacity];
+        uint64_t cur = s.seq.load(std::memory_order_relaxed);
+        do {
+            //Being written, or a newer clause is already there
+            if ((cur & 1) || cur > 2*pos) {
+                mark_dropped(s, pos);
+                return false;
+            }
+        } while (!s.seq.compare_exchange_weak(cur, 2*pos+1
+            , std::memory_order_acquire, std::memory_order_relaxed));
+        std::atomic_thread_fence(std::memory_order_release);
+        s.thread_id.store(thread_id, std::memory_order_relaxed);
+        s.size.store(size, std::memory_order_relaxed);
+        s.glue.store(glue, std::memory_order_relaxed);
+        s.ID.store(ID, std::memory_order_relaxed);
+        for(uint32_t i = 0; i < size; i++) {
+            s.lits[i].store(lits[i].toInt(), std::memory_order_relaxed);
+        }
+        s.seq.store(2*(pos+1), std::memory_order_release);
+        return true;
+    }
+
+    uint64_t get_head() const
+    {
+        return head.load(std::memory_order_acquire);
+    }
+
+    //'pending' if clause 'pos' is not complete yet. 'gone' if it has been
+    //overwritten, or its writer dropped it
+    ReadRet read(
+        const uint64_t pos
+        , int& thread_id
+        , vector<Lit>& lits
+        , uint32_t& glue
+        , int64_t& ID) const
+    {
+        const Slot& s = slots[pos % capacity];
+        const uint64_t seq = s.seq.load(std::memory_order_acquire);
+        if (seq > 2*(pos+1)) {
+            return ReadRet::gone;
+        }
+        if (seq != 2*(pos+1)) {
+            if (s.dropped.load(std::memory_order_acquire) > pos) {
+                return ReadRet::gone;
+            }
+            return ReadRet::pending;
+        }
+        thread_id = s.thread_id.load(std::memory_order_relaxed);
+        glue = s.glue.load(std::memory_order_relaxed);
+        ID = s.ID.load(std::memory_order_relaxed);
+        const uint32_t size = s.size.load(std::memory_order_relaxed);
+        if (size > max_cl_size) {
+            return ReadRet::gone;
+        }
+        lits.resize(size);
+        for(uint32_t i = 0; i < size; i++) {
+            lits[i] = Lit::toLit(s.lits[i].load(std::memory_order_relaxed));
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (s.seq.load(std::memory_order_relaxed) != seq) {
+            return ReadRet::gone;
+        }
+        return ReadRet::ok;
+    }
+
+    size_t mem_used() const
+    {
+        return capacity*sizeof(Slot);
+    }
+
+    const uint32_t capacity;
+
+private:
+    struct Slot {
+        Slot() {
+            seq.store(0);
+            thread_id.store(-1);
+            size.store(0);
+            glue.store(0);
+            ID.store(0);
+            dropped.store(0);
+        }
+        std::atomic<uint64_t> seq;
+        //One more than the latest position dropped, 0 if none. Kept apart
+        //from seq, which belongs to the writer holding the slot
+        std::atomic<uint64_t> dropped;
+        std::atomic<int> thread_id;
+        std::atomic<uint32_t> size;
+        std::atomic<uint32_t> glue;
+        std::atomic<int64_t> ID; //FRAT ID of the clause, 0 if no FRAT
+        std::atomic<uint32_t> lits[max_cl_size];
+    };
+
+    static void mark_dropped(Slot& s, const uint64_t pos)
+    {
+        uint64_t cur = s.dropped.load(std::memory_order_relaxed);
+        while (cur < pos+1 && !s.dropped.compare_exchange_weak(cur, pos+1
+            , std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    std::atomic<uint64_t> head;
+    std::unique_ptr<Slot[]> slots;
+};
+
 class SharedData
 {
     public:
         SharedData(const uint32_t _num_threads) :
             num_threads(_num_threads)
+            , long_cls(1U << 15)
         {
             #ifdef USE_GPU
             csOpts.verbosity = 0;
             gpuClauseSharer = GpuShare::makeGpuClauseSharerPtr(csOpts);
             #endif
             cur_thread_id.store(0);
+            frat_sync_at.store(0);
         }
 
         ~SharedData()
@@ -70,18 +220,23 @@ class SharedData
             #endif
             :
                 data(std::move(other.data))
+                , IDs(std::move(other.IDs))
             {
                 other.data = NULL;
+                other.IDs = NULL;
             }
             ~Spec() {
                 clear();
             }
             vector<Lit>* data = NULL;
+            vector<int64_t>* IDs = NULL; //FRAT IDs of 'data', only with FRAT
 
             void clear()
             {
                 delete data;
                 data = NULL;
+                delete IDs;
+                IDs = NULL;
             }
         };
 
@@ -94,14 +249,23 @@ class SharedData
         #endif
 
         vector<lbool> value;
+        vector<int64_t> value_ID; //FRAT ID of the unit clause, only with FRAT
         std::mutex unit_mutex;
         std::atomic<int> cur_thread_id;
         uint32_t num_threads;
 
+        //Low-glue learnt clauses of size >2, lock-free
+        LongClauseRing long_cls;
+
+        //FRAT: source of the sync points between the threads' proofs
+        std::atomic<uint64_t> frat_sync_at;
+
         size_t calc_memory_use_bins()
         {
             size_t mem = 0;
             mem += value.capacity()*sizeof(lbool);
+            mem += value_ID.capacity()*sizeof(int64_t);
+            mem += long_cls.mem_used();
             #ifndef USE_GPU
             mem += bins.capacity()*sizeof(Spec);
             for(size_t i = 0; i < bins.size(); i++) {
@@ -109,6 +273,10 @@ class SharedData
                     mem += bins[i].data->capacity()*sizeof(Lit);
                     mem += sizeof(vector<Lit>);
                 }
+                if (bins[i].IDs) {
+                    mem += bins[i].IDs->capacity()*sizeof(int64_t);
+                    mem += sizeof(vector<int64_t>);
+                }
             }
             #endif
             return mem;
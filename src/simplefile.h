@@ -25,8 +25,16 @@ THE SOFTWARE.
 
 #include <fstream>
 #include <iostream>
+#include <iterator>
 #include <string>
 #include <cstdint>
+#include <cstring>
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 using std::ios;
 
 #include "solvertypes.h"
@@ -40,8 +48,19 @@ public:
     {
         outf = new std::ofstream(fname.c_str(), ios::out | ios::binary);
         outf->exceptions(~std::ios::goodbit);
-        //buffer.resize(100000000);
-        //outf->rdbuf()->pubsetbuf(&buffer.front(), buffer.size());
+    }
+
+    //Collects everything in memory instead, see get_buffer()
+    void start_buffer()
+    {
+        assert(outf == NULL);
+        buffer.clear();
+    }
+
+    vector<char>& get_buffer()
+    {
+        assert(outf == NULL);
+        return buffer;
     }
 
     ~SimpleOutFile()
@@ -87,44 +106,75 @@ public:
 
 private:
     std::ofstream* outf = NULL;
-    //vector<char> buffer;
+    vector<char> buffer;
 
     void put(const void* ptr, size_t num)
     {
-        outf->write((const char*)ptr, num);
+        if (outf) {
+            outf->write((const char*)ptr, num);
+        } else {
+            buffer.insert(buffer.end(), (const char*)ptr, (const char*)ptr + num);
+        }
     }
 };
 
+//Reads back what SimpleOutFile wrote. The file is mmap-ed where possible, so
+//large files can be loaded without going through stream buffers
 class SimpleInFile
 {
 public:
     void start(const string& fname)
     {
-        try {
-            inf = new std::ifstream(fname.c_str(), ios::in | ios::binary);
-            inf->exceptions(~std::ios::goodbit);
-        } catch (...) {
+        #ifndef _WIN32
+        int fd = open(fname.c_str(), O_RDONLY);
+        struct stat st;
+        if (fd == -1 || fstat(fd, &st) != 0) {
+            cout << "Error opening file " << fname.c_str() << endl;
+            exit(-1);
+        }
+        size = st.st_size;
+        if (size > 0) {
+            void* m = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (m == MAP_FAILED) {
+                cout << "Error mapping file " << fname.c_str() << endl;
+                exit(-1);
+            }
+            madvise(m, size, MADV_SEQUENTIAL);
+            data = (const char*)m;
+            mapped = true;
+        }
+        close(fd);
+        #else
+        std::ifstream inf(fname.c_str(), ios::in | ios::binary);
+        if (!inf) {
             cout << "Error opening file " << fname.c_str() << endl;
             exit(-1);
         }
+        buffer.assign(std::istreambuf_iterator<char>(inf), std::istreambuf_iterator<char>());
+        size = buffer.size();
+        data = buffer.data();
+        #endif
+        fname_read = fname;
     }
 
     ~SimpleInFile()
     {
-        delete inf;
+        #ifndef _WIN32
+        if (mapped) munmap((void*)data, size);
+        #endif
     }
 
     uint32_t get_uint32_t()
     {
         uint32_t val = 0;
-        inf->read((char*)&val, 4);
+        get_raw(&val, 1, 4);
         return val;
     }
 
     uint64_t get_uint64_t()
     {
         uint64_t val = 0;
-        inf->read((char*)&val, 8);
+        get_raw(&val, 1, 8);
         return val;
     }
 
@@ -137,7 +187,7 @@ public:
     lbool get_lbool()
     {
         lbool l;
-        inf->read((char*)&l, sizeof(lbool));
+        get_raw(&l, 1, sizeof(lbool));
         return l;
     }
 
@@ -149,6 +199,9 @@ public:
         if (sz == 0)
             return;
 
+        if (sz > (size - at)/sizeof(T)) {
+            corrupt();
+        }
         d.resize(sz);
         get_raw(&d[0], d.size(), sizeof(T));
     }
@@ -156,15 +209,44 @@ public:
     template<class T>
     void get_struct(T& d)
     {
-        inf->read((char*)&d, sizeof(T));
+        get_raw(&d, 1, sizeof(T));
+    }
+
+    bool at_end() const
+    {
+        return at == size;
+    }
+
+    //For checks done by the reader on what it got back
+    void corrupt() const
+    {
+        cout << "ERROR: file " << fname_read << " is truncated or corrupt" << endl;
+        exit(-1);
+    }
+
+    void check_var(const uint32_t var, const uint32_t num_vars) const
+    {
+        if (var >= num_vars) corrupt();
     }
 
 private:
-    std::ifstream* inf = NULL;
+    const char* data = NULL;
+    size_t size = 0;
+    size_t at = 0;
+    bool mapped = false;
+    string fname_read;
+    #ifdef _WIN32
+    vector<char> buffer;
+    #endif
 
     void get_raw(void* ptr, size_t num, size_t elem_sz)
     {
-        inf->read((char*)ptr, num*elem_sz);
+        const size_t bytes = num*elem_sz;
+        if (bytes > size - at) {
+            corrupt();
+        }
+        memcpy(ptr, data + at, bytes);
+        at += bytes;
     }
 };
 
@@ -31,21 +31,21 @@ SLS::SLS(Solver* _solver) :
 {}
 
 SLS::~SLS()
-{}
+{
+    stop_async(false);
+}
 
 lbool SLS::run(const uint32_t num_sls_called)
 {
     return run_ccnr(num_sls_called);
 }
 
-lbool SLS::run_ccnr(const uint32_t num_sls_called)
+bool SLS::mem_ok()
 {
-    CMS_ccnr ccnr(solver);
     double mem_needed_mb = (double)approx_mem_needed()/(1000.0*1000.0);
     double maxmem = solver->conf.sls_memoutMB*solver->conf.var_and_mem_out_mult;
     if (mem_needed_mb < maxmem) {
-        lbool ret = ccnr.main(num_sls_called);
-        return ret;
+        return true;
     }
 
     verb_print(1, "[sls] would need "
@@ -53,7 +53,69 @@ lbool SLS::run_ccnr(const uint32_t num_sls_called)
         << " MB but that's over limit of " << std::fixed << maxmem
         << " MB -- skipping");
 
-    return l_Undef;
+    return false;
+}
+
+lbool SLS::run_ccnr(const uint32_t num_sls_called)
+{
+    if (!mem_ok()) {
+        delete solver->ccnr;
+        solver->ccnr = nullptr;
+        return l_Undef;
+    }
+    if (solver->ccnr == nullptr) {
+        solver->ccnr = new CMS_ccnr(solver);
+    }
+    return solver->ccnr->main(num_sls_called);
+}
+
+bool SLS::start_async(const uint32_t num_sls_called)
+{
+    assert(async_ccnr == nullptr);
+    if (!mem_ok()) {
+        delete solver->ccnr;
+        solver->ccnr = nullptr;
+        return false;
+    }
+
+    if (solver->ccnr == nullptr) {
+        solver->ccnr = new CMS_ccnr(solver);
+    }
+    async_ccnr = solver->ccnr;
+    if (!async_ccnr->snapshot()) {
+        async_ccnr = nullptr;
+        return false;
+    }
+    async_num_sls_called = num_sls_called;
+    async_interrupt = false;
+    async_finished = false;
+    async_model = false;
+    verb_print(1, "[sls] started CCNR on a helper thread");
+
+    async_thread = std::thread([this]() {
+        async_ccnr->search(&async_interrupt);
+        async_model.store(async_ccnr->found_solution(), std::memory_order_release);
+        async_finished.store(true, std::memory_order_release);
+    });
+    return true;
+}
+
+void SLS::stop_async(const bool apply)
+{
+    if (async_ccnr == nullptr) {
+        return;
+    }
+
+    async_interrupt = true;
+    async_thread.join();
+    verb_print(1, "[sls] helper thread done"
+        << (async_model ? ", model found" : "")
+        << (apply ? "" : ", result dropped"));
+    if (apply) {
+        lbool ret = async_ccnr->apply(async_num_sls_called);
+        assert(ret != l_False);
+    }
+    async_ccnr = nullptr;
 }
 
 uint64_t SLS::approx_mem_needed()
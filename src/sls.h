@@ -23,11 +23,14 @@ THE SOFTWARE.
 #ifndef SLS_H_
 #define SLS_H_
 
+#include <atomic>
+#include <thread>
 #include "solvertypes.h"
 
 namespace CMSat {
 
 class Solver;
+class CMS_ccnr;
 
 class SLS {
 public:
@@ -35,11 +38,31 @@ public:
     ~SLS();
     lbool run(const uint32_t num_sls_called);
 
+    //CCNR over a snapshot of the irredundant clauses, flipping on a helper
+    //thread. The caller polls async_done() and calls stop_async() on the
+    //solver's own thread, before any renumbering.
+    bool start_async(const uint32_t num_sls_called);
+    bool async_done() const {
+        return async_finished.load(std::memory_order_acquire);
+    }
+    bool async_found_model() const {
+        return async_model.load(std::memory_order_acquire);
+    }
+    void stop_async(const bool apply);
+
 private:
     Solver* solver;
 
     lbool run_ccnr(const uint32_t num_sls_called);
+    bool mem_ok();
     uint64_t approx_mem_needed();
+
+    CMS_ccnr* async_ccnr = nullptr; //Solver::ccnr, not owned
+    std::thread async_thread;
+    std::atomic<bool> async_interrupt{false};
+    std::atomic<bool> async_finished{false};
+    std::atomic<bool> async_model{false};
+    uint32_t async_num_sls_called = 0;
 };
 
 } //end namespace CMSat
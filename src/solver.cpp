@@ -24,6 +24,7 @@ THE SOFTWARE.
 
 #include <fstream>
 #include <cmath>
+#include <cstdio>
 #include <fcntl.h>
 #include <functional>
 #include <limits>
@@ -33,6 +34,9 @@ THE SOFTWARE.
 #include <complex>
 #include <locale>
 #include <random>
+#include <numeric>
+#include <thread>
+#include <atomic>
 
 #ifdef ARJUN_SERIALIZE
 #include <boost/archive/text_iarchive.hpp>
@@ -73,11 +77,13 @@ THE SOFTWARE.
 #include "xorfinder.h"
 #include "cardfinder.h"
 #include "sls.h"
+#include "ccnr_cms.h"
 #include "matrixfinder.h"
 #include "lucky.h"
 #include "get_clause_query.h"
 #include "community_finder.h"
 #include "oracle/oracle.h"
+#include "cycleprof.h"
 extern "C" {
 #include "picosat/picosat.h"
 }
@@ -149,6 +155,7 @@ Solver::Solver(const SolverConf *_conf, std::atomic<bool>* _must_interrupt_inter
 
 Solver::~Solver()
 {
+    wait_for_checkpoint_write();
     delete sqlStats;
     delete intree;
     delete occsimplifier;
@@ -166,6 +173,10 @@ Solver::~Solver()
     delete breakid;
 #endif
     delete card_finder;
+    //The helper thread may still be using ccnr
+    delete sls_async;
+    sls_async = NULL;
+    delete ccnr;
 }
 
 void Solver::set_sqlite(
@@ -190,6 +201,11 @@ void Solver::set_shared_data(SharedData* shared_data)
     datasync->set_shared_data(shared_data);
 }
 
+void Solver::set_external_callbacks(const ExternalCallbacks& cbs)
+{
+    datasync->set_external_callbacks(cbs);
+}
+
 bool Solver::add_xor_clause_inter(
     const vector<Lit>& lits
     , bool rhs
@@ -1597,11 +1613,16 @@ lbool Solver::simplify_problem_outside(const string* strategy)
 
 void Solver::reset_for_solving()
 {
-    longest_trail_ever_best = 0;
-    longest_trail_ever_inv = 0;
+    //After restoring a checkpoint, the solve() call it was taken in continues
+    const bool restored = search_state_restored;
+    search_state_restored = false;
+    if (!restored) {
+        longest_trail_ever_best = 0;
+        longest_trail_ever_inv = 0;
+        polarity_strategy_change = 0;
+        increasing_phase_size = conf.restart_first;
+    }
     fresh_solver = false;
-    polarity_strategy_change = 0;
-    increasing_phase_size = conf.restart_first;
     set_assumptions();
     #ifdef SLOW_DEBUG
     if (ok) {
@@ -1616,9 +1637,15 @@ void Solver::reset_for_solving()
     check_and_upd_config_parameters();
 
     //Reset parameters
-    luby_loop_num = 0;
-    conf.global_timeout_multiplier = conf.orig_global_timeout_multiplier;
-    solveStats.num_simplify_this_solve_call = 0;
+    if (!restored) {
+        luby_loop_num = 0;
+        conf.global_timeout_multiplier = conf.orig_global_timeout_multiplier;
+        solveStats.num_simplify_this_solve_call = 0;
+        search_iter_num = 0;
+    }
+    if (ckpt_next_time == 0) {
+        ckpt_next_time = real_time_sec() + conf.checkpoint_every_secs;
+    }
     if (conf.verbosity >= 6) {
         cout << "c " << __func__ << " called" << endl;
     }
@@ -1727,7 +1754,12 @@ lbool Solver::solve_with_assumptions(
     conf.maxTime = numeric_limits<double>::max();
     datasync->finish_up_mpi();
     conf.conf_needed = true;
-    set_must_interrupt_asap();
+    if (status != l_Undef && sls_async == NULL) {
+        //Kept between SLS calls of the same search only
+        delete ccnr;
+        ccnr = NULL;
+    }
+    if (interrupt_at_end) set_must_interrupt_asap();
     assert(decisionLevel()== 0);
     assert(!ok || prop_at_head());
     if (_assumptions == NULL || _assumptions->empty()) {
@@ -1933,24 +1965,27 @@ uint64_t Solver::calc_num_confl_to_do_this_iter(const size_t iteration_num) cons
 lbool Solver::iterate_until_solved()
 {
     lbool status = l_Undef;
-    size_t iteration_num = 0;
 
     while (status == l_Undef
         && !must_interrupt_asap()
         && cpuTime() < conf.maxTime
         && sumConflicts < conf.max_confl
     ) {
-        iteration_num++;
+        search_iter_num++;
         if (conf.verbosity >= 2) print_clause_size_distrib();
         dump_memory_stats_to_sql();
 
-        const uint64_t num_confl = calc_num_confl_to_do_this_iter(iteration_num);
+        const uint64_t num_confl = calc_num_confl_to_do_this_iter(search_iter_num);
         if (num_confl == 0) break;
+        PhaseMark mark = phase_start();
         if (!find_and_init_all_matrices()) {
             status = l_False;
             goto end;
         }
+        phase_end("gauss-init", mark);
+        mark = phase_start();
         status = Searcher::solve(num_confl);
+        phase_end("search", mark);
 
         //Check for effectiveness
         check_recursive_minimization_effectiveness(status);
@@ -1979,6 +2014,7 @@ lbool Solver::iterate_until_solved()
         if (conf.do_simplify_problem) {
             status = simplify_problem(false, conf.simplify_schedule_nonstartup);
         }
+        if (status == l_Undef) checkpoint_if_needed();
     }
 
     #ifdef STATS_NEEDED
@@ -2106,7 +2142,9 @@ lbool Solver::execute_inprocess_strategy(
                     cout << "c --> Executing OCC strategy token(s): '"
                     << occ_strategy_tokens << "'\n";
                 }
+                const PhaseMark occ_mark = phase_start();
                 occsimplifier->simplify(startup, occ_strategy_tokens);
+                phase_end("occ", occ_mark);
             }
             occ_strategy_tokens.clear();
             if (sumConflicts >= conf.max_confl
@@ -2127,6 +2165,7 @@ lbool Solver::execute_inprocess_strategy(
             cout << "c --> Executing strategy token: " << token << '\n';
         }
 
+        const PhaseMark mark = phase_start();
         if (token == "scc-vrepl") {
             if (conf.doFindAndReplaceEqLits) {
                 varReplacer->replace_if_enough_is_found(
@@ -2278,6 +2317,7 @@ lbool Solver::execute_inprocess_strategy(
             cout << "ERROR: strategy '" << token << "' not recognised!" << endl;
             exit(-1);
         }
+        if (token != "" && token.substr(0,3) != "occ") phase_end(token.c_str(), mark);
 
         SLOW_DEBUG_DO(check_stats());
         if (!okay()) return l_False;
@@ -2292,6 +2332,7 @@ lbool Solver::execute_inprocess_strategy(
 */
 lbool Solver::simplify_problem(const bool startup, const string& strategy)
 {
+    CYCLE_PROF_SCOPE(prof_simplify);
     assert(okay());
     #ifdef DEBUG_IMPLICIT_STATS
     check_stats();
@@ -2416,6 +2457,20 @@ void Solver::print_norm_stats(
     print_stats_line("c props/conflict"
         , float_div(propStats.propagations, sumConflicts)
     );
+    if (conf.do_print_times && cons_prop_rate.num > 0) {
+        const double before = cons_prop_rate.sum_before/(double)cons_prop_rate.num;
+        const double after = cons_prop_rate.sum_after/(double)cons_prop_rate.num;
+        print_stats_line("c props/s before consolid."
+            , before
+            , cons_prop_rate.num
+            , "consolidations"
+        );
+        print_stats_line("c props/s after consolid."
+            , after
+            , stats_line_percent(after, before)
+            , "% of before"
+        );
+    }
 
     print_stats_line("c 0-depth assigns", trail.size()
         , stats_line_percent(trail.size(), nVars())
@@ -2598,6 +2653,31 @@ uint64_t Solver::mem_used_vardata() const
     return mem;
 }
 
+void Solver::get_mem_stats(vector<MemStat>& mems) const
+{
+    mems.push_back(MemStat{"longclauses", mem_used_longclauses()});
+    mems.push_back(MemStat{"watch alloc", watches.mem_used_alloc()});
+    mems.push_back(MemStat{"watch array", watches.mem_used_array()});
+    mems.push_back(MemStat{"assings&vardata", mem_used_vardata()});
+    mems.push_back(MemStat{"search&solve", mem_used()});
+    mems.push_back(MemStat{"renumberer", CNF::mem_used_renumberer()});
+    if (occsimplifier) {
+        mems.push_back(MemStat{"occsimplifier", occsimplifier->mem_used()});
+        mems.push_back(MemStat{"xor-finder", occsimplifier->mem_used_xor()});
+    }
+    mems.push_back(MemStat{"varReplacer&SCC", varReplacer->mem_used()});
+    if (ccnr) {
+        mems.push_back(MemStat{"sls", ccnr->mem_used()});
+    }
+    if (subsumeImplicit) {
+        mems.push_back(MemStat{"impl subsume", (uint64_t)subsumeImplicit->mem_used()});
+    }
+    mems.push_back(MemStat{"3 distills", (uint64_t)(
+        distill_long_cls->mem_used()
+        + dist_long_with_impl->mem_used()
+        + dist_impl_with_impl->mem_used())});
+}
+
 void Solver::print_mem_stats() const
 {
     double vm_mem_used = 0;
@@ -2606,91 +2686,20 @@ void Solver::print_mem_stats() const
         , rss_mem_used/(1024UL*1024UL)
         , "MB"
     );
-    uint64_t account = 0;
-
-    account += print_mem_used_longclauses(rss_mem_used);
-    account += print_watch_mem_used(rss_mem_used);
-
-    size_t mem = 0;
-    mem += mem_used_vardata();
-    print_stats_line("c Mem for assings&vardata"
-        , mem/(1024UL*1024UL)
-        , "MB"
-        , stats_line_percent(mem, rss_mem_used)
-        , "%"
-    );
-    account += mem;
-
-    mem = mem_used();
-    print_stats_line("c Mem for search&solve"
-        , mem/(1024UL*1024UL)
-        , "MB"
-        , stats_line_percent(mem, rss_mem_used)
-        , "%"
-    );
-    account += mem;
-
-    mem = CNF::mem_used_renumberer();
-    print_stats_line("c Mem for renumberer"
-        , mem/(1024UL*1024UL)
-        , "MB"
-        , stats_line_percent(mem, rss_mem_used)
-        , "%"
-    );
-    account += mem;
-
-    if (occsimplifier) {
-        mem = occsimplifier->mem_used();
-        print_stats_line("c Mem for occsimplifier"
-            , mem/(1024UL*1024UL)
-            , "MB"
-            , stats_line_percent(mem, rss_mem_used)
-            , "%"
-        );
-        account += mem;
-
-        mem = occsimplifier->mem_used_xor();
-        print_stats_line("c Mem for xor-finder"
-            , mem/(1024UL*1024UL)
-            , "MB"
-            , stats_line_percent(mem, rss_mem_used)
-            , "%"
-        );
-        account += mem;
-    }
-
-    mem = varReplacer->mem_used();
-    print_stats_line("c Mem for varReplacer&SCC"
-        , mem/(1024UL*1024UL)
-        , "MB"
-        , stats_line_percent(mem, rss_mem_used)
-        , "%"
-    );
-    account += mem;
 
-    if (subsumeImplicit) {
-        mem = subsumeImplicit->mem_used();
-        print_stats_line("c Mem for impl subsume"
-            , mem/(1024UL*1024UL)
+    vector<MemStat> mems;
+    get_mem_stats(mems);
+    uint64_t account = 0;
+    for(const auto& m: mems) {
+        print_stats_line("c Mem for " + m.name
+            , m.bytes/(1024UL*1024UL)
             , "MB"
-            , stats_line_percent(mem, rss_mem_used)
+            , stats_line_percent(m.bytes, rss_mem_used)
             , "%"
         );
-        account += mem;
+        account += m.bytes;
     }
 
-
-    mem = distill_long_cls->mem_used();
-    mem += dist_long_with_impl->mem_used();
-    mem += dist_impl_with_impl->mem_used();
-    print_stats_line("c Mem for 3 distills"
-        , mem/(1024UL*1024UL)
-        , "MB"
-        , stats_line_percent(mem, rss_mem_used)
-        , "%"
-    );
-    account += mem;
-
     print_stats_line("c Accounted for mem (rss)"
         , stats_line_percent(account, rss_mem_used)
         , "%"
@@ -2701,6 +2710,29 @@ void Solver::print_mem_stats() const
     );
 }
 
+Solver::PhaseMark Solver::phase_start() const
+{
+    PhaseMark m;
+    m.time = cpuTime();
+    m.free_vars = get_num_free_vars();
+    m.irred_lits = litStats.irredLits + binTri.irredBins*2;
+    m.red_lits = litStats.redLits + binTri.redBins*2;
+    m.conflicts = sumConflicts;
+    return m;
+}
+
+void Solver::phase_end(const char* name, const PhaseMark& start)
+{
+    const PhaseMark now = phase_start();
+    PhaseStat& p = phase_stats[name];
+    p.calls++;
+    p.cpu_time += now.time - start.time;
+    p.free_vars_removed += (int64_t)start.free_vars - (int64_t)now.free_vars;
+    p.irred_lits_removed += (int64_t)start.irred_lits - (int64_t)now.irred_lits;
+    p.red_lits_removed += (int64_t)start.red_lits - (int64_t)now.red_lits;
+    p.conflicts += now.conflicts - start.conflicts;
+}
+
 void Solver::print_clause_size_distrib()
 {
     size_t size3 = 0;
@@ -3127,11 +3159,16 @@ void Solver::add_in_partial_solving_stats()
 }
 
 bool Solver::add_clause_outside(const vector<Lit>& lits, bool red)
+{
+    return add_clause_outside(lits.data(), lits.size(), red);
+}
+
+bool Solver::add_clause_outside(const Lit* lits, size_t num_lits, bool red)
 {
     if (!ok) return false;
 
-    SLOW_DEBUG_DO(check_too_large_variable_number(lits)); //we check for this during back-numbering
-    back_number_from_outside_to_outer(lits);
+    SLOW_DEBUG_DO(check_too_large_variable_number(lits, num_lits)); //we check for this during back-numbering
+    back_number_from_outside_to_outer(lits, num_lits);
     return add_clause_outer(back_number_from_outside_to_outer_tmp, red);
 }
 
@@ -3359,6 +3396,109 @@ lbool Solver::probe_outside(Lit l, uint32_t& min_props)
     return probe_inter<false>(l, min_props);
 }
 
+void Solver::undo_light_until(const uint32_t trail_at)
+{
+    for(uint32_t i = trail_at; i < trail.size(); i++) {
+        assigns[trail[i].lit.var()] = l_Undef;
+    }
+    trail.resize(trail_at);
+    qhead = trail_at;
+}
+
+// Lookahead for the split (cube-and-conquer) search mode. Under "cube"
+// (outside numbering), probes both polarities of the "max_cands" unset
+// variables with the largest watchlists and picks the one maximising the
+// product of the two propagation counts. Failed literals under the cube are
+// propagated and the scan continues. Returns l_False if the cube is refuted.
+// Otherwise "split" is the literal to split on (outside numbering), or
+// lit_Undef if there is nothing left to split on.
+lbool Solver::lookahead_split_lit(
+    const vector<Lit>& cube, const uint32_t max_cands, Lit& split)
+{
+    assert(decisionLevel() == 0);
+    split = lit_Undef;
+    if (!ok) return l_False;
+    if (!prop_at_head()) {
+        ok = propagate<true>().isNULL();
+        if (!ok) return l_False;
+    }
+
+    new_decision_level();
+    for(Lit l: cube) {
+        assert(l.var() < nVarsOutside());
+        l = map_to_with_bva(l);
+        l = varReplacer->get_lit_replaced_with_outer(l);
+        l = map_outer_to_inter(l);
+        if (varData[l.var()].removed != Removed::none) continue;
+        if (value(l) == l_False) {
+            cancelUntil_light();
+            return l_False;
+        }
+        if (value(l) == l_Undef) enqueue_light(l);
+    }
+    if (!propagate_light<false>().isNULL()) {
+        cancelUntil_light();
+        return l_False;
+    }
+
+    lookahead_cands.clear();
+    for(uint32_t v = 0; v < nVars(); v++) {
+        if (value(v) != l_Undef
+            || varData[v].removed != Removed::none
+            || varData[v].is_bva
+        ) continue;
+        const uint32_t occ = watches[Lit(v, false)].size() + watches[Lit(v, true)].size();
+        lookahead_cands.push_back(std::make_pair(occ, v));
+    }
+    const size_t num_cands = std::min<size_t>(max_cands, lookahead_cands.size());
+    std::partial_sort(lookahead_cands.begin(), lookahead_cands.begin() + num_cands,
+        lookahead_cands.end(), std::greater<std::pair<uint32_t, uint32_t>>());
+
+    uint64_t best_score = 0;
+    uint32_t best_var = var_Undef;
+    for(size_t i = 0; i < num_cands; i++) {
+        const uint32_t v = lookahead_cands[i].second;
+        if (value(v) != l_Undef) continue;
+
+        uint32_t props[2];
+        bool failed[2];
+        for(uint32_t sign = 0; sign < 2; sign++) {
+            const uint32_t trail_at = trail.size();
+            enqueue_light(Lit(v, sign));
+            failed[sign] = !propagate_light<false>().isNULL();
+            props[sign] = trail.size() - trail_at;
+            undo_light_until(trail_at);
+        }
+
+        if (failed[0] && failed[1]) {
+            cancelUntil_light();
+            return l_False;
+        }
+        if (failed[0] || failed[1]) {
+            enqueue_light(Lit(v, failed[0]));
+            if (!propagate_light<false>().isNULL()) {
+                cancelUntil_light();
+                return l_False;
+            }
+            continue;
+        }
+
+        const uint64_t score = (uint64_t)props[0]*(uint64_t)props[1];
+        if (best_var == var_Undef || score > best_score) {
+            best_score = score;
+            best_var = v;
+        }
+    }
+    cancelUntil_light();
+
+    if (best_var != var_Undef) {
+        const vector<uint32_t> outer_to_without_bva_map = build_outer_to_without_bva_map();
+        const Lit outer = map_inter_to_outer(Lit(best_var, false));
+        split = Lit(outer_to_without_bva_map[outer.var()], false);
+    }
+    return l_Undef;
+}
+
 bool Solver::add_xor_clause_outside(const vector<uint32_t>& vars, bool rhs)
 {
     if (!ok) {
@@ -3370,7 +3510,7 @@ bool Solver::add_xor_clause_outside(const vector<uint32_t>& vars, bool rhs)
         lits[i] = Lit(vars[i], false);
     }
     #ifdef SLOW_DEBUG //we check for this during back-numbering
-    check_too_large_variable_number(lits);
+    check_too_large_variable_number(lits.data(), lits.size());
     #endif
 
     back_number_from_outside_to_outer(lits);
@@ -3390,7 +3530,7 @@ bool Solver::add_bnn_clause_outside(
     }
 
     #ifdef SLOW_DEBUG //we check for this during back-numbering
-    check_too_large_variable_number(lits);
+    check_too_large_variable_number(lits.data(), lits.size());
     #endif
 
     vector<Lit> lits2(lits);
@@ -3410,9 +3550,10 @@ bool Solver::add_bnn_clause_outside(
     return ok;
 }
 
-void Solver::check_too_large_variable_number(const vector<Lit>& lits) const
+void Solver::check_too_large_variable_number(const Lit* lits, size_t num_lits) const
 {
-    for (const Lit lit: lits) {
+    for (size_t i = 0; i < num_lits; i++) {
+        const Lit lit = lits[i];
         if (lit.var() >= nVarsOutside()) {
             std::cerr
             << "ERROR: Variable " << lit.var() + 1
@@ -3893,13 +4034,23 @@ bool Solver::init_all_matrices()
     assert(decisionLevel() == 0);
 
     assert(gmatrices.size() == gqueuedata.size());
+    vector<char> created(gmatrices.size(), 1);
+    //With FRAT, eliminate() builds BDDs in tbuddy's global node table, which
+    //is not thread-safe
+    if (conf.gaussconf.init_threads > 1 && gmatrices.size() > 1 && !frat->enabled()) {
+        if (!init_matrices_parallel(created)) return false;
+    } else {
+        for (uint32_t i = 0; i < gmatrices.size(); i++) {
+            bool this_created = false;
+            if (!gmatrices[i]->full_init(this_created)) return false;
+            created[i] = this_created;
+        }
+    }
+    assert(okay());
+
     for (uint32_t i = 0; i < gmatrices.size(); i++) {
         auto& g = gmatrices[i];
-        bool created = false;
-        if (!g->full_init(created)) return false;
-        assert(okay());
-
-        if (!created) {
+        if (!created[i]) {
             gqueuedata[i].disabled = true;
             delete g;
             if (conf.verbosity > 5) {
@@ -3940,6 +4091,79 @@ bool Solver::init_all_matrices()
     return okay();
 }
 
+//EGaussian::full_init() of all matrices, in rounds. Filling, watches and
+//propagation are on the solver so they stay on this thread, but the
+//eliminations of a round, where the time goes, run on a pool of threads. A
+//matrix that got units since it was filled is filled again next round.
+bool Solver::init_matrices_parallel(vector<char>& created)
+{
+    //Wall-clock, cpuTime() is per-thread
+    const double my_time = real_time_sec();
+    vector<uint32_t> todo(gmatrices.size());
+    std::iota(todo.begin(), todo.end(), 0);
+    vector<uint32_t> trail_at_fill(gmatrices.size());
+    vector<uint32_t> to_elim;
+    uint32_t rounds = 0;
+
+    while (!todo.empty()) {
+        rounds++;
+        to_elim.clear();
+        for(const uint32_t i: todo) {
+            trail_at_fill[i] = trail_size();
+            if (!gmatrices[i]->init_fill()) {
+                created[i] = 0;
+                continue;
+            }
+            to_elim.push_back(i);
+        }
+        if (!okay()) return false;
+
+        std::atomic<uint32_t> at{0};
+        auto worker = [&]() {
+            uint32_t k;
+            while ((k = at.fetch_add(1)) < to_elim.size()) {
+                gmatrices[to_elim[k]]->eliminate();
+            }
+        };
+        const uint32_t num_threads =
+            std::min<size_t>(conf.gaussconf.init_threads, to_elim.size());
+        vector<std::thread> threads;
+        for(uint32_t t = 1; t < num_threads; t++) {
+            threads.push_back(std::thread(worker));
+        }
+        worker();
+        for(auto& t: threads) t.join();
+
+        todo.clear();
+        for(const uint32_t i: to_elim) {
+            if (units_in_matrix(gmatrices[i], trail_at_fill[i])) {
+                todo.push_back(i);
+                continue;
+            }
+            if (!gmatrices[i]->init_adjust()) return false;
+            if (units_in_matrix(gmatrices[i], trail_at_fill[i])) {
+                todo.push_back(i);
+            } else {
+                gmatrices[i]->init_finish();
+            }
+        }
+    }
+
+    verb_print(1, "[gauss] parallel init of " << gmatrices.size() << " matrices"
+        << " threads: " << conf.gaussconf.init_threads
+        << " rounds: " << rounds
+        << conf.print_times(real_time_sec()-my_time));
+    return okay();
+}
+
+bool Solver::units_in_matrix(const EGaussian* g, const uint32_t from) const
+{
+    for(uint32_t i = from; i < trail_size(); i++) {
+        if (g->in_matrix(trail_at(i).var())) return true;
+    }
+    return false;
+}
+
 void Solver::start_getting_small_clauses(
     const uint32_t max_len, const uint32_t max_glue, bool red, bool bva_vars,
     bool simplified)
@@ -5350,6 +5574,654 @@ void Solver::create_from_solution_reconstruction_data(const string& data)
 }
 #endif
 
+//"CMSSNP" + format version
+static const uint64_t snapshot_magic = 0x02504e53534d43ULL;
+
+struct SnapshotBin {
+    Lit lit1;
+    Lit lit2;
+    int32_t ID;
+    uint32_t red;
+};
+
+//Scalar part of the search state in a checkpoint
+struct SnapshotSearch {
+    //Counters that the restart, reduceDB and inprocessing schedules work off
+    uint64_t sumConflicts;
+    uint64_t sumDecisions;
+    uint64_t sumAntecedents;
+    uint64_t sumPropagations;
+    uint64_t sumConflictClauseLits;
+    uint64_t sumAntecedentsLits;
+    SolveStats solve_stats;
+    uint64_t search_iter_num;
+    double global_timeout_multiplier;
+    uint32_t glue_put_lev0_if_below_or_eq;
+    uint32_t adjusted_glue_cutoff_if_too_many;
+
+    //Inprocessing schedule
+    uint64_t next_lev1_reduce;
+    uint64_t next_lev2_reduce;
+    uint64_t next_pred_reduce;
+    uint64_t next_cls_distill;
+    uint64_t next_bins_distill;
+    uint64_t next_str_impl_with_impl;
+    uint64_t next_full_probe;
+    uint64_t full_probe_iter;
+    uint64_t next_sub_str_with_bin;
+    uint64_t next_intree;
+    uint64_t next_sls;
+    uint32_t num_sls_called;
+
+    //Branching and activities
+    branch branch_strategy;
+    uint32_t branch_strategy_at;
+    uint32_t branch_strategy_change;
+    double var_inc_vsids;
+    double var_decay;
+    double max_vsids_act;
+    double cla_inc;
+    double max_cl_act;
+    uint64_t stats_bumped;
+
+    //Polarities
+    PolarityMode polarity_mode;
+    uint32_t polarity_strategy_at;
+    uint32_t polarity_strategy_change;
+    uint32_t longest_trail_ever_stable;
+    uint32_t longest_trail_ever_best;
+    uint32_t longest_trail_ever_inv;
+
+    //Restarts
+    Restart rest_type;
+    uint32_t restart_strategy_at;
+    uint32_t restart_strategy_change;
+    int64_t increasing_phase_size;
+    int64_t max_confl_this_restart;
+    uint64_t luby_loop_num;
+};
+
+/**
+@brief Writes the simplified problem into a binary snapshot
+
+Everything is written in OUTER numbering, so the loading side does not need
+the renumbering of this solver: it starts from the identity mapping and will
+renumber on its own. Irredundant and learnt clauses (with their tiers and
+stats), level-0 assignments, XORs, the variable-replacement tables and the
+elimination stack are saved, so that a solver loaded from the snapshot can
+both continue solving and extend its solutions to the original problem.
+*/
+void Solver::save_snapshot(const string& fname)
+{
+    const double myTime = cpuTime();
+    SimpleOutFile f;
+    f.start(fname);
+    write_snapshot(f, false);
+
+    verb_print(1, "[snapshot] written to " << fname
+        << " vars: " << nVarsOuter()
+        << " irred cls: " << longIrredCls.size()
+        << " irred bins: " << binTri.irredBins
+        << " red bins: " << binTri.redBins
+        << " elimed vars: " << get_num_vars_elimed()
+        << conf.print_times(cpuTime() - myTime));
+}
+
+static void write_checkpoint_file(
+    const string fname,
+    const vector<char> buf,
+    std::atomic<bool>* writing)
+{
+    //Write-then-rename, so a preempted write never clobbers the last good one
+    const string tmp_fname = fname + ".tmp";
+    std::ofstream out(tmp_fname.c_str(), ios::out | ios::binary);
+    out.write(buf.data(), buf.size());
+    out.close();
+    if (!out || std::rename(tmp_fname.c_str(), fname.c_str()) != 0) {
+        cout << "c WARNING: could not write checkpoint to " << fname << endl;
+    }
+    *writing = false;
+}
+
+/**
+@brief Writes a snapshot plus the state of the search, to resume solving from
+
+Only the in-memory serialisation is done on the calling thread, the file
+itself is written by a helper thread. Call at decision level 0.
+*/
+void Solver::checkpoint(const string& fname)
+{
+    const double myTime = cpuTime();
+    SimpleOutFile f;
+    f.start_buffer();
+    write_snapshot(f, true);
+
+    wait_for_checkpoint_write();
+    ckpt_writing = true;
+    ckpt_writer = std::thread(write_checkpoint_file,
+        fname, std::move(f.get_buffer()), &ckpt_writing);
+
+    size_t num_red_long = 0;
+    for(const auto& lredcls: longRedCls) num_red_long += lredcls.size();
+    verb_print(1, "[checkpoint] writing to " << fname
+        << " confl: " << sumConflicts
+        << " red long cls: " << num_red_long
+        << " red bins: " << binTri.redBins
+        << conf.print_times(cpuTime() - myTime));
+}
+
+void Solver::wait_for_checkpoint_write()
+{
+    if (ckpt_writer.joinable()) ckpt_writer.join();
+}
+
+//Called between search iterations. If the previous checkpoint is still
+//being written, this one is skipped rather than waited for
+void Solver::checkpoint_if_needed()
+{
+    if (conf.checkpoint_fname.empty()
+        || real_time_sec() < ckpt_next_time
+        || ckpt_writing
+        || frat->enabled()
+        || !bnns.empty())
+    {
+        return;
+    }
+    checkpoint(conf.checkpoint_fname);
+    ckpt_next_time = real_time_sec() + conf.checkpoint_every_secs;
+}
+
+void Solver::write_snapshot(SimpleOutFile& f, const bool with_search_state)
+{
+    assert(decisionLevel() == 0);
+    if (frat->enabled()) {
+        cout << "ERROR: snapshots cannot be used together with FRAT" << endl;
+        exit(-1);
+    }
+    if (!bnns.empty()) {
+        cout << "ERROR: snapshots do not support BNN constraints" << endl;
+        exit(-1);
+    }
+
+    //Detached XOR clauses must be reattached and the matrices must give back
+    //their XORs before the clauses can be cleaned and written out. The
+    //matrices are re-built right after, so a checkpoint taken mid-search
+    //costs one matrix build (the same as one inprocessing round) but leaves
+    //the search as it was
+    const bool had_matrices = !gmatrices.empty() && !xor_clauses_updated;
+    if (okay()) clear_gauss_matrices();
+    if (okay()) clauseCleaner->remove_and_clean_all();
+
+    f.put_uint64_t(snapshot_magic);
+    f.put_uint32_t(sizeof(ClauseStats));
+    #if defined(STATS_NEEDED) || defined(FINAL_PREDICTOR)
+    f.put_uint32_t(sizeof(ClauseStatsExtra));
+    #else
+    f.put_uint32_t(0);
+    #endif
+    f.put_uint32_t(with_search_state);
+    f.put_uint32_t(nVarsOuter());
+    f.put_uint32_t(okay());
+    if (okay()) {
+        save_snapshot_bva(f);
+        f.put_uint32_t(clauseID);
+
+        //Per-variable data
+        vector<uint8_t> removed(nVarsOuter());
+        vector<uint8_t> flags(nVarsOuter());
+        vector<Lit> units;
+        for(uint32_t i = 0; i < nVarsOuter(); i++) {
+            const uint32_t outer = interToOuterMain[i];
+            const VarData& dat = varData[i];
+            removed[outer] = (uint8_t)dat.removed;
+            flags[outer] = dat.saved_polarity
+                | dat.stable_polarity << 1
+                | dat.best_polarity << 2
+                | dat.inv_polarity << 3
+                | dat.is_bva << 4;
+            if (assigns[i] != l_Undef) {
+                units.push_back(Lit(outer, assigns[i] == l_False));
+            }
+        }
+        f.put_vector(removed);
+        f.put_vector(flags);
+        f.put_vector(units);
+
+        //Binary clauses, each once
+        vector<SnapshotBin> bins;
+        for(uint32_t i = 0; i < watches.size(); i++) {
+            const Lit lit = Lit::toLit(i);
+            for(const Watched& w: watches[lit]) {
+                if (!w.isBin() || w.lit2() < lit) continue;
+                bins.push_back(SnapshotBin{
+                    map_inter_to_outer(lit), map_inter_to_outer(w.lit2()),
+                    w.get_ID(), w.red()});
+            }
+        }
+        f.put_vector(bins);
+
+        //Long clauses
+        save_snapshot_cls(f, longIrredCls);
+        f.put_uint32_t(longRedCls.size());
+        for(const auto& lredcls: longRedCls) {
+            save_snapshot_cls(f, lredcls);
+        }
+
+        //XORs
+        save_snapshot_xors(f, xorclauses);
+        save_snapshot_xors(f, xorclauses_unused);
+        save_snapshot_xors(f, xorclauses_orig);
+
+        varReplacer->save_snapshot(f);
+        f.put_uint32_t(occsimplifier != NULL);
+        if (occsimplifier) {
+            occsimplifier->save_snapshot(f);
+        }
+        if (with_search_state) {
+            save_search_state(f);
+        }
+    }
+    f.put_uint64_t(snapshot_magic);
+
+    if (had_matrices && okay()) find_and_init_all_matrices();
+}
+
+void Solver::save_snapshot_cls(SimpleOutFile& f, const vector<ClOffset>& cls) const
+{
+    vector<uint32_t> sizes;
+    vector<Lit> lits;
+    vector<ClauseStats> cl_stats;
+    vector<uint8_t> flags;
+    #if defined(STATS_NEEDED) || defined(FINAL_PREDICTOR)
+    vector<ClauseStatsExtra> extra;
+    #endif
+    for(const ClOffset offs: cls) {
+        const Clause& cl = *cl_alloc.ptr(offs);
+        assert(!cl.getRemoved() && !cl.freed());
+        sizes.push_back(cl.size());
+        for(const Lit l: cl) {
+            lits.push_back(map_inter_to_outer(l));
+        }
+        cl_stats.push_back(cl.stats);
+        flags.push_back(cl.used_in_xor()
+            | cl.used_in_xor_full() << 1
+            | cl.distilled << 2
+            | cl.is_ternary_resolved << 3);
+        #if defined(STATS_NEEDED) || defined(FINAL_PREDICTOR)
+        if (cl.red()) {
+            extra.push_back(red_stats_extra[cl.stats.extra_pos]);
+        }
+        #endif
+    }
+    f.put_vector(sizes);
+    f.put_vector(lits);
+    f.put_vector(cl_stats);
+    f.put_vector(flags);
+    #if defined(STATS_NEEDED) || defined(FINAL_PREDICTOR)
+    f.put_vector(extra);
+    #endif
+}
+
+void Solver::save_snapshot_xors(SimpleOutFile& f, const vector<Xor>& xors) const
+{
+    f.put_uint64_t(xors.size());
+    for(const Xor& x: xors) {
+        vector<uint32_t> vars = x.vars;
+        vector<uint32_t> clash_vars = x.clash_vars;
+        map_inter_to_outer(vars);
+        map_inter_to_outer(clash_vars);
+        f.put_uint32_t(x.rhs);
+        f.put_vector(vars);
+        f.put_vector(clash_vars);
+    }
+}
+
+void Solver::save_search_state(SimpleOutFile& f) const
+{
+    SnapshotSearch st = SnapshotSearch();
+    st.sumConflicts = sumConflicts;
+    st.sumDecisions = sumDecisions;
+    st.sumAntecedents = sumAntecedents;
+    st.sumPropagations = sumPropagations;
+    st.sumConflictClauseLits = sumConflictClauseLits;
+    st.sumAntecedentsLits = sumAntecedentsLits;
+    st.solve_stats = solveStats;
+    st.search_iter_num = search_iter_num;
+    st.global_timeout_multiplier = conf.global_timeout_multiplier;
+    st.glue_put_lev0_if_below_or_eq = conf.glue_put_lev0_if_below_or_eq;
+    st.adjusted_glue_cutoff_if_too_many = adjusted_glue_cutoff_if_too_many;
+
+    st.next_lev1_reduce = next_lev1_reduce;
+    st.next_lev2_reduce = next_lev2_reduce;
+    st.next_pred_reduce = next_pred_reduce;
+    st.next_cls_distill = next_cls_distill;
+    st.next_bins_distill = next_bins_distill;
+    st.next_str_impl_with_impl = next_str_impl_with_impl;
+    st.next_full_probe = next_full_probe;
+    st.full_probe_iter = full_probe_iter;
+    st.next_sub_str_with_bin = next_sub_str_with_bin;
+    st.next_intree = next_intree;
+    st.next_sls = next_sls;
+    st.num_sls_called = num_sls_called;
+
+    st.branch_strategy = branch_strategy;
+    st.branch_strategy_at = branch_strategy_at;
+    st.branch_strategy_change = branch_strategy_change;
+    st.var_inc_vsids = var_inc_vsids;
+    st.var_decay = var_decay;
+    st.max_vsids_act = max_vsids_act;
+    st.cla_inc = cla_inc;
+    st.max_cl_act = max_cl_act;
+    st.stats_bumped = stats_bumped;
+
+    st.polarity_mode = polarity_mode;
+    st.polarity_strategy_at = polarity_strategy_at;
+    st.polarity_strategy_change = polarity_strategy_change;
+    st.longest_trail_ever_stable = longest_trail_ever_stable;
+    st.longest_trail_ever_best = longest_trail_ever_best;
+    st.longest_trail_ever_inv = longest_trail_ever_inv;
+
+    st.rest_type = params.rest_type;
+    st.restart_strategy_at = restart_strategy_at;
+    st.restart_strategy_change = restart_strategy_change;
+    st.increasing_phase_size = increasing_phase_size;
+    st.max_confl_this_restart = max_confl_this_restart;
+    st.luby_loop_num = luby_loop_num;
+    f.put_struct(st);
+    f.put_struct(sumSearchStats);
+    f.put_struct(sumPropStats);
+
+    //VSIDS activities and VMTF queue order (by enqueue time), OUTER numbering.
+    //Variables renumbered beyond nVars() are not decided on, they stay 0
+    vector<double> act(nVarsOuter(), 0);
+    vector<uint64_t> btab(nVarsOuter(), 0);
+    for(uint32_t i = 0; i < nVars(); i++) {
+        const uint32_t outer = interToOuterMain[i];
+        act[outer] = var_act_vsids[i];
+        btab[outer] = vmtf_btab[i];
+    }
+    f.put_vector(act);
+    f.put_vector(btab);
+}
+
+//The internal numbering is the identity here, we have just loaded
+void Solver::load_search_state(SimpleInFile& f, const bool apply)
+{
+    SnapshotSearch st;
+    f.get_struct(st);
+    f.get_struct(sumSearchStats);
+    f.get_struct(sumPropStats);
+    vector<double> act;
+    vector<uint64_t> btab;
+    f.get_vector(act);
+    f.get_vector(btab);
+    if (act.size() != nVars() || btab.size() != nVars()) {
+        f.corrupt();
+    }
+    if (!apply) return;
+
+    var_act_vsids = act;
+    vmtf_btab = btab;
+
+    sumConflicts = st.sumConflicts;
+    sumDecisions = st.sumDecisions;
+    sumAntecedents = st.sumAntecedents;
+    sumPropagations = st.sumPropagations;
+    sumConflictClauseLits = st.sumConflictClauseLits;
+    sumAntecedentsLits = st.sumAntecedentsLits;
+    solveStats = st.solve_stats;
+    search_iter_num = st.search_iter_num;
+    conf.global_timeout_multiplier = st.global_timeout_multiplier;
+    conf.glue_put_lev0_if_below_or_eq = st.glue_put_lev0_if_below_or_eq;
+    adjusted_glue_cutoff_if_too_many = st.adjusted_glue_cutoff_if_too_many;
+
+    next_lev1_reduce = st.next_lev1_reduce;
+    next_lev2_reduce = st.next_lev2_reduce;
+    next_pred_reduce = st.next_pred_reduce;
+    next_cls_distill = st.next_cls_distill;
+    next_bins_distill = st.next_bins_distill;
+    next_str_impl_with_impl = st.next_str_impl_with_impl;
+    next_full_probe = st.next_full_probe;
+    full_probe_iter = st.full_probe_iter;
+    next_sub_str_with_bin = st.next_sub_str_with_bin;
+    next_intree = st.next_intree;
+    next_sls = st.next_sls;
+    num_sls_called = st.num_sls_called;
+
+    branch_strategy = st.branch_strategy;
+    branch_strategy_str = branch_type_to_string(branch_strategy);
+    branch_strategy_str_short = branch_strategy_str;
+    branch_strategy_at = st.branch_strategy_at;
+    branch_strategy_change = st.branch_strategy_change;
+    var_inc_vsids = st.var_inc_vsids;
+    var_decay = st.var_decay;
+    max_vsids_act = st.max_vsids_act;
+    cla_inc = st.cla_inc;
+    max_cl_act = st.max_cl_act;
+    stats_bumped = st.stats_bumped;
+
+    polarity_mode = st.polarity_mode;
+    polarity_strategy_at = st.polarity_strategy_at;
+    polarity_strategy_change = st.polarity_strategy_change;
+    longest_trail_ever_stable = st.longest_trail_ever_stable;
+    longest_trail_ever_best = st.longest_trail_ever_best;
+    longest_trail_ever_inv = st.longest_trail_ever_inv;
+
+    params.rest_type = st.rest_type;
+    restart_strategy_at = st.restart_strategy_at;
+    restart_strategy_change = st.restart_strategy_change;
+    increasing_phase_size = st.increasing_phase_size;
+    max_confl_this_restart = st.max_confl_this_restart;
+    luby_loop_num = st.luby_loop_num;
+
+    search_state_restored = true;
+}
+
+/**
+@brief Sets up this (fresh) solver from a snapshot written by save_snapshot()
+
+The internal numbering is the identity after loading, since everything in
+the snapshot is in OUTER numbering. Clauses are attached as-is, without
+re-simplification. If the file is a checkpoint, the search state in it is
+restored too, unless with_search_state is false.
+*/
+void Solver::load_snapshot(const string& fname, const bool with_search_state)
+{
+    if (nVarsOuter() != 0 || !fresh_solver) {
+        cout << "ERROR: snapshots can only be loaded into a fresh solver" << endl;
+        exit(-1);
+    }
+
+    const double myTime = cpuTime();
+    SimpleInFile f;
+    f.start(fname);
+    if (f.get_uint64_t() != snapshot_magic) {
+        cout << "ERROR: file " << fname << " is not a snapshot of this version" << endl;
+        exit(-1);
+    }
+    #if defined(STATS_NEEDED) || defined(FINAL_PREDICTOR)
+    const uint32_t extra_sz = sizeof(ClauseStatsExtra);
+    #else
+    const uint32_t extra_sz = 0;
+    #endif
+    if (f.get_uint32_t() != sizeof(ClauseStats) || f.get_uint32_t() != extra_sz) {
+        cout << "ERROR: snapshot " << fname
+        << " was written by a build with different clause statistics" << endl;
+        exit(-1);
+    }
+
+    fresh_solver = false;
+    const bool has_search_state = f.get_uint32_t();
+    const uint32_t n = f.get_uint32_t();
+    new_vars(n);
+    ok = f.get_uint32_t();
+    if (ok) {
+        load_snapshot_bva(f);
+        clauseID = f.get_uint32_t();
+
+        //Per-variable data
+        vector<uint8_t> removed;
+        vector<uint8_t> flags;
+        vector<Lit> units;
+        f.get_vector(removed);
+        f.get_vector(flags);
+        f.get_vector(units);
+        if (removed.size() != n || flags.size() != n) {
+            f.corrupt();
+        }
+        for(uint32_t i = 0; i < n; i++) {
+            if (removed[i] > (uint8_t)Removed::clashed) f.corrupt();
+            VarData& dat = varData[i];
+            dat.removed = (Removed)removed[i];
+            dat.saved_polarity = flags[i] & 1;
+            dat.stable_polarity = (flags[i] >> 1) & 1;
+            dat.best_polarity = (flags[i] >> 2) & 1;
+            dat.inv_polarity = (flags[i] >> 3) & 1;
+            dat.is_bva = (flags[i] >> 4) & 1;
+        }
+        for(const Lit l: units) {
+            f.check_var(l.var(), n);
+            if (value(l) != l_Undef) f.corrupt();
+            enqueue<false>(l);
+        }
+
+        //Binary clauses
+        vector<SnapshotBin> bins;
+        f.get_vector(bins);
+        for(const auto& b: bins) {
+            f.check_var(b.lit1.var(), n);
+            f.check_var(b.lit2.var(), n);
+            if (b.lit1.var() == b.lit2.var()) f.corrupt();
+            attach_bin_clause(b.lit1, b.lit2, b.red, b.ID, false);
+        }
+
+        //Long clauses
+        load_snapshot_cls(f, false);
+        const uint32_t num_tiers = f.get_uint32_t();
+        if (num_tiers != longRedCls.size()) {
+            cout << "ERROR: snapshot " << fname << " has a different number of learnt clause tiers" << endl;
+            exit(-1);
+        }
+        for(uint32_t i = 0; i < num_tiers; i++) {
+            load_snapshot_cls(f, true);
+        }
+
+        //XORs
+        load_snapshot_xors(f, xorclauses);
+        load_snapshot_xors(f, xorclauses_unused);
+        load_snapshot_xors(f, xorclauses_orig);
+        xor_clauses_updated = true;
+
+        varReplacer->load_snapshot(f);
+        if (f.get_uint32_t()) {
+            if (!occsimplifier) {
+                cout << "ERROR: snapshot " << fname
+                << " contains eliminated variables, occurrence-based simplification must be on to load it" << endl;
+                exit(-1);
+            }
+            occsimplifier->load_snapshot(f);
+        }
+        if (has_search_state) {
+            load_search_state(f, with_search_state);
+        }
+
+        //Clauses were clean when saved, this only sets up the propagation queue
+        ok = propagate<true>().isNULL();
+        rebuildOrderHeap();
+    }
+
+    if (f.get_uint64_t() != snapshot_magic || !f.at_end()) {
+        f.corrupt();
+    }
+
+    verb_print(1, "[snapshot] loaded from " << fname
+        << " search state: " << (has_search_state && with_search_state)
+        << " vars: " << nVarsOuter()
+        << " irred cls: " << longIrredCls.size()
+        << " irred bins: " << binTri.irredBins
+        << " red bins: " << binTri.redBins
+        << " elimed vars: " << get_num_vars_elimed()
+        << conf.print_times(cpuTime() - myTime));
+}
+
+void Solver::load_snapshot_cls(SimpleInFile& f, const bool red)
+{
+    vector<uint32_t> sizes;
+    vector<Lit> lits;
+    vector<ClauseStats> cl_stats;
+    vector<uint8_t> flags;
+    f.get_vector(sizes);
+    f.get_vector(lits);
+    f.get_vector(cl_stats);
+    f.get_vector(flags);
+    #if defined(STATS_NEEDED) || defined(FINAL_PREDICTOR)
+    vector<ClauseStatsExtra> extra;
+    f.get_vector(extra);
+    if (extra.size() != (red ? sizes.size() : 0)) f.corrupt();
+    #endif
+
+    //Everything is checked before the first clause is attached
+    if (cl_stats.size() != sizes.size() || flags.size() != sizes.size()) {
+        f.corrupt();
+    }
+    uint64_t total = 0;
+    for(size_t i = 0; i < sizes.size(); i++) {
+        if (sizes[i] < 3) f.corrupt();
+        if (red && cl_stats[i].which_red_array >= longRedCls.size()) f.corrupt();
+        total += sizes[i];
+    }
+    if (total != lits.size()) f.corrupt();
+    for(const Lit l: lits) {
+        f.check_var(l.var(), nVarsOuter());
+    }
+
+    vector<Lit> ps;
+    size_t at = 0;
+    for(size_t i = 0; i < sizes.size(); i++) {
+        ps.assign(lits.begin() + at, lits.begin() + at + sizes[i]);
+        at += sizes[i];
+
+        Clause* cl = cl_alloc.Clause_new(ps, sumConflicts, cl_stats[i].ID);
+        cl->isRed = red;
+        cl->stats = cl_stats[i];
+        cl->stats.last_touched_any = sumConflicts;
+        cl->set_used_in_xor(flags[i] & 1);
+        cl->set_used_in_xor_full((flags[i] >> 1) & 1);
+        cl->distilled = (flags[i] >> 2) & 1;
+        cl->is_ternary_resolved = (flags[i] >> 3) & 1;
+        #if defined(STATS_NEEDED) || defined(FINAL_PREDICTOR)
+        if (red) {
+            cl->stats.extra_pos = red_stats_extra.size();
+            red_stats_extra.push_back(extra[i]);
+            red_stats_extra.back().introduced_at_conflict = sumConflicts;
+        }
+        #endif
+        attachClause(*cl);
+
+        const ClOffset offs = cl_alloc.get_offset(cl);
+        if (red) {
+            longRedCls[cl->stats.which_red_array].push_back(offs);
+        } else {
+            longIrredCls.push_back(offs);
+        }
+    }
+}
+
+void Solver::load_snapshot_xors(SimpleInFile& f, vector<Xor>& xors)
+{
+    const uint64_t num = f.get_uint64_t();
+    for(uint64_t i = 0; i < num; i++) {
+        const bool rhs = f.get_uint32_t();
+        vector<uint32_t> vars;
+        vector<uint32_t> clash_vars;
+        f.get_vector(vars);
+        f.get_vector(clash_vars);
+        for(const uint32_t v: vars) f.check_var(v, nVarsOuter());
+        for(const uint32_t v: clash_vars) f.check_var(v, nVarsOuter());
+        xors.push_back(Xor(vars, rhs, clash_vars));
+    }
+}
+
 pair<lbool, vector<lbool>> Solver::extend_minimized_model(const vector<lbool>& m)
 {
     if (!ok) return make_pair(l_False, vector<lbool>());
@@ -30,6 +30,8 @@ THE SOFTWARE.
 #include <utility>
 #include <string>
 #include <algorithm>
+#include <thread>
+#include <map>
 
 #include "constants.h"
 #include "solvertypes.h"
@@ -71,10 +73,12 @@ class SubsumeStrengthen;
 class SubsumeImplicit;
 class DataSync;
 class SharedData;
+struct ExternalCallbacks;
 class ReduceDB;
 class InTree;
 class BreakID;
 class GetClauseQuery;
+class CMS_ccnr;
 
 struct SolveStats
 {
@@ -95,6 +99,7 @@ class Solver : public Searcher
         void new_external_var();
         void new_external_vars(size_t n);
         bool add_clause_outside(const vector<Lit>& lits, bool red = false);
+        bool add_clause_outside(const Lit* lits, size_t num_lits, bool red = false);
         bool add_xor_clause_outside(const vector<uint32_t>& vars, bool rhs);
         bool add_bnn_clause_outside(
             const vector<Lit>& lits,
@@ -107,9 +112,13 @@ class Solver : public Searcher
             bool only_indep_solution = false);
         lbool simplify_with_assumptions(const vector<Lit>* _assumptions = NULL, const string* strategy = NULL);
         void  set_shared_data(SharedData* shared_data);
+        void  set_external_callbacks(const ExternalCallbacks& cbs);
         vector<Lit> probe_inter_tmp;
         lbool probe_outside(Lit l, uint32_t& min_props);
+        lbool lookahead_split_lit(
+            const vector<Lit>& cube, uint32_t max_cands, Lit& split);
         void set_max_confl(uint64_t max_confl);
+        void set_interrupt_at_end(bool b) { interrupt_at_end = b; }
 
         //frat for SAT problems
         void add_empty_cl_to_frat();
@@ -159,6 +168,23 @@ class Solver : public Searcher
         size_t get_num_vars_elimed() const;
         uint32_t num_active_vars() const;
         void print_mem_stats() const;
+        void get_mem_stats(vector<MemStat>& mems) const;
+
+        //Per-phase instrumentation. Mark the start of a step, then account
+        //its time and effect to name when it finishes
+        struct PhaseMark {
+            double time;
+            uint64_t free_vars;
+            uint64_t irred_lits;
+            uint64_t red_lits;
+            uint64_t conflicts;
+        };
+        PhaseMark phase_start() const;
+        void phase_end(const char* name, const PhaseMark& start);
+        const std::map<string, PhaseStat>& get_phase_stats() const
+        {
+            return phase_stats;
+        }
         uint64_t print_watch_mem_used(uint64_t totalMem) const;
         const SolveStats& get_solve_stats() const;
         const SearchStats& get_stats() const;
@@ -188,6 +214,7 @@ class Solver : public Searcher
         StrImplWImpl* dist_impl_with_impl = NULL;
         CardFinder*            card_finder = NULL;
         GetClauseQuery*        get_clause_query = NULL;
+        CMS_ccnr*              ccnr = NULL; //kept between SLS calls
 
         SearchStats sumSearchStats;
         PropStats sumPropStats;
@@ -202,6 +229,10 @@ class Solver : public Searcher
         string serialize_solution_reconstruction_data() const;
         void create_from_solution_reconstruction_data(const string& str);
         pair<lbool, vector<lbool>> extend_minimized_model(const vector<lbool>& m);
+        void save_snapshot(const string& fname);
+        void load_snapshot(const string& fname, const bool with_search_state = true);
+        void checkpoint(const string& fname);
+        void wait_for_checkpoint_write();
 
         // Clauses
         bool add_clause_outer_copylits(const vector<Lit>& ps);
@@ -303,6 +334,8 @@ class Solver : public Searcher
 
         // Gauss-Jordan
         bool init_all_matrices();
+        bool init_matrices_parallel(vector<char>& created);
+        bool units_in_matrix(const EGaussian* g, const uint32_t from) const;
         void detach_xor_clauses(
             const set<uint32_t>& clash_vars_unused
         );
@@ -349,6 +382,28 @@ class Solver : public Searcher
         //FRAT
         void write_final_frat_clauses();
 
+        //Snapshots
+        void write_snapshot(SimpleOutFile& f, const bool with_search_state);
+        void save_snapshot_cls(SimpleOutFile& f, const vector<ClOffset>& cls) const;
+        void load_snapshot_cls(SimpleInFile& f, const bool red);
+        void save_snapshot_xors(SimpleOutFile& f, const vector<Xor>& xors) const;
+        void load_snapshot_xors(SimpleInFile& f, vector<Xor>& xors);
+        void save_search_state(SimpleOutFile& f) const;
+        void load_search_state(SimpleInFile& f, const bool apply);
+
+        //Checkpoints: the file is written by ckpt_writer, off the search thread
+        void checkpoint_if_needed();
+        std::thread ckpt_writer;
+        std::atomic<bool> ckpt_writing{false};
+        double ckpt_next_time = 0;
+        bool search_state_restored = false; ///<don't reset per-solve() state once
+
+        //In portfolio mode, the first thread to finish interrupts all the
+        //others. Split-search workers finish once per cube, so they don't.
+        bool interrupt_at_end = true;
+        void undo_light_until(const uint32_t trail_at);
+        vector<std::pair<uint32_t, uint32_t>> lookahead_cands;
+
         struct OracleBin {
             OracleBin (const Lit _l1, const Lit _l2, const int32_t _ID):
                 l1(_l1), l2(_l2), ID(_ID) {}
@@ -409,15 +464,20 @@ class Solver : public Searcher
         void add_every_combination_xor(const vector<Lit>& lits, bool attach, const bool addDrat, const bool red);
         void add_xor_clause_inter_cleaned_cut(const vector<Lit>& lits, bool attach, bool addDrat, const bool red);
         unsigned num_bits_set(const size_t x, const unsigned max_size) const;
-        void check_too_large_variable_number(const vector<Lit>& lits) const;
+        void check_too_large_variable_number(const Lit* lits, size_t num_lits) const;
 
         lbool simplify_problem_outside(const string* strategy = NULL);
         void move_to_outside_assumps(const vector<Lit>* assumps);
         vector<Lit> back_number_from_outside_to_outer_tmp;
         void back_number_from_outside_to_outer(const vector<Lit>& lits)
+        {
+            back_number_from_outside_to_outer(lits.data(), lits.size());
+        }
+        void back_number_from_outside_to_outer(const Lit* lits, size_t num_lits)
         {
             back_number_from_outside_to_outer_tmp.clear();
-            for (const Lit lit: lits) {
+            for (size_t i = 0; i < num_lits; i++) {
+                const Lit lit = lits[i];
                 assert(lit.var() < nVarsOutside());
                 if (get_num_bva_vars() > 0 || !fresh_solver) {
                     back_number_from_outside_to_outer_tmp.push_back(map_to_with_bva(lit));
@@ -460,6 +520,8 @@ class Solver : public Searcher
         lbool simplify_problem(const bool startup, const string& strategy);
         lbool execute_inprocess_strategy(const bool startup, const string& strategy);
         SolveStats solveStats;
+        std::map<string, PhaseStat> phase_stats;
+        size_t search_iter_num = 0;
         void check_minimization_effectiveness(lbool status);
         void check_recursive_minimization_effectiveness(const lbool status);
         void extend_solution(const bool only_indep_solution);
@@ -195,6 +195,7 @@ DLL_PUBLIC SolverConf::SolverConf() :
         , var_linkin_limit_MB(1000)
         , varelim_gate_find_limit(800)
         , varelim_check_resolvent_subs(false)
+        , varelim_threads(1)
 
         //Subs, str limits for simplifier
         , subsumption_time_limitM(300)
@@ -204,6 +205,7 @@ DLL_PUBLIC SolverConf::SolverConf() :
         , subsumption_time_limit_ratio_sub_w_long(0.9)
         , strengthening_time_limitM(300)
         , occ_based_lit_rem_time_limitM(50)
+        , subsume_threads(1)
 
 
         //Ternary resolution
@@ -309,6 +311,8 @@ DLL_PUBLIC SolverConf::SolverConf() :
 
         //WalkSAT
         , doSLS(true)
+        , sls_async(0)
+        , sls_walkers(1)
         , sls_every_n(2)
         , yalsat_max_mems(10)
         , sls_memoutMB(500)
@@ -343,6 +347,9 @@ DLL_PUBLIC SolverConf::SolverConf() :
         , must_renumber    (false)
         , doSaveMem        (true)
         , full_watch_consolidate_every_n_confl (4ULL*1000ULL*1000ULL) //validated in run 8113323.wlm01
+        , clause_alloc_arena (false)
+        , clause_alloc_hugepages (true)
+        , consolidate_order (0)
 
         //Misc optimisations
         , doStrSubImplicit (true)
@@ -371,6 +378,13 @@ DLL_PUBLIC SolverConf::SolverConf() :
 
         //Multi-thread, MPI
         , sync_every_confl(7000) //THREAD syncing
+        , sync_long_max_glue(2)
+        , sync_long_max_size(30)
+        , split_search(false)
+        , split_cubes_per_thread(4)
+        , split_cube_confl(20000)
+        , split_cube_confl_mult(1.5)
+        , split_lookahead_cands(100)
         , every_n_mpi_sync(3) //every N thread sync, we do an MPI sync
         , thread_num(0)
         , is_mpi(false)
@@ -379,9 +393,14 @@ DLL_PUBLIC SolverConf::SolverConf() :
         , oracle_get_learnts(false) // get oracle learnt clauses
         , oracle_removed_is_learnt(false) // clauses removed by Oracle should be learnt
 
+        //Checkpointing
+        , checkpoint_every_secs(600)
+
         //misc
         , origSeed(0)
         , simulate_frat(false)
+        , frat_async(true)
+        , frat_compress(0)
 {
     ratio_keep_clauses[clean_to_int(ClauseClean::glue)] = 0;
     ratio_keep_clauses[clean_to_int(ClauseClean::activity)] = 0.44;
@@ -204,6 +204,7 @@ class GaussConf
     uint32_t max_matrix_rows; //The maximum matrix size -- no. of rows
     uint32_t min_matrix_rows; //The minimum matrix size -- no. of rows
     uint32_t max_num_matrices; //Maximum number of matrices
+    uint32_t init_threads = 1; //Threads eliminating independent matrices at init
 
     //Matrix extraction config
     bool doMatrixFind = true;
@@ -350,6 +351,7 @@ class DLL_PUBLIC SolverConf
         int var_linkin_limit_MB;
         int varelim_gate_find_limit;
         int varelim_check_resolvent_subs;
+        unsigned varelim_threads;
 
         //Subs, str limits for simplifier
         long long subsumption_time_limitM;
@@ -359,6 +361,7 @@ class DLL_PUBLIC SolverConf
         double subsumption_time_limit_ratio_sub_w_long;
         long long strengthening_time_limitM;
         long long occ_based_lit_rem_time_limitM;
+        unsigned subsume_threads;
 
         //Ternary resolution
         bool doTernary;
@@ -417,8 +420,14 @@ class DLL_PUBLIC SolverConf
         //Predictor system
         std::string pred_conf_location;
         std::string pred_tables = "110";
+        #ifdef NATIVE_PREDICTOR_ONLY
+        std::string predictor_type = "native";
+        #else
         std::string predictor_type = "xgb";
+        #endif
         std::string predict_best_feat_fname;
+        uint32_t pred_threads = 0; //0 = predict TIER2 inline, in the search thread
+        uint32_t pred_apply_confl = 2000; //helper threads' results are applied this many conflicts later
         #endif
 
         //Var-replacement
@@ -449,6 +458,8 @@ class DLL_PUBLIC SolverConf
 
         //Walksat
         int doSLS;
+        int sls_async;
+        unsigned sls_walkers;
         uint32_t sls_every_n;
         uint32_t yalsat_max_mems;
         uint32_t sls_memoutMB;
@@ -479,7 +490,10 @@ class DLL_PUBLIC SolverConf
         int       must_renumber; ///< if set, all "renumber" is treated as a "must-renumber"
         int       doSaveMem;
         uint64_t  full_watch_consolidate_every_n_confl;
+        int       clause_alloc_arena; ///< reserve address space for clauses up front, commit on demand
+        int       clause_alloc_hugepages; ///< ask for transparent hugepages for the clause arena
         int must_always_conslidate = 0; // only used for debugging
+        int consolidate_order; ///< 0 = watchlist order, 1 = hot tiers first, each in watchlist order
 
         //Misc Optimisations
         int      doStrSubImplicit;
@@ -509,6 +523,13 @@ class DLL_PUBLIC SolverConf
 
         //Multi-thread, MPI
         unsigned long long sync_every_confl;
+        uint32_t sync_long_max_glue;
+        uint32_t sync_long_max_size;
+        int      split_search;
+        uint32_t split_cubes_per_thread;
+        uint64_t split_cube_confl;
+        double   split_cube_confl_mult;
+        uint32_t split_lookahead_cands;
         uint32_t every_n_mpi_sync;
         unsigned thread_num;
         uint32_t is_mpi;
@@ -517,9 +538,15 @@ class DLL_PUBLIC SolverConf
         int oracle_get_learnts; // get oracle learnt clauses
         int oracle_removed_is_learnt; // clauses removed by Oracle should be learnt
 
+        //Checkpointing
+        std::string checkpoint_fname; ///< if set, a checkpoint is written here periodically
+        double   checkpoint_every_secs; ///< wallclock time between checkpoints
+
         //Misc
         unsigned origSeed;
         int      simulate_frat;
+        int      frat_async; ///< write the FRAT file from a helper thread
+        int      frat_compress; ///< 0 = plain FRAT, 1..9 = gzip at that level
         int      conf_needed = true;
 };
 
@@ -205,6 +205,29 @@ inline double stats_line_percent(double num, double total)
     }
 }
 
+//For names put into JSON strings: quotes, backslashes and control chars
+inline string json_escape(const string& str)
+{
+    std::stringstream ss;
+    for(const char c: str) {
+        switch(c) {
+            case '"': ss << "\\\""; break;
+            case '\\': ss << "\\\\"; break;
+            case '\n': ss << "\\n"; break;
+            case '\r': ss << "\\r"; break;
+            case '\t': ss << "\\t"; break;
+            default:
+                if ((unsigned char)c < 0x20) {
+                    ss << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+                    << (int)c << std::dec << std::setfill(' ');
+                } else {
+                    ss << c;
+                }
+        }
+    }
+    return ss.str();
+}
+
 inline string print_value_kilo_mega(const int64_t value, bool setw = true)
 {
     std::stringstream ss;
@@ -366,6 +389,15 @@ struct PropStats
         varSetNeg += other.varSetNeg;
         varFlipped += other.varFlipped;
         #endif
+        #ifdef PROP_WATCH_STATS
+        watchBin += other.watchBin;
+        watchBNN += other.watchBNN;
+        watchBlocked += other.watchBlocked;
+        watchBlocker2Sat += other.watchBlocker2Sat;
+        watchRead3 += other.watchRead3;
+        watchReadIrred += other.watchReadIrred;
+        watchReadRed += other.watchReadRed;
+        #endif
 
         return *this;
     }
@@ -381,6 +413,15 @@ struct PropStats
         varSetNeg -= other.varSetNeg;
         varFlipped -= other.varFlipped;
         #endif
+        #ifdef PROP_WATCH_STATS
+        watchBin -= other.watchBin;
+        watchBNN -= other.watchBNN;
+        watchBlocked -= other.watchBlocked;
+        watchBlocker2Sat -= other.watchBlocker2Sat;
+        watchRead3 -= other.watchRead3;
+        watchReadIrred -= other.watchReadIrred;
+        watchReadRed -= other.watchReadRed;
+        #endif
 
         return *this;
     }
@@ -446,6 +487,17 @@ struct PropStats
     uint64_t varSetNeg = 0;
     uint64_t varFlipped = 0;
     #endif
+
+    //Watches visited by propagate_any_order(), by type
+    #ifdef PROP_WATCH_STATS
+    uint64_t watchBin = 0;
+    uint64_t watchBNN = 0;
+    uint64_t watchBlocked = 0; ///<Long clause skipped, blocker was true
+    uint64_t watchBlocker2Sat = 0; ///<3-long clause skipped, second blocker was true
+    uint64_t watchRead3 = 0; ///<3-long clause had to be read
+    uint64_t watchReadIrred = 0;
+    uint64_t watchReadRed = 0;
+    #endif
 };
 
 inline void orderLits(
@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include <cassert>
 #include <vector>
 #include <array>
+#include <string>
 #include <algorithm>
 
 namespace CMSat {
@@ -278,6 +279,31 @@ struct FastBackwData {
     uint64_t start_sumConflicts;
 };
 
+//Cumulative cost and effect of one simplification/inprocessing step, see
+//SATSolver::get_instrumentation(). The effects are net changes over the
+//time the step was running, counting binary clauses as 2 literals
+struct PhaseStat {
+    std::string name;
+    uint64_t calls = 0;
+    double cpu_time = 0; ///< seconds, of the thread(s) that ran it
+    int64_t free_vars_removed = 0; ///< set, eliminated or replaced
+    int64_t irred_lits_removed = 0;
+    int64_t red_lits_removed = 0;
+    uint64_t conflicts = 0;
+};
+
+struct MemStat {
+    std::string name;
+    uint64_t bytes = 0;
+};
+
+struct Instrumentation {
+    std::vector<PhaseStat> phases;
+    std::vector<MemStat> mem; ///< current footprint, by component
+    uint64_t rss_bytes = 0;
+    double cpu_time = 0; ///< seconds, all threads
+};
+
 class BNN
 {
 public:
@@ -26,6 +26,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include <string>
 #include <memory>
 #include <cmath>
+#include <type_traits>
 
 using std::numeric_limits;
 
@@ -68,19 +69,30 @@ struct CH {
     }
 };
 
+//Memory that is parsed where it is, e.g. a line of an mmap-ed file. Used
+//as StreamBuffer<MemSpan, MS>, no buffer is allocated or copied into
+struct MemSpan {
+    const char* start;
+    const char* end;
+};
+struct MS {};
+
 template<typename A, typename B>
 class StreamBuffer
 {
     A  in;
     void assureLookahead() {
-        if (pos >= size) {
-            pos  = 0;
-            size = B::read(buf.get(), 1, chunk_limit, in);
+        if constexpr (!std::is_same<B, MS>::value) {
+            if (pos >= size) {
+                pos  = 0;
+                size = B::read(buf.get(), 1, chunk_limit, in);
+            }
         }
     }
     int     pos;
     int     size;
     std::unique_ptr<char[]> buf;
+    const char* at; //buf, or the MemSpan itself
 
     void advance()
     {
@@ -96,13 +108,19 @@ public:
         in(i)
         , pos(0)
         , size(0)
-        , buf(new char[chunk_limit]())
     {
-        assureLookahead();
+        if constexpr (std::is_same<B, MS>::value) {
+            at = in.start;
+            size = in.end - in.start;
+        } else {
+            buf.reset(new char[chunk_limit]());
+            at = buf.get();
+            assureLookahead();
+        }
     }
 
     int  operator *  () {
-        return (pos >= size) ? EOF : buf[pos];
+        return (pos >= size) ? EOF : at[pos];
     }
     void operator ++ () {
         pos++;
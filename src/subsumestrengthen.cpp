@@ -30,6 +30,7 @@ THE SOFTWARE.
 #include "solvertypes.h"
 #include "subsumeimplicit.h"
 #include <array>
+#include <thread>
 
 //#define VERBOSE_DEBUG
 
@@ -44,7 +45,9 @@ SubsumeStrengthen::SubsumeStrengthen(
 {
 }
 
-Sub0Ret SubsumeStrengthen::backw_sub_with_long(const ClOffset offset)
+Sub0Ret SubsumeStrengthen::backw_sub_with_long(
+    const ClOffset offset,
+    const BackwCand* cand)
 {
     Clause& cl = *solver->cl_alloc.ptr(offset);
     assert(!cl.getRemoved());
@@ -54,11 +57,18 @@ Sub0Ret SubsumeStrengthen::backw_sub_with_long(const ClOffset offset)
     cout << "subsume-ing with clause: " << cl << endl;
     #endif
 
-    Sub0Ret ret = subsume_and_unlink(
-        offset
-        , cl
-        , cl.abst
-    );
+    //Candidates found by the helper threads are only ever removed in this
+    //phase, never changed, so they can be used as-is
+    Sub0Ret ret;
+    if (cand) {
+        ret = unlink_subsumed(cand->subs);
+    } else {
+        ret = subsume_and_unlink(
+            offset
+            , cl
+            , cl.abst
+        );
+    }
 
     //If irred is subsumed by redundant, make the redundant into irred
     if (cl.red() && ret.subsumedIrred) {
@@ -103,18 +113,26 @@ Sub0Ret SubsumeStrengthen::subsume_and_unlink(
     , const T& ps
     , const cl_abst_type abs
 ) {
-    Sub0Ret ret;
-
     subs.clear();
     find_subsumed(offset, ps, abs, subs);
 
+    return unlink_subsumed(subs);
+}
+
+Sub0Ret SubsumeStrengthen::unlink_subsumed(const vector<OccurClause>& subsumed)
+{
+    Sub0Ret ret;
+
     //Go through each clause that can be subsumed
-    for (const auto& occ_cl: subs) {
+    for (const auto& occ_cl: subsumed) {
         if (!occ_cl.ws.isClause()) {
             continue;
         }
         ClOffset off = occ_cl.ws.get_offset();
         Clause *tmpcl = solver->cl_alloc.ptr(off);
+        if (tmpcl->getRemoved()) {
+            continue;
+        }
 
         //-> ID kept will be 1st parameter
         //Stats will be merged together here then merged into the
@@ -143,10 +161,9 @@ Sub0Ret SubsumeStrengthen::subsume_and_unlink(
 
 bool SubsumeStrengthen::backw_sub_str_with_long(
     const ClOffset offset,
-    Sub1Ret& ret_sub_str)
+    Sub1Ret& ret_sub_str,
+    const BackwCand* cand)
 {
-    subs.clear();
-    subsLits.clear();
     Clause& cl = *solver->cl_alloc.ptr(offset);
     assert(!cl.getRemoved());
     assert(!cl.freed());
@@ -155,20 +172,27 @@ bool SubsumeStrengthen::backw_sub_str_with_long(
         cout << "backw_sub_str_with_long-ing with clause:" << cl
             << " offset: " << offset << endl;
 
-    find_subsumed_and_strengthened(
-        offset
-        , cl
-        , cl.abst
-        , subs
-        , subsLits
-    );
+    if (!cand) {
+        subs.clear();
+        subsLits.clear();
+        find_subsumed_and_strengthened(
+            offset
+            , cl
+            , cl.abst
+            , subs
+            , subsLits
+            , *simplifier->limit_to_decrease
+        );
+    }
+    const vector<OccurClause>& found = cand ? cand->subs : subs;
+    const vector<Lit>& found_lits = cand ? cand->lits : subsLits;
 
     for (size_t j = 0
-        ; j < subs.size() && solver->okay() && *simplifier->limit_to_decrease > -20LL*1000LL*1000LL
+        ; j < found.size() && solver->okay() && *simplifier->limit_to_decrease > -20LL*1000LL*1000LL
         ; j++
     ) {
-        assert(subs[j].ws.isClause());
-        ClOffset offset2 = subs[j].ws.get_offset();
+        assert(found[j].ws.isClause());
+        ClOffset offset2 = found[j].ws.get_offset();
         Clause& cl2 = *solver->cl_alloc.ptr(offset2);
         if (cl2.used_in_xor() &&
             solver->conf.force_preserve_xors)
@@ -176,7 +200,23 @@ bool SubsumeStrengthen::backw_sub_str_with_long(
             continue;
         }
 
-        if (subsLits[j] == lit_Undef) {  //Subsume
+        //Candidates found by the helper threads may have been changed
+        //(or removed) by the clauses committed before us, so re-check
+        Lit str_lit = found_lits[j];
+        if (cand) {
+            if (cl.getRemoved() || cl.freed()) {
+                break;
+            }
+            if (cl2.getRemoved() || cl2.freed() || cl.size() > cl2.size()) {
+                continue;
+            }
+            str_lit = subset1(cl, cl2, *simplifier->limit_to_decrease);
+            if (str_lit == lit_Error) {
+                continue;
+            }
+        }
+
+        if (str_lit == lit_Undef) {  //Subsume
             VERBOSE_PRINT("subsumed clause " << cl2);
 
             //If subsumes a irred, and is redundant, make it irred
@@ -216,7 +256,7 @@ bool SubsumeStrengthen::backw_sub_str_with_long(
             {
                 continue;
             }
-            if (!simplifier->remove_literal(offset2, subsLits[j], true)) {
+            if (!simplifier->remove_literal(offset2, str_lit, true)) {
                 return false;
             }
             ret_sub_str.str++;
@@ -254,6 +294,9 @@ void SubsumeStrengthen::backw_sub_long_with_long()
     const size_t max_go_through =
         solver->conf.subsume_gothrough_multip*(double)simplifier->clauses.size();
 
+    if (solver->conf.subsume_threads > 1) {
+        backw_sub_long_with_long_par(max_go_through, wenThrough, sub0ret);
+    }
     while (*simplifier->limit_to_decrease > 0
         && wenThrough < max_go_through
     ) {
@@ -318,6 +361,12 @@ bool SubsumeStrengthen::backw_str_long_with_long()
     Sub1Ret ret;
 
     randomise_clauses_order();
+    if (solver->conf.subsume_threads > 1
+        && !backw_str_long_with_long_par(
+            1.5*(double)2*simplifier->clauses.size(), wenThrough, ret))
+    {
+        return false;
+    }
     while(*simplifier->limit_to_decrease > 0
         && wenThrough < 1.5*(double)2*simplifier->clauses.size()
         && solver->okay()
@@ -379,6 +428,131 @@ bool SubsumeStrengthen::backw_str_long_with_long()
     return solver->okay();
 }
 
+void SubsumeStrengthen::collect_backw_batch(
+    const size_t max_go_through,
+    size_t& wenThrough,
+    const int64_t iter_cost,
+    const int64_t cl_cost)
+{
+    //Fixed size, so the result does not depend on the number of threads
+    const size_t max_batch = 1024;
+    if (backw_batch.size() < max_batch) {
+        backw_batch.resize(max_batch);
+    }
+
+    backw_batch_size = 0;
+    while (*simplifier->limit_to_decrease > 0
+        && wenThrough < max_go_through
+        && backw_batch_size < max_batch
+    ) {
+        *simplifier->limit_to_decrease -= iter_cost;
+        wenThrough++;
+
+        const size_t at = wenThrough % simplifier->clauses.size();
+        const ClOffset offset = simplifier->clauses[at];
+        const Clause* cl = solver->cl_alloc.ptr(offset);
+
+        //Has already been removed
+        if (cl->freed() || cl->getRemoved())
+            continue;
+
+        *simplifier->limit_to_decrease -= cl_cost;
+        backw_batch[backw_batch_size++].offset = offset;
+    }
+}
+
+void SubsumeStrengthen::find_backw_batch(const bool str)
+{
+    const uint32_t num_threads = std::min<size_t>(
+        solver->conf.subsume_threads, backw_batch_size);
+    vector<int64_t> costs(num_threads, 0);
+
+    //Nothing is modified until all threads are done, so the occurrence
+    //lists and the clauses can be read without locking
+    auto work = [&](const uint32_t t) {
+        int64_t cost = 0;
+        for(size_t i = t; i < backw_batch_size; i += num_threads) {
+            BackwCand& c = backw_batch[i];
+            c.subs.clear();
+            c.lits.clear();
+            const Clause& cl = *solver->cl_alloc.ptr(c.offset);
+            if (str) {
+                find_subsumed_and_strengthened(
+                    c.offset, cl, cl.abst, c.subs, c.lits, cost);
+            } else {
+                find_subsumed(c.offset, cl, cl.abst, c.subs, false, cost);
+            }
+        }
+        costs[t] = cost;
+    };
+    vector<std::thread> thds;
+    for(uint32_t t = 1; t < num_threads; t++) {
+        thds.push_back(std::thread(work, t));
+    }
+    if (num_threads > 0) {
+        work(0);
+    }
+    for(auto& t: thds) {
+        t.join();
+    }
+
+    //Costs were decremented from zero, just like the limit itself
+    for(const int64_t cost: costs) {
+        *simplifier->limit_to_decrease += cost;
+    }
+}
+
+void SubsumeStrengthen::backw_sub_long_with_long_par(
+    const size_t max_go_through,
+    size_t& wenThrough,
+    Sub0Ret& ret)
+{
+    while (*simplifier->limit_to_decrease > 0
+        && wenThrough < max_go_through
+    ) {
+        collect_backw_batch(max_go_through, wenThrough, 3, 10);
+        find_backw_batch(false);
+        for(size_t i = 0; i < backw_batch_size; i++) {
+            const BackwCand& c = backw_batch[i];
+            const Clause* cl = solver->cl_alloc.ptr(c.offset);
+
+            //Subsumed by a clause earlier in the batch
+            if (cl->freed() || cl->getRemoved())
+                continue;
+
+            ret += backw_sub_with_long(c.offset, &c);
+        }
+    }
+}
+
+bool SubsumeStrengthen::backw_str_long_with_long_par(
+    const size_t max_go_through,
+    size_t& wenThrough,
+    Sub1Ret& ret)
+{
+    while (*simplifier->limit_to_decrease > 0
+        && wenThrough < max_go_through
+        && solver->okay()
+    ) {
+        collect_backw_batch(max_go_through, wenThrough, 10, 0);
+        find_backw_batch(true);
+        for(size_t i = 0; i < backw_batch_size; i++) {
+            const BackwCand& c = backw_batch[i];
+            const Clause* cl = solver->cl_alloc.ptr(c.offset);
+
+            //Subsumed or shortened to a binary earlier in the batch
+            if (cl->freed() || cl->getRemoved())
+                continue;
+
+            if (!backw_sub_str_with_long(c.offset, ret, &c)) {
+                return false;
+            }
+        }
+    }
+
+    return solver->okay();
+}
+
 /**
 @brief Helper function for find_subsumed_and_strengthened
 
@@ -393,7 +567,8 @@ void inline SubsumeStrengthen::fill_sub_str(
     , vector<Lit>& out_lits
     , const Lit lit // this variable is in the "cl", but may be inverted
     , bool inverted // whether "lit" is inverted
-) {
+    , int64_t& limit
+) const {
     Lit litSub;
     uint32_t num_bin_found = 0;
     watch_subarray_const cs = solver->watches[lit];
@@ -409,7 +584,7 @@ void inline SubsumeStrengthen::fill_sub_str(
         }
     }
 
-    *simplifier->limit_to_decrease -= (long)cs.size()*2+ 40;
+    limit -= (long)cs.size()*2+ 40;
     for (const auto& w: cs) {
         if (w.isBin()) {
             if (cl.size() > 2) {
@@ -455,8 +630,8 @@ void inline SubsumeStrengthen::fill_sub_str(
             continue;
         }
 
-        *simplifier->limit_to_decrease -= (long)((cl.size() + cl2.size())/4);
-        litSub = subset1(cl, cl2);
+        limit -= (long)((cl.size() + cl2.size())/4);
+        litSub = subset1(cl, cl2, limit);
         if (litSub != lit_Error) {
             out_subsumed.push_back(OccurClause(lit, w));
             out_lits.push_back(litSub);
@@ -493,7 +668,8 @@ void SubsumeStrengthen::find_subsumed_and_strengthened(
     , const cl_abst_type abs
     , vector<OccurClause>& out_subsumed
     , vector<Lit>& out_lits
-)
+    , int64_t& limit
+) const
 {
     #ifdef VERBOSE_DEBUG
     cout << "find_subsumed_and_strengthened: " << cl << endl;
@@ -512,10 +688,10 @@ void SubsumeStrengthen::find_subsumed_and_strengthened(
         }
     }
     assert(minLit != lit_Undef);
-    *simplifier->limit_to_decrease -= (long)cl.size();
+    limit -= (long)cl.size();
 
-    fill_sub_str(offset, cl, abs, out_subsumed, out_lits, minLit, false);
-    fill_sub_str(offset, cl, abs, out_subsumed, out_lits, ~minLit, true);
+    fill_sub_str(offset, cl, abs, out_subsumed, out_lits, minLit, false, limit);
+    fill_sub_str(offset, cl, abs, out_subsumed, out_lits, ~minLit, true, limit);
 }
 
 //must be called from deal_with_added_long_and_bin
@@ -581,7 +757,7 @@ bool SubsumeStrengthen::handle_added_long_cl(const bool verbose)
 
 //A subsumes B (A <= B)
 template<class T1, class T2>
-bool SubsumeStrengthen::subset(const T1& A, const T2& B)
+bool SubsumeStrengthen::subset(const T1& A, const T2& B, int64_t& limit) const
 {
     #ifdef MORE_DEUBUG
     cout << "A:" << A << endl;
@@ -622,7 +798,7 @@ bool SubsumeStrengthen::subset(const T1& A, const T2& B)
     ret = false;
 
     end:
-    *simplifier->limit_to_decrease -= (long)i2*4 + (long)i*4;
+    limit -= (long)i2*4 + (long)i*4;
     return ret;
 }
 
@@ -640,7 +816,7 @@ clause B
 and returns the literal to remove if (2) is true
 */
 template<class T1, class T2>
-Lit SubsumeStrengthen::subset1(const T1& A, const T2& B)
+Lit SubsumeStrengthen::subset1(const T1& A, const T2& B, int64_t& limit) const
 {
     Lit retLit = lit_Undef;
 
@@ -672,12 +848,13 @@ Lit SubsumeStrengthen::subset1(const T1& A, const T2& B)
     retLit = lit_Error;
 
     end:
-    *simplifier->limit_to_decrease -= (long)i2*4 + (long)i*4;
+    limit -= (long)i2*4 + (long)i*4;
     return retLit;
 }
 
 template<class T>
-uint32_t SubsumeStrengthen::find_smallest_watchlist_for_clause(const T& ps) const
+uint32_t SubsumeStrengthen::find_smallest_watchlist_for_clause(
+    const T& ps, int64_t& limit) const
 {
     uint32_t min_i = 0;
     size_t min_num = solver->watches[ps[min_i]].size();
@@ -688,7 +865,7 @@ uint32_t SubsumeStrengthen::find_smallest_watchlist_for_clause(const T& ps) cons
             min_num = this_num;
         }
     }
-    *simplifier->limit_to_decrease -= (long)ps.size();
+    limit -= (long)ps.size();
 
     return min_i;
 }
@@ -706,6 +883,18 @@ template<class T> void SubsumeStrengthen::find_subsumed(
     , vector<OccurClause>& out_subsumed //List of clauses
     , bool only_irred
 ) {
+    find_subsumed(offset, ps, abs, out_subsumed, only_irred, *simplifier->limit_to_decrease);
+}
+
+//Only reads the occurrence lists, so it can be called from the helper threads
+template<class T> void SubsumeStrengthen::find_subsumed(
+    const ClOffset offset
+    , const T& ps
+    , const cl_abst_type abs
+    , vector<OccurClause>& out_subsumed
+    , bool only_irred
+    , int64_t& limit
+) const {
     #ifdef VERBOSE_DEBUG
     cout << "find_subsumed: ";
     for (const Lit lit: ps) {
@@ -714,12 +903,12 @@ template<class T> void SubsumeStrengthen::find_subsumed(
     cout << endl;
     #endif
 
-    const uint32_t smallest = find_smallest_watchlist_for_clause(ps);
+    const uint32_t smallest = find_smallest_watchlist_for_clause(ps, limit);
     const Lit lit = ps[smallest];
 
     //Go through the occur list of the literal that has the smallest occur list
-    watch_subarray occ = solver->watches[lit];
-    *simplifier->limit_to_decrease -= (long)occ.size()*8 + 40;
+    watch_subarray_const occ = solver->watches[lit];
+    limit -= (long)occ.size()*8 + 40;
 
     //cout << "find_subsumed going through: " << solver->watches_to_string(lit, occ) << endl;
     for (const auto& w: occ) {
@@ -735,7 +924,7 @@ template<class T> void SubsumeStrengthen::find_subsumed(
             continue;
         }
 
-        *simplifier->limit_to_decrease -= 15;
+        limit -= 15;
 
         if (w.get_offset() == offset
             || !subsetAbst(abs, w.getAbst())
@@ -744,7 +933,7 @@ template<class T> void SubsumeStrengthen::find_subsumed(
         }
 
         const ClOffset offset2 = w.get_offset();
-        Clause& cl2 = *solver->cl_alloc.ptr(offset2);
+        const Clause& cl2 = *solver->cl_alloc.ptr(offset2);
 
         if (ps.size() > cl2.size() ||
             cl2.getRemoved() ||
@@ -753,8 +942,8 @@ template<class T> void SubsumeStrengthen::find_subsumed(
             continue;
         }
 
-        *simplifier->limit_to_decrease -= 50;
-        if (subset(ps, cl2)) {
+        limit -= 50;
+        if (subset(ps, cl2, limit)) {
             out_subsumed.push_back(OccurClause(lit, w));
             #ifdef VERBOSE_DEBUG
             cout << "subsumed cl offset: " << offset2 << endl;
@@ -782,6 +971,10 @@ size_t SubsumeStrengthen::mem_used() const
     size_t b = 0;
     b += subs.capacity()*sizeof(ClOffset);
     b += subsLits.capacity()*sizeof(Lit);
+    for(const auto& c: backw_batch) {
+        b += c.subs.capacity()*sizeof(OccurClause);
+        b += c.lits.capacity()*sizeof(Lit);
+    }
 
     return b;
 }
@@ -815,6 +1008,7 @@ bool SubsumeStrengthen::backw_sub_str_with_impl(
         , calcAbstraction(lits)
         , subs
         , subsLits
+        , *simplifier->limit_to_decrease
     );
 
     for (size_t j = 0
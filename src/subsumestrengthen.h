@@ -51,7 +51,17 @@ public:
     void remove_binary_cl(const OccurClause& cl);
 
 
-    Sub0Ret backw_sub_with_long(const ClOffset offset);
+    //Candidates found for one clause by the helper threads
+    struct BackwCand
+    {
+        ClOffset offset;
+        vector<OccurClause> subs;
+        vector<Lit> lits;
+    };
+
+    Sub0Ret backw_sub_with_long(
+        const ClOffset offset,
+        const BackwCand* cand = nullptr);
 
     void backw_sub_with_impl(
         const vector<Lit>& lits,
@@ -62,7 +72,8 @@ public:
         Sub1Ret& ret_sub_str);
     bool backw_sub_str_with_long(
         ClOffset offset,
-        Sub1Ret& ret_sub_str);
+        Sub1Ret& ret_sub_str,
+        const BackwCand* cand = nullptr);
 
     struct Stats
     {
@@ -90,6 +101,16 @@ public:
         , const bool only_irred = false
     );
 
+    template<class T>
+    void find_subsumed(
+        const ClOffset offset
+        , const T& ps
+        , const cl_abst_type abs
+        , vector<OccurClause>& out_subsumed
+        , const bool only_irred
+        , int64_t& limit
+    ) const;
+
 private:
     Stats globalstats;
     Stats runStats;
@@ -104,11 +125,25 @@ private:
         , const T& ps
         , const cl_abst_type abs
     );
+    Sub0Ret unlink_subsumed(const vector<OccurClause>& subsumed);
 
     void randomise_clauses_order();
 
+    //Multi-threaded backward sub/str. Candidates are searched for in batches
+    //on helper threads, modifications are made in order on this thread
+    void backw_sub_long_with_long_par(const size_t max_go_through, size_t& wenThrough, Sub0Ret& ret);
+    bool backw_str_long_with_long_par(const size_t max_go_through, size_t& wenThrough, Sub1Ret& ret);
+    void collect_backw_batch(
+        const size_t max_go_through,
+        size_t& wenThrough,
+        const int64_t iter_cost,
+        const int64_t cl_cost);
+    void find_backw_batch(const bool str);
+    vector<BackwCand> backw_batch;
+    size_t backw_batch_size = 0;
+
     template<class T>
-    uint32_t find_smallest_watchlist_for_clause(const T& ps) const;
+    uint32_t find_smallest_watchlist_for_clause(const T& ps, int64_t& limit) const;
 
     template<class T>
     void find_subsumed_and_strengthened(
@@ -117,7 +152,8 @@ private:
         , const cl_abst_type abs
         , vector<OccurClause>& out_subsumed
         , vector<Lit>& out_lits
-    );
+        , int64_t& limit
+    ) const;
 
     template<class T>
     void fill_sub_str(
@@ -128,13 +164,14 @@ private:
         , vector<Lit>& out_lits
         , const Lit lit
         , const bool inverted
-    );
+        , int64_t& limit
+    ) const;
 
     template<class T1, class T2>
-    bool subset(const T1& A, const T2& B);
+    bool subset(const T1& A, const T2& B, int64_t& limit) const;
 
     template<class T1, class T2>
-    Lit subset1(const T1& A, const T2& B);
+    Lit subset1(const T1& A, const T2& B, int64_t& limit) const;
 
     vector<OccurClause> subs;
     vec<Watched> tmp;
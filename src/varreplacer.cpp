@@ -99,6 +99,43 @@ void VarReplacer::save_on_var_memory()
 {
 }
 
+void VarReplacer::save_snapshot(SimpleOutFile& f) const
+{
+    f.put_vector(table);
+    f.put_uint64_t(reverseTable.size());
+    for(const auto& it: reverseTable) {
+        f.put_uint32_t(it.first);
+        f.put_vector(it.second);
+    }
+    f.put_uint64_t(replacedVars);
+}
+
+void VarReplacer::load_snapshot(SimpleInFile& f)
+{
+    table.clear();
+    f.get_vector(table);
+    const uint32_t n = solver->nVarsOuter();
+    if (table.size() != n) f.corrupt();
+    for(const Lit l: table) {
+        f.check_var(l.var(), n);
+    }
+
+    reverseTable.clear();
+    const uint64_t num = f.get_uint64_t();
+    for(uint64_t i = 0; i < num; i++) {
+        const uint32_t var = f.get_uint32_t();
+        f.check_var(var, n);
+        vector<uint32_t>& replaced = reverseTable[var];
+        if (!replaced.empty()) f.corrupt();
+        f.get_vector(replaced);
+        for(const uint32_t v: replaced) {
+            f.check_var(v, n);
+        }
+    }
+    replacedVars = f.get_uint64_t();
+    if (replacedVars > n) f.corrupt();
+}
+
 void VarReplacer::updateVars(
     const std::vector< uint32_t >& /*outerToInter*/
     , const std::vector< uint32_t >& /*interToOuter*/
@@ -761,7 +798,12 @@ bool VarReplacer::handleUpdatedClause(
         if (at2 != NULL) {
             std::swap(c[1], *at2);
         }
-        if (at != NULL && at2 != NULL) {
+        bool keep_watches = (at != NULL && at2 != NULL);
+        #ifdef TERNARY_SECOND_BLOCKER
+        //Watches of 3-long clauses carry their literals, re-attach
+        keep_watches &= (c.size() > 3);
+        #endif
+        if (keep_watches) {
             delayed_attach_or_free.pop_back();
             if (c.red()) {
                 solver->litStats.redLits += c.size();
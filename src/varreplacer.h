@@ -76,6 +76,9 @@ class VarReplacer
         uint32_t get_var_replaced_with_outer(uint32_t var) const;
         bool var_is_replacing(const uint32_t var);
 
+        void save_snapshot(SimpleOutFile& f) const;
+        void load_snapshot(SimpleInFile& f);
+
 #ifdef ARJUN_SERIALIZE
         template<class T> void unserialize_tables(T& ar);
         template<class T> void serialize_tables  (T& ar) const;
@@ -64,6 +64,27 @@ class Watched {
         {
         }
 
+        /**
+        @brief Constructor for a 3-long clause, with a second blocked literal
+
+        Both blockedLit and otherLit must be literals of the clause, so that if
+        either is satisfied, the clause can be skipped without dereferencing it.
+        The clause itself is still needed to propagate or re-watch it.
+        Without TERNARY_SECOND_BLOCKER, otherLit is dropped.
+        */
+        Watched(const ClOffset offset, Lit blockedLit, Lit otherLit) :
+            data1(blockedLit.toInt())
+            #ifdef TERNARY_SECOND_BLOCKER
+            , data3(otherLit.toInt())
+            #endif
+            , type(static_cast<int>(WatchType::watch_clause_t))
+            , data2(offset)
+        {
+            #ifndef TERNARY_SECOND_BLOCKER
+            (void)otherLit;
+            #endif
+        }
+
         /**
         @brief Constructor for a long (>2) clause
         */
@@ -238,6 +259,50 @@ class Watched {
             return data1;
         }
 
+        /**
+        @brief Whether this watches a 3-long clause with a second blocked literal
+        */
+        bool hasSecondBlocker() const
+        {
+            #ifdef TERNARY_SECOND_BLOCKER
+            return data3 != (var_Undef << 1);
+            #else
+            return false;
+            #endif
+        }
+
+        /**
+        @brief Get the literal of a 3-long clause that is neither watched nor blocked
+        */
+        Lit getSecondBlocker() const
+        {
+            DEBUG_WATCHED_DO(assert(hasSecondBlocker()));
+            #ifdef TERNARY_SECOND_BLOCKER
+            return Lit::toLit(data3);
+            #else
+            return lit_Undef;
+            #endif
+        }
+
+        void setSecondBlocker(const Lit lit)
+        {
+            DEBUG_WATCHED_DO(assert(isClause()));
+            #ifdef TERNARY_SECOND_BLOCKER
+            data3 = lit.toInt();
+            #else
+            (void)lit;
+            #endif
+        }
+
+        /**
+        @brief Update the offset of a normal long clause, e.g. when moved during consolidation
+        */
+        void setOffset(const ClOffset offset)
+        {
+            DEBUG_WATCHED_DO(assert(isClause()));
+            data2 = offset;
+        }
+
         /**
         @brief Get offset of a >3-long normal clause or of an xor clause (which may be 3-long)
         */
@@ -259,6 +324,9 @@ class Watched {
 
     private:
         uint32_t data1;
+        #ifdef TERNARY_SECOND_BLOCKER
+        uint32_t data3 = (var_Undef << 1); ///<second blocker of 3-long clause, or lit_Undef
+        #endif
         ClOffset type:2;
         ClOffset data2:EFFECTIVELY_USEABLE_BITS;
 };
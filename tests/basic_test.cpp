@@ -26,6 +26,7 @@ THE SOFTWARE.
 
 #include "cryptominisat5/cryptominisat.h"
 #include "src/solverconf.h"
+#include "src/solvertypes.h"
 #include "test_helper.h"
 #include <vector>
 
@@ -723,6 +724,69 @@ TEST(error_throw, toomany_vars_single)
         , CMSat::TooManyVarsError);
 }
 
+TEST(error_throw, add_clauses_var_too_large)
+{
+    SATSolver s;
+    s.new_vars(3);
+    vector<Lit> lits = {Lit(0, false), lit_Undef, Lit(1, true), Lit(3, false)};
+
+    EXPECT_THROW({
+        s.add_clauses(lits.data(), lits.size());}
+        , std::runtime_error);
+
+    //Nothing has been added, not even the first clause
+    s.add_clause(vector<Lit>{Lit(0, true)});
+    EXPECT_EQ(s.solve(), l_True);
+}
+
+TEST(error_throw, add_clauses_var_too_large_multithread)
+{
+    SATSolver s;
+    s.set_num_threads(2);
+    s.new_vars(3);
+    vector<Lit> lits = {Lit(0, false), lit_Undef, Lit(10, true)};
+
+    EXPECT_THROW({
+        s.add_clauses(lits.data(), lits.size());}
+        , std::runtime_error);
+}
+
+TEST(no_error_throw, add_clauses)
+{
+    SATSolver s;
+    s.set_num_threads(2);
+    s.new_vars(3);
+    vector<Lit> lits = {Lit(0, false), lit_Undef, Lit(0, true), Lit(2, false)};
+    s.add_clauses(lits.data(), lits.size());
+    EXPECT_EQ(s.solve(), l_True);
+    EXPECT_EQ(s.get_model()[0], l_True);
+    EXPECT_EQ(s.get_model()[2], l_True);
+}
+
+TEST(no_error_throw, add_clauses_small_batches_multithread)
+{
+    //Small batches are cached, mixed with add_clause() and XORs
+    SATSolver s;
+    s.set_num_threads(3);
+    s.new_vars(20);
+    s.add_clause(vector<Lit>{Lit(0, false)});
+    for(uint32_t i = 0; i+1 < 20; i++) {
+        vector<Lit> lits = {Lit(i, true), Lit(i+1, false), lit_Undef};
+        s.add_clauses(lits.data(), lits.size());
+        if (i % 5 == 0) {
+            s.add_xor_clause(vector<unsigned>{i, i+1}, false);
+        }
+    }
+    EXPECT_EQ(s.solve(), l_True);
+    for(uint32_t i = 0; i < 20; i++) {
+        EXPECT_EQ(s.get_model()[i], l_True);
+    }
+
+    vector<Lit> lits = {Lit(19, true)};
+    s.add_clauses(lits.data(), lits.size());
+    EXPECT_EQ(s.solve(), l_False);
+}
+
 TEST(no_error_throw, long_clause)
 {
     SATSolver s;
@@ -1393,6 +1457,33 @@ TEST(xor_recovery, DISABLED_find_xor_renumber)
 }
 
 
+TEST(instrumentation, json_escape)
+{
+    EXPECT_EQ(json_escape("occ-bve"), "occ-bve");
+    EXPECT_EQ(json_escape("a\"b"), "a\\\"b");
+    EXPECT_EQ(json_escape("a\\b"), "a\\\\b");
+    EXPECT_EQ(json_escape("a\nb\tc"), "a\\nb\\tc");
+    EXPECT_EQ(json_escape(string("a\x01" "b")), "a\\u0001b");
+}
+
+TEST(instrumentation, json_has_every_phase)
+{
+    SATSolver s;
+    s.new_vars(30);
+    for(const auto& cl: random_3sat(30, 120, 4)) s.add_clause(cl);
+    s.solve();
+
+    const Instrumentation ins = s.get_instrumentation();
+    const string json = s.get_instrumentation_json();
+    EXPECT_FALSE(ins.phases.empty());
+    for(const auto& p: ins.phases) {
+        EXPECT_NE(json.find("{\"name\": \"" + json_escape(p.name) + "\""), string::npos);
+    }
+    for(const auto& m: ins.mem) {
+        EXPECT_NE(json.find("{\"name\": \"" + json_escape(m.name) + "\""), string::npos);
+    }
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
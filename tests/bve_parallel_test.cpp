@@ -0,0 +1,125 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#include "gtest/gtest.h"
+
+#include "cryptominisat5/cryptominisat.h"
+#include "src/solverconf.h"
+#include "test_helper.h"
+
+using namespace CMSat;
+
+//Random 3-SAT with many binaries, so that weakening has implications to
+//follow between the vars that are eliminated together
+static vector<vector<Lit>> mixed(uint32_t num_vars, uint32_t num_3, uint32_t num_2, uint32_t seed)
+{
+    vector<vector<Lit>> cls = random_3sat(num_vars, num_3, seed);
+    std::mt19937 rnd(seed+1000);
+    for(uint32_t i = 0; i < num_2; i++) {
+        const uint32_t v1 = rnd() % num_vars;
+        const uint32_t v2 = rnd() % num_vars;
+        if (v1 == v2) continue;
+        cls.push_back({Lit(v1, rnd() & 1), Lit(v2, rnd() & 1)});
+    }
+    return cls;
+}
+
+static lbool solve(const vector<vector<Lit>>& cls, uint32_t num_vars
+    , uint32_t varelim_threads, vector<lbool>& model)
+{
+    SolverConf conf;
+    conf.varelim_threads = varelim_threads;
+    conf.simplify_at_startup = true;
+    SATSolver s(&conf);
+    s.new_vars(num_vars);
+    for(const auto& cl: cls) s.add_clause(cl);
+    const lbool ret = s.solve();
+    if (ret == l_True) model = s.get_model();
+    return ret;
+}
+
+static void check_same(const vector<vector<Lit>>& cls, uint32_t num_vars)
+{
+    vector<lbool> model;
+    const lbool serial = solve(cls, num_vars, 1, model);
+    for(const uint32_t threads: {2U, 4U}) {
+        const lbool par = solve(cls, num_vars, threads, model);
+        EXPECT_EQ(par, serial);
+        if (par == l_True) {
+            EXPECT_TRUE(model_satisfies(cls, model));
+        }
+    }
+}
+
+TEST(bve_parallel, random_3sat)
+{
+    for(uint32_t seed = 0; seed < 10; seed++) {
+        //Around the threshold, so both SAT and UNSAT come up
+        check_same(random_3sat(120, 510, seed), 120);
+    }
+}
+
+TEST(bve_parallel, with_binaries)
+{
+    for(uint32_t seed = 0; seed < 10; seed++) {
+        check_same(mixed(200, 500, 150 + seed*10, seed), 200);
+    }
+}
+
+TEST(bve_parallel, pigeonhole)
+{
+    check_same(pigeonhole(7), 7*6);
+}
+
+TEST(bve_parallel, incremental)
+{
+    //Clauses added after elimination bring eliminated vars back
+    for(uint32_t seed = 0; seed < 5; seed++) {
+        const vector<vector<Lit>> cls = mixed(150, 300, 150, seed);
+        const vector<vector<Lit>> more = random_3sat(150, 300, seed+100);
+        vector<lbool> models[2];
+        lbool rets[2];
+        for(uint32_t i = 0; i < 2; i++) {
+            SolverConf conf;
+            conf.varelim_threads = i == 0 ? 1 : 4;
+            conf.simplify_at_startup = true;
+            SATSolver s(&conf);
+            s.new_vars(150);
+            for(const auto& cl: cls) s.add_clause(cl);
+            s.solve();
+            for(const auto& cl: more) s.add_clause(cl);
+            rets[i] = s.solve();
+            if (rets[i] == l_True) {
+                models[i] = s.get_model();
+                EXPECT_TRUE(model_satisfies(cls, models[i]));
+                EXPECT_TRUE(model_satisfies(more, models[i]));
+            }
+        }
+        EXPECT_EQ(rets[0], rets[1]);
+    }
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
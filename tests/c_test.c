@@ -57,6 +57,47 @@ int main(void) {
     assert(model.vals[1].x == L_FALSE);
     assert(model.vals[2].x == L_TRUE);
 
+    cmsat_free(solver);
+
+    //The same, in bulk, terminators are lit_Undef
+    c_Lit term;
+    term.x = CMSAT_LIT_UNDEF;
+    c_Lit cls[] = {
+        new_lit(0, false), term,
+        new_lit(1, true), term,
+        new_lit(0, true), new_lit(1, false), new_lit(2, false)
+    };
+    solver = cmsat_new();
+    cmsat_new_vars(solver, 3);
+    assert(cmsat_add_clauses(solver, cls, sizeof(cls)/sizeof(cls[0])));
+    ret = cmsat_solve(solver);
+    assert(ret.x == L_TRUE);
+    model = cmsat_get_model(solver);
+    assert(model.vals[0].x == L_TRUE);
+    assert(model.vals[1].x == L_FALSE);
+    assert(model.vals[2].x == L_TRUE);
+
+    //With UNSAT in bulk, multi-threaded
+    c_Lit cls2[] = {new_lit(0, false), term, new_lit(0, true), term};
+    cmsat_free(solver);
+    solver = cmsat_new();
+    cmsat_set_num_threads(solver, 2);
+    cmsat_new_vars(solver, 1);
+    cmsat_add_clauses(solver, cls2, 4);
+    ret = cmsat_solve(solver);
+    assert(ret.x == L_FALSE);
+    cmsat_free(solver);
+
+    //Out of range variable, nothing is added
+    c_Lit cls3[] = {new_lit(0, true), term, new_lit(5, false), term};
+    solver = cmsat_new();
+    cmsat_new_vars(solver, 1);
+    assert(!cmsat_add_clauses(solver, cls3, 4));
+    clause[0] = new_lit(0, false);
+    cmsat_add_clause(solver, clause, 1);
+    ret = cmsat_solve(solver);
+    assert(ret.x == L_TRUE);
+
     cmsat_free(solver);
     return 0;
 }
@@ -0,0 +1,333 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <set>
+#include <thread>
+
+#include "cryptominisat5/cryptominisat.h"
+#include "src/solver.h"
+#include "src/solverconf.h"
+#include "src/sls.h"
+#include "src/ccnr.h"
+#include "src/ccnr_cms.h"
+using namespace CMSat;
+#include "test_helper.h"
+
+struct ccnr_async : public ::testing::Test {
+    ccnr_async()
+    {
+        conf.doSLS = 1;
+        conf.sls_async = 1;
+    }
+    ~ccnr_async()
+    {
+        delete s;
+    }
+
+    void add(const vector<vector<Lit>>& cls, uint32_t num_vars)
+    {
+        //The previous solver raised it at the end of its solve()
+        must_inter.store(false, std::memory_order_relaxed);
+        s = new Solver(&conf, &must_inter);
+        s->new_vars(num_vars);
+        for(const auto& cl: cls) s->add_clause_outside(cl);
+    }
+
+    SolverConf conf;
+    Solver* s = NULL;
+    std::atomic<bool> must_inter;
+};
+
+TEST_F(ccnr_async, finds_model_on_helper_thread)
+{
+    const auto cls = random_3sat(300, 900, 11);
+    add(cls, 300);
+    SLS sls(s);
+    ASSERT_TRUE(sls.start_async(0));
+    while(!sls.async_done()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_TRUE(sls.async_found_model());
+    sls.stop_async(true);
+
+    EXPECT_EQ(s->solve_with_assumptions(), l_True);
+    EXPECT_TRUE(model_satisfies(cls, s->get_model()));
+}
+
+TEST_F(ccnr_async, stop_while_running)
+{
+    add(pigeonhole(9), 9*8);
+    SLS sls(s);
+    ASSERT_TRUE(sls.start_async(0));
+    sls.stop_async(false);
+    EXPECT_TRUE(sls.async_done());
+    EXPECT_FALSE(sls.async_found_model());
+}
+
+TEST_F(ccnr_async, same_result_as_without_sls)
+{
+    //SLS is run every few hundred conflicts instead of every 44K
+    conf.global_next_multiplier = 0.01;
+    for(uint32_t seed = 0; seed < 6; seed++) {
+        const auto cls = random_3sat(200, 852, seed);
+        delete s;
+        add(cls, 200);
+
+        SATSolver ref;
+        ref.new_vars(200);
+        for(const auto& cl: cls) ref.add_clause(cl);
+        const lbool ret = s->solve_with_assumptions();
+        ASSERT_EQ(ret, ref.solve());
+        if (ret == l_True) {
+            EXPECT_TRUE(model_satisfies(cls, s->get_model()));
+        }
+    }
+}
+
+static vector<vector<int>> to_dimacs(const vector<vector<Lit>>& cls)
+{
+    vector<vector<int>> ret;
+    for(const auto& cl: cls) {
+        vector<int> c;
+        for(const Lit l: cl) c.push_back(((int)l.var()+1) * (l.sign() ? -1 : 1));
+        ret.push_back(c);
+    }
+    return ret;
+}
+
+static void build(CCNR::ls_solver& ls, const vector<vector<int>>& cls, int num_vars)
+{
+    size_t num_lits = 0;
+    for(const auto& cl: cls) num_lits += cl.size();
+    ls.start_build(num_vars, cls.size(), num_lits);
+    for(const auto& cl: cls) ls.add_clause(cl);
+    ASSERT_TRUE(ls.finish_build());
+}
+
+static bool ls_model_satisfies(const vector<vector<int>>& cls, const vector<uint8_t>& sol)
+{
+    for(const auto& cl: cls) {
+        bool sat = false;
+        for(const int l: cl) sat |= (sol[std::abs(l)] == (l > 0));
+        if (!sat) return false;
+    }
+    return true;
+}
+
+TEST(ccnr_flat, csr_matches_clauses)
+{
+    const int num_vars = 50;
+    const auto cls = to_dimacs(random_3sat(num_vars, 200, 3));
+    CCNR::ls_solver ls(true);
+    build(ls, cls, num_vars);
+    ASSERT_EQ(ls._num_clauses, (int)cls.size());
+
+    vector<uint32_t> occs(num_vars+1, 0);
+    vector<std::set<int>> neighbors(num_vars+1);
+    for(uint32_t c = 0; c < cls.size(); c++) {
+        const auto lits = ls.clause_lits(c);
+        ASSERT_EQ(lits.size(), cls[c].size());
+        for(uint32_t i = 0; i < lits.size(); i++) {
+            EXPECT_EQ(lits[i].clause_num, (int)c);
+            EXPECT_EQ(lits[i].var_num, std::abs(cls[c][i]));
+            EXPECT_EQ(lits[i].sense, cls[c][i] > 0);
+            occs[lits[i].var_num]++;
+            for(const int l2: cls[c]) {
+                if (std::abs(l2) != lits[i].var_num) neighbors[lits[i].var_num].insert(std::abs(l2));
+            }
+        }
+    }
+
+    for(int v = 1; v <= num_vars; v++) {
+        EXPECT_EQ(ls.var_lits(v).size(), occs[v]);
+        for(const CCNR::lit l: ls.var_lits(v)) {
+            EXPECT_EQ(l.var_num, v);
+            const auto& cl = cls[l.clause_num];
+            EXPECT_NE(std::find(cl.begin(), cl.end(), l.sense ? v : -v), cl.end());
+        }
+        const auto nb = ls.var_neighbors(v);
+        EXPECT_EQ(std::set<int>(nb.begin(), nb.end()), neighbors[v]);
+        EXPECT_EQ(nb.size(), neighbors[v].size());
+    }
+}
+
+static void build_with_ids(CCNR::ls_solver& ls, const vector<vector<int>>& cls
+    , const vector<int32_t>& ids, int num_vars)
+{
+    size_t num_lits = 0;
+    for(const auto& cl: cls) num_lits += cl.size();
+    ls.start_build(num_vars, cls.size(), num_lits);
+    for(uint32_t i = 0; i < cls.size(); i++) ls.add_clause(cls[i], ids[i]);
+    ASSERT_TRUE(ls.finish_build());
+}
+
+TEST(ccnr_flat, rebuild_matches_full_build)
+{
+    const int num_vars = 60;
+    auto cls = to_dimacs(random_3sat(num_vars, 250, 5));
+    vector<int32_t> ids;
+    for(uint32_t i = 0; i < cls.size(); i++) ids.push_back(i+1);
+    int32_t next_id = cls.size()+1;
+    CCNR::ls_solver ls(true);
+    build_with_ids(ls, cls, ids, num_vars);
+
+    build_with_ids(ls, cls, ids, num_vars);
+    EXPECT_EQ(ls.get_clauses_added(), 0);
+    EXPECT_EQ(ls.get_clauses_removed(), 0);
+
+    //Remove 10, change 5, add 5, and var 7 becomes false: it disappears
+    //from its clauses, which keep their IDs
+    cls.erase(cls.begin(), cls.begin()+10);
+    ids.erase(ids.begin(), ids.begin()+10);
+    for(uint32_t i = 0; i < 5; i++) {
+        cls[i][0] = -cls[i][0];
+        ids[i] = next_id++;
+    }
+    const auto extra = to_dimacs(random_3sat(num_vars, 5, 6));
+    for(const auto& cl: extra) {
+        cls.push_back(cl);
+        ids.push_back(next_id++);
+    }
+    int with_7 = 0;
+    for(uint32_t i = 0; i < cls.size(); i++) {
+        auto& cl = cls[i];
+        const auto it = std::find_if(cl.begin(), cl.end(), [](int l) { return std::abs(l) == 7; });
+        if (it == cl.end()) continue;
+        cl.erase(it);
+        if (i >= 5 && i < cls.size()-5) with_7++;
+    }
+    ls.mark_var_changed(7);
+    build_with_ids(ls, cls, ids, num_vars);
+    EXPECT_EQ(ls.get_clauses_removed(), 10 + 5 + with_7);
+    EXPECT_EQ(ls.get_clauses_added(), 5 + 5 + with_7);
+
+    CCNR::ls_solver fresh(true);
+    build_with_ids(fresh, cls, ids, num_vars);
+    for(int v = 1; v <= num_vars; v++) {
+        const auto nb = ls.var_neighbors(v);
+        const auto nb_fresh = fresh.var_neighbors(v);
+        EXPECT_EQ(std::set<int>(nb.begin(), nb.end()), std::set<int>(nb_fresh.begin(), nb_fresh.end()));
+        EXPECT_EQ(nb.size(), nb_fresh.size());
+    }
+}
+
+TEST(ccnr_flat, local_search_finds_model)
+{
+    const int num_vars = 300;
+    const auto cls = to_dimacs(random_3sat(num_vars, 900, 2));
+    CCNR::ls_solver ls(true);
+    build(ls, cls, num_vars);
+    ASSERT_TRUE(ls.local_search(NULL));
+    EXPECT_EQ(ls.get_best_cost(), 0);
+    EXPECT_TRUE(ls_model_satisfies(cls, ls._best_solution));
+}
+
+TEST(ccnr_walkers, share_formula_and_best)
+{
+    const int num_vars = 400;
+    const auto cls = to_dimacs(random_3sat(num_vars, 1500, 9));
+    CCNR::ls_solver first(true);
+    build(first, cls, num_vars);
+
+    CCNR::shared_best best;
+    vector<CCNR::ls_solver*> walkers;
+    walkers.push_back(&first);
+    for(int i = 1; i < 4; i++) {
+        CCNR::ls_solver* w = new CCNR::ls_solver(true);
+        w->share_formula(first);
+        w->set_seed(1+i);
+        walkers.push_back(w);
+    }
+    for(auto w: walkers) w->set_shared_best(&best);
+
+    vector<int> res(walkers.size(), 0);
+    vector<std::thread> threads;
+    for(uint32_t i = 0; i < walkers.size(); i++) {
+        threads.push_back(std::thread([&, i]() {
+            res[i] = walkers[i]->local_search(NULL);
+        }));
+    }
+    for(auto& t: threads) t.join();
+
+    EXPECT_NE(std::find(res.begin(), res.end(), 1), res.end());
+    EXPECT_TRUE(best.found);
+    EXPECT_EQ(best.cost, 0);
+    EXPECT_TRUE(ls_model_satisfies(cls, best.solution));
+    for(uint32_t i = 0; i < walkers.size(); i++) {
+        if (res[i]) {
+            EXPECT_TRUE(ls_model_satisfies(cls, walkers[i]->_best_solution));
+        }
+    }
+    for(uint32_t i = 1; i < walkers.size(); i++) delete walkers[i];
+}
+
+TEST_F(ccnr_async, walkers_sync_and_async)
+{
+    conf.sls_walkers = 4;
+    const auto cls = random_3sat(300, 900, 12);
+    add(cls, 300);
+    {
+        SLS sls(s);
+        EXPECT_NE(sls.run(0), l_False);
+    }
+    {
+        SLS sls(s);
+        ASSERT_TRUE(sls.start_async(1));
+        while(!sls.async_done()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        EXPECT_TRUE(sls.async_found_model());
+        sls.stop_async(true);
+    }
+    EXPECT_EQ(s->solve_with_assumptions(), l_True);
+    EXPECT_TRUE(model_satisfies(cls, s->get_model()));
+}
+
+TEST_F(ccnr_async, kept_during_search_counted_and_freed)
+{
+    conf.sls_async = 0;
+    const auto cls = random_3sat(300, 900, 13);
+    add(cls, 300);
+    {
+        SLS sls(s);
+        EXPECT_NE(sls.run(0), l_False);
+    }
+    ASSERT_NE(s->ccnr, (CMS_ccnr*)NULL);
+    vector<MemStat> mems;
+    s->get_mem_stats(mems);
+    const auto it = std::find_if(mems.begin(), mems.end(),
+        [](const MemStat& m) { return m.name == "sls"; });
+    ASSERT_NE(it, mems.end());
+    EXPECT_GT(it->bytes, 0u);
+
+    EXPECT_EQ(s->solve_with_assumptions(), l_True);
+    EXPECT_EQ(s->ccnr, (CMS_ccnr*)NULL);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -75,6 +75,163 @@ TEST_F(clause_allocator, add_1)
     EXPECT_EQ(ret, l_True);
 }
 
+//The arena is opt-in, and must give the same results as malloc
+struct clause_arena : public ::testing::Test {
+    Solver* new_solver(const bool arena, const bool hugepages)
+    {
+        SolverConf conf;
+        conf.clause_alloc_arena = arena;
+        conf.clause_alloc_hugepages = hugepages;
+        //The previous solver raised it at the end of its solve()
+        must_inter.store(false, std::memory_order_relaxed);
+        return new Solver(&conf, &must_inter);
+    }
+    std::atomic<bool> must_inter{false};
+};
+
+TEST_F(clause_arena, off_by_default)
+{
+    SolverConf conf;
+    Solver s(&conf, &must_inter);
+    s.new_vars(10);
+    s.add_clause_outside(str_to_cl("1, 2, 3, 4"));
+    EXPECT_FALSE(s.cl_alloc.uses_arena());
+}
+
+TEST_F(clause_arena, grows_and_consolidates)
+{
+    //Large enough to outgrow the first reserved range
+    for(int hugepages = 0; hugepages < 2; hugepages++) {
+        Solver* s = new_solver(true, hugepages);
+        s->new_vars(20000);
+        std::mt19937 rnd(1);
+        vector<Lit> cl;
+        for(uint32_t i = 0; i < 400000; i++) {
+            cl.clear();
+            for(uint32_t j = 0; j < 12; j++) {
+                cl.push_back(Lit(rnd() % 20000, rnd() & 1));
+            }
+            s->add_clause_outside(cl);
+            if (i % 100000 == 0) {
+                s->cl_alloc.consolidate(s, true);
+            }
+        }
+        EXPECT_TRUE(s->cl_alloc.uses_arena());
+        s->cl_alloc.consolidate(s, true);
+        EXPECT_TRUE(s->cl_alloc.uses_arena());
+        EXPECT_EQ(s->solve_with_assumptions(NULL), l_True);
+        delete s;
+    }
+}
+
+TEST_F(clause_arena, same_as_malloc)
+{
+    for(uint32_t seed = 0; seed < 8; seed++) {
+        lbool rets[2];
+        for(int arena = 0; arena < 2; arena++) {
+            Solver* s = new_solver(arena, seed % 2);
+            s->new_vars(200);
+            const auto cls = random_3sat(200, 850, seed);
+            for(const auto& c: cls) s->add_clause_outside(c);
+            rets[arena] = s->solve_with_assumptions(NULL);
+            EXPECT_EQ(s->cl_alloc.uses_arena(), (bool)arena);
+            if (rets[arena] == l_True) {
+                EXPECT_TRUE(model_satisfies(cls, s->get_model()));
+            }
+            delete s;
+        }
+        EXPECT_EQ(rets[0], rets[1]);
+    }
+}
+
+//With --consorder 1, consolidation lays the clauses out as tier-0, irred,
+//tier-1, tier-2, and the search must still give the same results
+struct consolidate_order : public ::testing::Test {
+    Solver* new_solver(const int order)
+    {
+        SolverConf conf;
+        conf.consolidate_order = order;
+        //The previous solver raised it at the end of its solve()
+        must_inter.store(false, std::memory_order_relaxed);
+        return new Solver(&conf, &must_inter);
+    }
+
+    //The tier of a learnt clause is the one it is marked for, which
+    //reduceDB may not have moved it to yet
+    static uint32_t group(const Clause* cl)
+    {
+        if (!cl->red()) return 1;
+        return cl->stats.which_red_array == 0 ? 0 : cl->stats.which_red_array + 1;
+    }
+
+    void check_layout(Solver* s)
+    {
+        vector<ClOffset> offs = s->longIrredCls;
+        for(const auto& lredcls: s->longRedCls) {
+            offs.insert(offs.end(), lredcls.begin(), lredcls.end());
+        }
+        std::sort(offs.begin(), offs.end());
+        vector<uint32_t> seen(4, 0);
+        uint32_t last = 0;
+        for(const ClOffset off: offs) {
+            const uint32_t g = group(s->cl_alloc.ptr(off));
+            EXPECT_GE(g, last);
+            last = g;
+            seen[g]++;
+        }
+        EXPECT_GT(seen[0], 0u);
+        EXPECT_GT(seen[1], 0u);
+        EXPECT_GT(seen[3], 0u);
+    }
+
+    std::atomic<bool> must_inter{false};
+};
+
+TEST_F(consolidate_order, tiers_in_order)
+{
+    Solver* s = new_solver(1);
+    s->new_vars(250);
+    for(const auto& c: random_3sat(250, 1065, 3)) s->add_clause_outside(c);
+    s->set_max_confl(5000);
+    s->solve_with_assumptions(NULL);
+    s->cl_alloc.consolidate(s, true);
+    check_layout(s);
+    delete s;
+}
+
+TEST_F(consolidate_order, same_as_default)
+{
+    uint32_t num_sat = 0;
+    for(uint32_t seed = 0; seed < 6; seed++) {
+        const auto cls = random_3sat(200, 852, seed);
+        lbool rets[2];
+        for(int order = 0; order < 2; order++) {
+            Solver* s = new_solver(order);
+            s->new_vars(200);
+            for(const auto& c: cls) s->add_clause_outside(c);
+            //Consolidate a few times during the search
+            for(uint32_t i = 0; i < 5; i++) {
+                s->set_max_confl(1000);
+                rets[order] = s->solve_with_assumptions(NULL);
+                must_inter.store(false, std::memory_order_relaxed);
+                if (rets[order] != l_Undef) break;
+                s->cl_alloc.consolidate(s, true);
+            }
+            if (rets[order] == l_Undef) {
+                rets[order] = s->solve_with_assumptions(NULL);
+            }
+            if (rets[order] == l_True) {
+                EXPECT_TRUE(model_satisfies(cls, s->get_model()));
+            }
+            delete s;
+        }
+        EXPECT_NE(rets[0], l_Undef);
+        EXPECT_EQ(rets[0], rets[1]);
+        num_sat += rets[0] == l_True;
+    }
+    EXPECT_GT(num_sat, 0u);
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,100 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#include "gtest/gtest.h"
+
+#include "src/cycleprof.h"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using namespace CMSat;
+using std::string;
+
+static const char* fname = "cycleprof_test.folded";
+
+static void spin(uint64_t ticks)
+{
+    const uint64_t start = cycleprof_now();
+    while (cycleprof_now() - start < ticks) {}
+}
+
+//Two threads enter the same scopes many times, then the process exits
+static void profile_and_exit()
+{
+    auto work = []() {
+        for(int i = 0; i < 100; i++) {
+            CYCLE_PROF_SCOPE(prof_search);
+            CYCLE_PROF_SCOPE(prof_propagate);
+            spin(1000);
+        }
+        CYCLE_PROF_SCOPE(prof_simplify);
+    };
+    std::thread t1(work);
+    std::thread t2(work);
+    t1.join();
+    t2.join();
+    std::exit(0);
+}
+
+static std::map<string, uint64_t> read_folded()
+{
+    std::map<string, uint64_t> stacks;
+    std::ifstream f(fname);
+    string line;
+    while (std::getline(f, line)) {
+        std::istringstream ss(line);
+        string stack;
+        uint64_t cycles = 0;
+        ss >> stack >> cycles;
+        EXPECT_TRUE(ss && ss.eof()) << line;
+        EXPECT_EQ(stacks.count(stack), 0U) << stack;
+        stacks[stack] = cycles;
+    }
+    return stacks;
+}
+
+TEST(cycleprof, report_written_at_exit)
+{
+    std::remove(fname);
+    setenv("CMS_CYCLEPROF_FILE", fname, 1);
+    EXPECT_EXIT(profile_and_exit(), ::testing::ExitedWithCode(0), "");
+
+    //Both threads and all 100 entries are summed into one line per stack
+    const auto stacks = read_folded();
+    EXPECT_EQ(stacks.size(), 3U);
+    ASSERT_EQ(stacks.count("search;propagate"), 1U);
+    EXPECT_GE(stacks.at("search;propagate"), 2U*100U*1000U);
+    EXPECT_EQ(stacks.count("search"), 1U);
+    EXPECT_EQ(stacks.count("simplify"), 1U);
+    std::remove(fname);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
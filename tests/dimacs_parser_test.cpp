@@ -0,0 +1,234 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#include "gtest/gtest.h"
+
+#include "cryptominisat5/cryptominisat.h"
+#include "src/dimacsparser.h"
+#include "src/streambuffer.h"
+#ifndef _WIN32
+#include "src/mmapdimacsparser.h"
+#endif
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <random>
+
+using namespace CMSat;
+using std::vector;
+using std::string;
+
+//Records what the parser gives it, in order
+struct Recorder
+{
+    uint32_t nvars = 0;
+    vector<string> events;
+    vector<lbool> model;
+    vector<Lit> conflict;
+    unsigned add_clauses_calls = 0;
+
+    uint32_t nVars() const { return nvars; }
+    void new_var() { nvars++; }
+    void new_vars(size_t n) { nvars += n; }
+    bool add_clause(const vector<Lit>& lits) { return add("cl", lits); }
+    bool add_red_clause(const vector<Lit>& lits) { return add("red", lits); }
+    bool add_clauses(const Lit* lits, size_t num_lits)
+    {
+        add_clauses_calls++;
+        vector<Lit> cl;
+        for(size_t i = 0; i < num_lits; i++) {
+            if (lits[i] == lit_Undef) {
+                add("cl", cl);
+                cl.clear();
+            } else {
+                cl.push_back(lits[i]);
+            }
+        }
+        return true;
+    }
+    bool add_xor_clause(const vector<uint32_t>& vars, bool rhs)
+    {
+        string s = "xor " + std::to_string(rhs);
+        for(uint32_t v: vars) s += " " + std::to_string(v);
+        events.push_back(s);
+        return true;
+    }
+    bool add_bnn_clause(const vector<Lit>& lits, int32_t cutoff, Lit out)
+    {
+        events.push_back("bnn " + std::to_string(cutoff) + " " + std::to_string(out.toInt()));
+        return add("bnn_lits", lits);
+    }
+    void set_var_weight(Lit lit, double weight)
+    {
+        events.push_back("w " + std::to_string(lit.toInt()) + " " + std::to_string(weight));
+    }
+    lbool solve(const vector<Lit>* = NULL, bool = false) { events.push_back("solve"); return l_Undef; }
+    lbool simplify(const vector<Lit>* = NULL, const string* = NULL) { events.push_back("simp"); return l_Undef; }
+    const vector<lbool>& get_model() const { return model; }
+    const vector<Lit>& get_conflict() const { return conflict; }
+
+    bool add(const string& what, const vector<Lit>& lits)
+    {
+        string s = what;
+        for(Lit l: lits) s += " " + std::to_string(l.toInt());
+        events.push_back(s);
+        return true;
+    }
+
+    //Only solve/simplify fix the order, the rest may come in any order
+    //between them
+    vector<vector<string>> segments() const
+    {
+        vector<vector<string>> segs(1);
+        for(const string& e: events) {
+            if (e == "solve" || e == "simp") {
+                segs.push_back({e});
+                segs.push_back({});
+            } else {
+                segs.back().push_back(e);
+            }
+        }
+        for(auto& seg: segs) std::sort(seg.begin(), seg.end());
+        return segs;
+    }
+};
+
+struct parsers : public ::testing::Test {
+    parsers() : fname("dimacs_parser_test.cnf") {}
+    ~parsers() { std::remove(fname.c_str()); }
+
+    void write(const string& contents)
+    {
+        std::ofstream f(fname);
+        f << contents;
+    }
+
+    Recorder parse_stream(vector<uint32_t>& sampling)
+    {
+        Recorder r;
+        FILE* in = fopen(fname.c_str(), "rb");
+        DimacsParser<StreamBuffer<FILE*, FN>, Recorder> parser(&r, NULL, 0);
+        EXPECT_TRUE(parser.parse_DIMACS(in, false));
+        fclose(in);
+        sampling = parser.sampling_vars;
+        return r;
+    }
+
+    #ifndef _WIN32
+    Recorder parse_mmap(vector<uint32_t>& sampling, unsigned threads)
+    {
+        Recorder r;
+        MMapDimacsParser<Recorder> parser(&r, NULL, 0, threads);
+        EXPECT_TRUE(parser.map_file(fname));
+        EXPECT_TRUE(parser.parse_DIMACS(false));
+        sampling = parser.line_parser.sampling_vars;
+        return r;
+    }
+    #endif
+
+    void check_same()
+    {
+        #ifndef _WIN32
+        vector<uint32_t> samp1;
+        const Recorder r1 = parse_stream(samp1);
+        for(unsigned threads: {1U, 4U}) {
+            vector<uint32_t> samp2;
+            const Recorder r2 = parse_mmap(samp2, threads);
+            EXPECT_EQ(r1.nvars, r2.nvars);
+            EXPECT_EQ(r1.segments(), r2.segments());
+            EXPECT_EQ(samp1, samp2);
+        }
+        #endif
+    }
+
+    string fname;
+};
+
+TEST_F(parsers, simple)
+{
+    write("p cnf 3 2\n1 -2 0\n2 3 0\n");
+    check_same();
+}
+
+TEST_F(parsers, comments_xors_and_no_final_newline)
+{
+    write(
+        "c a comment\n"
+        "p cnf 10 5\n"
+        "c ind 1 2 3 0\n"
+        "1 -2 0\n"
+        "x1 2 -3 0\n"
+        "c another\n"
+        "  4 5   -6 0\n"
+        "x-7 8 0\n"
+        "c ind 9 0\n"
+        "-10 0");
+    check_same();
+}
+
+TEST_F(parsers, vars_beyond_header)
+{
+    write("p cnf 2 2\n1 2 0\n-5 7 0\n");
+    check_same();
+}
+
+TEST_F(parsers, random)
+{
+    std::mt19937 rnd(3);
+    string s = "p cnf 500 3000\n";
+    for(uint32_t i = 0; i < 3000; i++) {
+        if (rnd() % 50 == 0) s += "c comment " + std::to_string(i) + "\n";
+        if (rnd() % 20 == 0) s += "x";
+        const uint32_t sz = 1 + rnd() % 6;
+        for(uint32_t j = 0; j < sz; j++) {
+            const int32_t v = 1 + rnd() % 500;
+            s += std::to_string(rnd() & 1 ? v : -v) + " ";
+        }
+        s += "0\n";
+    }
+    write(s);
+    check_same();
+}
+
+TEST_F(parsers, comments_and_xors_do_not_split_batches)
+{
+    string s = "p cnf 100 400\n";
+    for(uint32_t i = 0; i < 200; i++) {
+        s += "c comment\n";
+        s += std::to_string(1 + i % 100) + " -" + std::to_string(1 + (i+1) % 100) + " 0\n";
+        s += "x" + std::to_string(1 + (i+2) % 100) + " 3 0\n";
+    }
+    write(s);
+    check_same();
+
+    #ifndef _WIN32
+    vector<uint32_t> samp;
+    const Recorder r = parse_mmap(samp, 1);
+    EXPECT_EQ(r.add_clauses_calls, 1U);
+    #endif
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
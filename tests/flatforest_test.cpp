@@ -0,0 +1,127 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#include "gtest/gtest.h"
+
+#include "src/flatforest.h"
+#include <cmath>
+#include <string>
+
+using namespace CMSat;
+using std::string;
+
+//Two trees over 2 features. The second one's nodes are not in
+//breadth-first order, and the objective's name has escapes in it
+static string model(const string& objective)
+{
+    return R"({"learner": {
+    "gradient_booster": {"model": {"trees": [
+        {"left_children": [1, -1, -1], "right_children": [2, -1, -1],
+         "split_conditions": [0.5, 1.0, -1.0], "split_indices": [0, 0, 0],
+         "default_left": [1, 0, 0]},
+        {"left_children": [3, -1, -1, 2, -1], "right_children": [1, -1, -1, 4, -1],
+         "split_conditions": [2.0, 0.1, 0.5, -1.0, 0.25],
+         "split_indices": [1, 0, 0, 0, 0], "default_left": [0, 0, 0, 0, 0]}
+    ]}},
+    "objective": {"name": ")" + objective + R"("},
+    "learner_model_param": {"base_score": "5E-1"}
+    }})";
+}
+
+static const float rows[] = {
+    0, 0,
+    1, 3,
+    -2, 1,
+    NAN, NAN
+};
+static const float expected_margin[] = {1.75f, -0.4f, 2.0f, 1.6f};
+
+TEST(flatforest, squared_error)
+{
+    FlatForest f;
+    const string m = model("reg:squar\\u0065derror");
+    ASSERT_TRUE(f.load(m.data(), m.size(), 2));
+    EXPECT_FALSE(f.logistic);
+
+    float out[4];
+    f.predict(rows, 4, out);
+    for(uint32_t i = 0; i < 4; i++) {
+        EXPECT_FLOAT_EQ(out[i], expected_margin[i]);
+    }
+}
+
+TEST(flatforest, logistic)
+{
+    FlatForest f;
+    const string m = model("binary:logistic");
+    ASSERT_TRUE(f.load(m.data(), m.size(), 2));
+    EXPECT_TRUE(f.logistic);
+
+    float out[4];
+    f.predict(rows, 4, out);
+    for(uint32_t i = 0; i < 4; i++) {
+        //base_score 0.5 is a margin of 0
+        const float margin = expected_margin[i] - 0.5f;
+        EXPECT_FLOAT_EQ(out[i], 1.0f/(1.0f+std::exp(-margin)));
+    }
+}
+
+TEST(flatforest, many_rows)
+{
+    FlatForest f;
+    const string m = model("reg:squarederror");
+    ASSERT_TRUE(f.load(m.data(), m.size(), 2));
+
+    //More than one batch, with a partial one at the end
+    const uint32_t num = 4*50;
+    vector<float> data;
+    for(uint32_t i = 0; i < num/4; i++) data.insert(data.end(), rows, rows+8);
+    vector<float> out(num);
+    f.predict(data.data(), num, out.data());
+    for(uint32_t i = 0; i < num; i++) {
+        EXPECT_FLOAT_EQ(out[i], expected_margin[i%4]);
+    }
+}
+
+TEST(flatforest, rejects_bad_models)
+{
+    FlatForest f;
+
+    //Feature 1 does not exist with only one column
+    string m = model("reg:squarederror");
+    EXPECT_FALSE(f.load(m.data(), m.size(), 1));
+
+    m = model("reg:squar\\u00");
+    EXPECT_FALSE(f.load(m.data(), m.size(), 2));
+
+    m = model("reg:squarederror");
+    EXPECT_FALSE(f.load(m.data(), m.size()/2, 2));
+
+    m = model("multi:softmax");
+    EXPECT_FALSE(f.load(m.data(), m.size(), 2));
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
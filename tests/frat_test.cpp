@@ -0,0 +1,283 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#include "gtest/gtest.h"
+
+#include "src/frat.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <set>
+#include <string>
+#ifdef USE_ZLIB
+#include <zlib.h>
+#endif
+
+using namespace CMSat;
+#include "test_helper.h"
+
+static std::string file_contents(FILE* f)
+{
+    fflush(f);
+    std::string ret;
+    fseek(f, 0, SEEK_SET);
+    int c;
+    while ((c = fgetc(f)) != EOF) ret += (char)c;
+    fseek(f, 0, SEEK_END);
+    return ret;
+}
+
+static void write_str(FratWriter& w, std::string s)
+{
+    w.write((unsigned char*)&s[0], s.size());
+}
+
+TEST(frat_writer, plain)
+{
+    FILE* f = tmpfile();
+    {
+        FratWriter w(f, 1024, false, 0);
+        write_str(w, "o 1 1 0\n");
+        w.sync();
+        EXPECT_EQ(file_contents(f), "o 1 1 0\n");
+        write_str(w, "o 2 -1 0\n");
+        w.sync();
+    }
+    EXPECT_EQ(file_contents(f), "o 1 1 0\no 2 -1 0\n");
+    fclose(f);
+}
+
+struct frat_merge : public ::testing::Test {
+    frat_merge() : streams{tmpfile(), tmpfile()}, read_at(2, 0), imports(2)
+    {
+        out = tmpfile();
+    }
+    ~frat_merge()
+    {
+        for(FILE* f: streams) fclose(f);
+        fclose(out);
+    }
+
+    std::string merge()
+    {
+        {
+            FratWriter w(out, 1024, async, 0);
+            merge_frat_streams(streams, read_at, imports, w);
+        }
+        const std::string all = file_contents(out);
+        const std::string ret = all.substr(merged);
+        merged = all.size();
+        return ret;
+    }
+
+    vector<FILE*> streams;
+    vector<long> read_at;
+    vector<vector<FratImport>> imports;
+    FILE* out;
+    size_t merged = 0;
+    bool async = false;
+};
+
+TEST_F(frat_merge, orders_by_sync_points)
+{
+    fputs("o 1 1 2 0\nc sync 0\na 3 1 0 l 1 0\nc sync 2\n", streams[0]);
+    fputs("o 2 2 1 0\nc sync 1\na 4 2 0\n", streams[1]);
+    EXPECT_EQ(merge(),
+        "o 1 1 2 0\n"
+        "a 2 2 1 0 l 1 0\n"
+        "a 3 1 0 l 1 0\n"
+        "a 4 2 0\n");
+}
+
+TEST_F(frat_merge, deletion_waits_for_import)
+{
+    fputs("a 1 5 0\nc sync 0\nd 1 5 0\nc sync 2\n", streams[0]);
+    fputs("c sync 1\na 2 5 0 l 1 0\nc sync 3\n", streams[1]);
+    imports[1].push_back(FratImport{1, 1});
+    EXPECT_EQ(merge(),
+        "a 1 5 0\n"
+        "a 2 5 0 l 1 0\n"
+        "d 1 5 0\n");
+}
+
+TEST_F(frat_merge, first_original_deleted_last)
+{
+    fputs("o 1 3 0\nd 1 3 0\nc sync 0\n", streams[0]);
+    fputs("o 2 3 0\nc sync 1\n", streams[1]);
+    EXPECT_EQ(merge(),
+        "o 1 3 0\n"
+        "a 2 3 0 l 1 0\n"
+        "d 1 3 0\n");
+}
+
+TEST_F(frat_merge, continues_where_it_stopped)
+{
+    fputs("a 1 1 0\nc sync 0\n", streams[0]);
+    fputs("a 2 2 0\nc sync 1\n", streams[1]);
+    EXPECT_EQ(merge(), "a 1 1 0\na 2 2 0\n");
+
+    fputs("a 3 3 0\nc sync 3\n", streams[0]);
+    fputs("a 4 4 0\nc sync 2\n", streams[1]);
+    EXPECT_EQ(merge(), "a 4 4 0\na 3 3 0\n");
+}
+
+//The merge keeps its own buffer, so it must also work with a writer that
+//takes over the buffers it is given
+TEST_F(frat_merge, async_writer)
+{
+    async = true;
+    fputs("o 1 1 2 0\nc sync 0\na 3 1 0 l 1 0\nc sync 2\n", streams[0]);
+    fputs("o 2 2 1 0\nc sync 1\na 4 2 0\n", streams[1]);
+    EXPECT_EQ(merge(),
+        "o 1 1 2 0\n"
+        "a 2 2 1 0 l 1 0\n"
+        "a 3 1 0 l 1 0\n"
+        "a 4 2 0\n");
+}
+
+#ifdef USE_ZLIB
+//Inflates 'in' as one gzip member. Returns the output, sets 'finished' if the
+//member's trailer was reached and 'rest' to the number of bytes after it
+static std::string gunzip(const std::string& in, bool& finished, size_t& rest)
+{
+    z_stream zs;
+    memset(&zs, 0, sizeof(zs));
+    EXPECT_EQ(inflateInit2(&zs, 15+16), Z_OK);
+    zs.next_in = (Bytef*)in.data();
+    zs.avail_in = in.size();
+    std::string out;
+    char buf[256];
+    int ret;
+    do {
+        zs.next_out = (Bytef*)buf;
+        zs.avail_out = sizeof(buf);
+        ret = inflate(&zs, Z_SYNC_FLUSH);
+        out.append(buf, sizeof(buf) - zs.avail_out);
+    } while (ret == Z_OK && (zs.avail_in > 0 || zs.avail_out == 0));
+    finished = (ret == Z_STREAM_END);
+    rest = zs.avail_in;
+    inflateEnd(&zs);
+    return out;
+}
+
+TEST(frat_writer, gzip_one_member_across_syncs)
+{
+    FILE* f = tmpfile();
+    bool finished;
+    size_t rest;
+    {
+        FratWriter w(f, 1024, false, 6);
+        write_str(w, "o 1 1 0\n");
+        w.sync();
+
+        //Everything so far can be read back, but the member is still open
+        EXPECT_EQ(gunzip(file_contents(f), finished, rest), "o 1 1 0\n");
+        EXPECT_FALSE(finished);
+
+        write_str(w, "o 2 -1 0\n");
+        w.sync();
+        write_str(w, "a 3 0 l 1 2 0\n");
+    }
+
+    EXPECT_EQ(gunzip(file_contents(f), finished, rest), "o 1 1 0\no 2 -1 0\na 3 0 l 1 2 0\n");
+    EXPECT_TRUE(finished);
+    EXPECT_EQ(rest, 0U);
+    fclose(f);
+}
+#endif
+
+//Solves with several threads and checks the structure of the merged proof:
+//every clause is added once, deleted or finalized only after it was added,
+//the empty clause is derived, and every clause is finalized at the end.
+//With FRAT_RS set to the frat-rs binary, the proof is also checked by it
+TEST(frat_multi_thread, merged_proof_is_consistent)
+{
+    const vector<vector<Lit>> cls = pigeonhole(6);
+    FILE* f = tmpfile();
+    {
+        SATSolver s;
+        s.set_num_threads(3);
+        s.set_frat(f);
+        s.new_vars(6*5);
+        for(const auto& cl: cls) s.add_clause(cl);
+        EXPECT_EQ(s.solve(), l_False);
+    }
+    const std::string proof = file_contents(f);
+    fclose(f);
+
+    std::set<int64_t> added;
+    std::set<int64_t> live;
+    std::map<char, uint64_t> num;
+    bool empty_clause = false;
+    std::istringstream lines(proof);
+    std::string line;
+    while(std::getline(lines, line)) {
+        if (line.empty() || line[0] == 'c') continue;
+        std::istringstream in(line);
+        char kind;
+        int64_t ID;
+        ASSERT_TRUE((bool)(in >> kind >> ID)) << line;
+        num[kind]++;
+        int lit;
+        uint32_t sz = 0;
+        while(in >> lit && lit != 0) sz++;
+        if (kind == 'o' || kind == 'a') {
+            EXPECT_TRUE(added.insert(ID).second) << "added twice: " << line;
+            live.insert(ID);
+            if (kind == 'a' && sz == 0) empty_clause = true;
+        } else if (kind == 'd' || kind == 'f') {
+            EXPECT_EQ(live.erase(ID), 1U) << "not live: " << line;
+        } else {
+            ADD_FAILURE() << "unknown line: " << line;
+        }
+    }
+    EXPECT_EQ(num['o'], cls.size());
+    EXPECT_GT(num['f'], 0U);
+    EXPECT_TRUE(empty_clause);
+    EXPECT_TRUE(live.empty());
+
+    const char* frat_rs = getenv("FRAT_RS");
+    if (frat_rs != NULL) {
+        FILE* cnf = fopen("frat_multi_thread.cnf", "w");
+        fprintf(cnf, "p cnf %u %u\n", 6*5, (uint32_t)cls.size());
+        for(const auto& cl: cls) {
+            for(const Lit l: cl) fprintf(cnf, "%d ", (l.sign() ? -1 : 1)*(int)(l.var()+1));
+            fprintf(cnf, "0\n");
+        }
+        fclose(cnf);
+        FILE* pf = fopen("frat_multi_thread.frat", "w");
+        fwrite(proof.data(), 1, proof.size(), pf);
+        fclose(pf);
+        const std::string cmd = std::string(frat_rs)
+            + " elab frat_multi_thread.frat frat_multi_thread.cnf";
+        EXPECT_EQ(std::system(cmd.c_str()), 0);
+        std::remove("frat_multi_thread.cnf");
+        std::remove("frat_multi_thread.frat");
+    }
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,171 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#include "gtest/gtest.h"
+
+#include <random>
+
+#include "src/solver.h"
+#include "src/solverconf.h"
+#include "src/gaussian.h"
+using namespace CMSat;
+#include "test_helper.h"
+
+struct XorProblem {
+    uint32_t num_vars;
+    vector<vector<uint32_t>> xors;
+    vector<bool> rhs;
+    vector<vector<Lit>> cls;
+};
+
+//Independent groups of XORs, each on its own vars, so each is its own
+//matrix, with a unit in each. If 'tie', a few clauses across the groups
+//tie things together
+static XorProblem make_problem(uint32_t groups, uint32_t group_vars
+    , uint32_t xors_per_group, uint32_t seed, bool tie)
+{
+    std::mt19937 rnd(seed);
+    XorProblem p;
+    p.num_vars = groups*group_vars;
+    for(uint32_t g = 0; g < groups; g++) {
+        for(uint32_t i = 0; i < xors_per_group; i++) {
+            vector<uint32_t> vars;
+            while(vars.size() < 4) {
+                const uint32_t v = g*group_vars + rnd() % group_vars;
+                if (std::find(vars.begin(), vars.end(), v) == vars.end()) vars.push_back(v);
+            }
+            p.xors.push_back(vars);
+            p.rhs.push_back(rnd() & 1);
+        }
+        p.cls.push_back(vector<Lit>{Lit(g*group_vars, rnd() & 1)});
+    }
+    for(uint32_t i = 0; tie && i < groups*2; i++) {
+        vector<Lit> cl;
+        for(uint32_t k = 0; k < 3; k++) cl.push_back(Lit(rnd() % p.num_vars, rnd() & 1));
+        p.cls.push_back(cl);
+    }
+    return p;
+}
+
+struct gauss_parallel : public ::testing::Test {
+    ~gauss_parallel()
+    {
+        delete s;
+    }
+
+    void setup(const XorProblem& p, uint32_t threads)
+    {
+        delete s;
+        //The previous solver raised it at the end of its solve()
+        must_inter.store(false, std::memory_order_relaxed);
+        SolverConf conf;
+        conf.gaussconf.min_gauss_xor_clauses = 0;
+        conf.gaussconf.min_matrix_rows = 1;
+        conf.gaussconf.max_num_matrices = 100;
+        conf.gaussconf.init_threads = threads;
+        s = new Solver(&conf, &must_inter);
+        s->new_vars(p.num_vars);
+        for(const auto& cl: p.cls) s->add_clause_outside(cl);
+        for(uint32_t i = 0; i < p.xors.size(); i++) {
+            s->add_xor_clause_outside(p.xors[i], p.rhs[i]);
+        }
+    }
+
+    //The rows of the matrices after elimination and the assignment at
+    //level 0
+    struct Result {
+        bool ok;
+        vector<vector<pair<vector<uint32_t>, bool>>> rows;
+        vector<lbool> assigns;
+        bool operator==(const Result& o) const {
+            return ok == o.ok && rows == o.rows && assigns == o.assigns;
+        }
+    };
+
+    Result init(const XorProblem& p, uint32_t threads)
+    {
+        setup(p, threads);
+        Result r;
+        r.ok = s->okay();
+        if (r.ok) {
+            s->xor_clauses_updated = true;
+            r.ok = s->find_and_init_all_matrices();
+        }
+        if (!r.ok) return r;
+        for(EGaussian* g: s->gmatrices) r.rows.push_back(g->get_rows());
+        for(uint32_t v = 0; v < p.num_vars; v++) {
+            r.assigns.push_back(s->value(s->map_outer_to_inter(v)));
+        }
+        return r;
+    }
+
+    lbool solve(const XorProblem& p, uint32_t threads)
+    {
+        setup(p, threads);
+        return s->solve_with_assumptions();
+    }
+
+    Solver* s = NULL;
+    std::atomic<bool> must_inter;
+};
+
+//Without clauses across the groups, the order the matrices are built in
+//can't matter. With them, a later matrix can propagate into one that is
+//already built serially, while the parallel rounds refill it, so there only
+//the results are compared
+TEST_F(gauss_parallel, same_matrices_as_serial)
+{
+    for(uint32_t seed = 0; seed < 20; seed++) {
+        const XorProblem p = make_problem(6, 12, 8, seed, false);
+        const Result serial = init(p, 1);
+        const Result par = init(p, 4);
+        EXPECT_TRUE(serial == par) << "seed: " << seed;
+        if (serial.ok) {
+            EXPECT_GT(serial.rows.size(), 1u);
+        }
+    }
+}
+
+TEST_F(gauss_parallel, same_result_as_serial)
+{
+    uint32_t num_sat = 0;
+    uint32_t num_unsat = 0;
+    for(uint32_t seed = 0; seed < 20; seed++) {
+        const XorProblem p = make_problem(6, 10, 9, seed, true);
+        const lbool serial = solve(p, 1);
+        const lbool par = solve(p, 4);
+        EXPECT_EQ(serial, par) << "seed: " << seed;
+        if (par == l_True) {
+            num_sat++;
+            EXPECT_TRUE(model_satisfies(p.cls, s->get_model()));
+        } else {
+            num_unsat++;
+        }
+    }
+    EXPECT_GT(num_sat + num_unsat, 0u);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
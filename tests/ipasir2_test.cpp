@@ -0,0 +1,138 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#include "gtest/gtest.h"
+#include <vector>
+#include <set>
+extern "C" {
+#include "src/ipasir2.h"
+}
+
+using std::vector;
+
+//Pigeonhole with 'pigeons' pigeons, every clause relaxed with 's OR t',
+//so it takes a while to find out that s or t must be set
+static void add_relaxed_php(void* s, const int32_t pigeons, const int32_t sel1, const int32_t sel2)
+{
+    const int32_t holes = pigeons-1;
+    auto var = [&](int32_t p, int32_t h) { return p*holes + h + 1; };
+    for(int32_t p = 0; p < pigeons; p++) {
+        vector<int32_t> cl;
+        for(int32_t h = 0; h < holes; h++) cl.push_back(var(p, h));
+        cl.push_back(sel1);
+        cl.push_back(sel2);
+        ipasir2_add(s, cl.data(), cl.size(), 0);
+    }
+    for(int32_t h = 0; h < holes; h++) {
+        for(int32_t p1 = 0; p1 < pigeons; p1++) {
+            for(int32_t p2 = p1+1; p2 < pigeons; p2++) {
+                vector<int32_t> cl = {-var(p1, h), -var(p2, h), sel1, sel2};
+                ipasir2_add(s, cl.data(), cl.size(), 0);
+            }
+        }
+    }
+}
+
+struct ImportData {
+    void* solver;
+    int32_t sel1;
+    int32_t sel2;
+    int called = 0;
+};
+
+static void import_both(void* data)
+{
+    ImportData* d = (ImportData*)data;
+    d->called++;
+    if (d->called > 1) return;
+
+    //Several clauses in one callback, all must be taken
+    int32_t cl1[] = {-d->sel1};
+    int32_t cl2[] = {-d->sel2};
+    ipasir2_add(d->solver, cl1, 1, 0);
+    ipasir2_add(d->solver, cl2, 1, 0);
+}
+
+TEST(ipasir2_interface, start)
+{
+    void* s;
+    EXPECT_EQ(ipasir2_init(&s), IPASIR2_E_OK);
+    EXPECT_EQ(ipasir2_release(s), IPASIR2_E_OK);
+}
+
+TEST(ipasir2_interface, import_several_in_one_callback)
+{
+    void* s;
+    ipasir2_init(&s);
+    const int32_t pigeons = 9;
+    const int32_t sel1 = pigeons*(pigeons-1)+1;
+    const int32_t sel2 = sel1+1;
+    add_relaxed_php(s, pigeons, sel1, sel2);
+
+    ImportData d;
+    d.solver = s;
+    d.sel1 = sel1;
+    d.sel2 = sel2;
+    ipasir2_set_import(s, &d, import_both);
+
+    int ret;
+    EXPECT_EQ(ipasir2_solve(s, &ret, NULL, 0), IPASIR2_E_OK);
+    EXPECT_GE(d.called, 1);
+    EXPECT_EQ(ret, 20);
+    ipasir2_release(s);
+}
+
+static void record_fixed(void* data, int32_t lit)
+{
+    vector<int32_t>* fixed = (vector<int32_t>*)data;
+    fixed->push_back(lit);
+}
+
+TEST(ipasir2_interface, fixed_reported_once)
+{
+    void* s;
+    ipasir2_init(&s);
+    const int32_t pigeons = 8;
+    const int32_t sel1 = pigeons*(pigeons-1)+1;
+    const int32_t sel2 = sel1+1;
+    add_relaxed_php(s, pigeons, sel1, sel2);
+    int32_t cl[] = {-sel1};
+    ipasir2_add(s, cl, 1, 0);
+
+    vector<int32_t> fixed;
+    ipasir2_set_fixed(s, &fixed, record_fixed);
+    int ret;
+    EXPECT_EQ(ipasir2_solve(s, &ret, NULL, 0), IPASIR2_E_OK);
+    EXPECT_EQ(ret, 10);
+
+    std::set<int32_t> vars;
+    for(int32_t lit: fixed) {
+        EXPECT_TRUE(vars.insert(abs(lit)).second) << "var " << abs(lit) << " reported twice";
+    }
+    ipasir2_release(s);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
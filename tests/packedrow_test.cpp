@@ -0,0 +1,123 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#include "gtest/gtest.h"
+
+#include "cryptominisat5/cryptominisat.h"
+
+#include "src/packedrow.h"
+#include <random>
+
+using namespace CMSat;
+
+//Compares every SIMD variant against the scalar one, on lengths that
+//exercise both the full blocks and the tails
+struct kernels : public ::testing::Test {
+    kernels() : all(all_packed_kernels()), rnd(12) {}
+
+    vector<int64_t> random_words(uint32_t n, uint32_t density)
+    {
+        vector<int64_t> ret(n);
+        for(auto& w: ret) {
+            w = 0;
+            for(uint32_t i = 0; i < density; i++) {
+                w |= 1LL << (rnd() % 64);
+            }
+        }
+        return ret;
+    }
+
+    vector<PackedRowKernels> all;
+    std::mt19937_64 rnd;
+};
+
+TEST_F(kernels, scalar_first)
+{
+    ASSERT_FALSE(all.empty());
+    EXPECT_STREQ(all[0].name, "scalar");
+}
+
+TEST_F(kernels, two_operand)
+{
+    const PackedRowKernels& scal = all[0];
+    for(const auto& k: all) {
+        for(uint32_t n = 0; n < 70; n++) {
+            const vector<int64_t> a = random_words(n, 20);
+            const vector<int64_t> b = random_words(n, 20);
+
+            vector<int64_t> x1 = a, x2 = a;
+            scal.xor_words(x1.data(), b.data(), n);
+            k.xor_words(x2.data(), b.data(), n);
+            EXPECT_EQ(x1, x2) << k.name << " xor n: " << n;
+
+            x1 = a; x2 = a;
+            scal.and_inv_words(x1.data(), b.data(), n);
+            k.and_inv_words(x2.data(), b.data(), n);
+            EXPECT_EQ(x1, x2) << k.name << " and_inv n: " << n;
+
+            vector<int64_t> o1(n, -1), o2(n, -1);
+            scal.set_and_words(o1.data(), a.data(), b.data(), n);
+            k.set_and_words(o2.data(), a.data(), b.data(), n);
+            EXPECT_EQ(o1, o2) << k.name << " set_and n: " << n;
+
+            scal.set_and_inv_words(o1.data(), a.data(), b.data(), n);
+            k.set_and_inv_words(o2.data(), a.data(), b.data(), n);
+            EXPECT_EQ(o1, o2) << k.name << " set_and_inv n: " << n;
+        }
+    }
+}
+
+TEST_F(kernels, popcnt_atleast2)
+{
+    const PackedRowKernels& scal = all[0];
+    for(const auto& k: all) {
+        for(uint32_t n = 1; n < 70; n++) {
+            for(uint32_t bits = 0; bits < 4; bits++) {
+                //Sparse rows, with 0..3 bits in common somewhere
+                vector<int64_t> a = random_words(n, 1);
+                vector<int64_t> b(n, 0);
+                for(uint32_t i = 0; i < bits; i++) {
+                    const uint32_t at = rnd() % n;
+                    const int64_t bit = 1LL << (rnd() % 64);
+                    a[at] |= bit;
+                    b[at] |= bit;
+                }
+
+                vector<int64_t> o1(n, 0), o2(n, 0);
+                const uint32_t p1 = scal.set_and_popcnt_atleast2(o1.data(), a.data(), b.data(), n);
+                const uint32_t p2 = k.set_and_popcnt_atleast2(o2.data(), a.data(), b.data(), n);
+                EXPECT_EQ(std::min(p1, 2U), std::min(p2, 2U)) << k.name << " n: " << n;
+                if (p1 < 2) {
+                    //Went through the whole row, must be the same
+                    EXPECT_EQ(p1, p2) << k.name << " n: " << n;
+                    EXPECT_EQ(o1, o2) << k.name << " n: " << n;
+                }
+            }
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
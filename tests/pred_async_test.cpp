@@ -0,0 +1,79 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#include "gtest/gtest.h"
+
+#include "cryptominisat5/cryptominisat.h"
+#include "src/solverconf.h"
+#include "test_helper.h"
+
+using namespace CMSat;
+
+//Predicting TIER2 on helper threads must not make the search depend on
+//how fast the helpers are: the same run gives the same conflicts
+static uint64_t run(const vector<vector<Lit>>& cls, uint32_t num_vars
+    , uint32_t pred_threads, lbool& ret)
+{
+    SolverConf conf;
+    conf.predictor_type = "native";
+    conf.pred_threads = pred_threads;
+    conf.pred_apply_confl = 300;
+    conf.every_pred_reduce = 1000;
+    SATSolver s(&conf);
+    s.new_vars(num_vars);
+    for(const auto& cl: cls) s.add_clause(cl);
+    ret = s.solve();
+    return s.get_sum_conflicts();
+}
+
+TEST(pred_async, same_run_same_conflicts)
+{
+    const vector<vector<Lit>> cls = pigeonhole(9);
+    lbool ret;
+    const uint64_t confl = run(cls, 9*8, 2, ret);
+    EXPECT_EQ(ret, l_False);
+    EXPECT_GT(confl, 3000U);
+
+    for(uint32_t i = 0; i < 3; i++) {
+        EXPECT_EQ(run(cls, 9*8, 2, ret), confl);
+        EXPECT_EQ(run(cls, 9*8, 3, ret), confl);
+    }
+}
+
+TEST(pred_async, sat)
+{
+    for(uint32_t seed = 0; seed < 3; seed++) {
+        const vector<vector<Lit>> cls = random_3sat(250, 1050, seed);
+        lbool ret_sync;
+        lbool ret_async;
+        run(cls, 250, 0, ret_sync);
+        const uint64_t confl = run(cls, 250, 2, ret_async);
+        EXPECT_EQ(ret_sync, ret_async);
+        EXPECT_EQ(run(cls, 250, 2, ret_async), confl);
+    }
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
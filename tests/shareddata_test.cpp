@@ -0,0 +1,140 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#include "gtest/gtest.h"
+
+#include "cryptominisat5/cryptominisat.h"
+
+#include "src/shareddata.h"
+#include <thread>
+
+using namespace CMSat;
+
+static vector<Lit> mk_cl(const uint32_t start, const uint32_t size)
+{
+    vector<Lit> cl;
+    for(uint32_t i = 0; i < size; i++) {
+        cl.push_back(Lit(start+i, i&1));
+    }
+    return cl;
+}
+
+TEST(long_ring, push_read)
+{
+    LongClauseRing ring(8);
+    vector<Lit> cl = mk_cl(10, 5);
+    EXPECT_TRUE(ring.push(1, cl.data(), cl.size(), 3, 77));
+    EXPECT_EQ(ring.get_head(), 1U);
+
+    int thread_id;
+    vector<Lit> lits;
+    uint32_t glue;
+    int64_t ID = 0;
+    EXPECT_EQ(ring.read(0, thread_id, lits, glue, ID), LongClauseRing::ReadRet::ok);
+    EXPECT_EQ(thread_id, 1);
+    EXPECT_EQ(lits, cl);
+    EXPECT_EQ(glue, 3U);
+    EXPECT_EQ(ID, 77);
+}
+
+TEST(long_ring, not_yet_written_is_pending)
+{
+    LongClauseRing ring(8);
+    int thread_id;
+    vector<Lit> lits;
+    uint32_t glue;
+    int64_t ID = 0;
+    EXPECT_EQ(ring.read(0, thread_id, lits, glue, ID), LongClauseRing::ReadRet::pending);
+}
+
+TEST(long_ring, overwritten_is_gone)
+{
+    LongClauseRing ring(4);
+    for(uint32_t i = 0; i < 6; i++) {
+        vector<Lit> cl = mk_cl(i, 3);
+        EXPECT_TRUE(ring.push(0, cl.data(), cl.size(), 2));
+    }
+
+    int thread_id;
+    vector<Lit> lits;
+    uint32_t glue;
+    int64_t ID = 0;
+    EXPECT_EQ(ring.read(0, thread_id, lits, glue, ID), LongClauseRing::ReadRet::gone);
+    EXPECT_EQ(ring.read(1, thread_id, lits, glue, ID), LongClauseRing::ReadRet::gone);
+    for(uint32_t i = 2; i < 6; i++) {
+        EXPECT_EQ(ring.read(i, thread_id, lits, glue, ID), LongClauseRing::ReadRet::ok);
+        EXPECT_EQ(lits, mk_cl(i, 3));
+    }
+}
+
+TEST(long_ring, concurrent_writers_never_tear)
+{
+    //Small ring, lots of wrap-arounds: every clause read must be intact
+    LongClauseRing ring(16);
+    const uint32_t num_threads = 4;
+    const uint32_t per_thread = 20000;
+    std::atomic<uint32_t> finished(0);
+    vector<std::thread> ths;
+    for(uint32_t t = 0; t < num_threads; t++) {
+        ths.push_back(std::thread([&ring, &finished, t]() {
+            for(uint32_t i = 0; i < per_thread; i++) {
+                const uint32_t size = 3 + (i % 20);
+                vector<Lit> cl = mk_cl(t*1000 + size, size);
+                ring.push(t, cl.data(), cl.size(), size);
+            }
+            finished++;
+        }));
+    }
+
+    int thread_id;
+    vector<Lit> lits;
+    uint32_t glue;
+    int64_t ID = 0;
+    uint64_t at = 0;
+    uint64_t num_ok = 0;
+    while(at < (uint64_t)num_threads*per_thread) {
+        const bool done = finished == num_threads;
+        const uint64_t head = ring.get_head();
+        for(; at < head; at++) {
+            const auto ret = ring.read(at, thread_id, lits, glue, ID);
+            if (ret == LongClauseRing::ReadRet::pending && !done && head - at < 8) break;
+            if (ret != LongClauseRing::ReadRet::ok) continue;
+            ASSERT_EQ(lits.size(), glue);
+            ASSERT_EQ(lits, mk_cl(thread_id*1000 + glue, glue));
+            num_ok++;
+        }
+    }
+    for(auto& th: ths) th.join();
+    EXPECT_GT(num_ok, 0U);
+
+    //All writers are done: a clause is there, or was overwritten or dropped
+    const uint64_t head = ring.get_head();
+    for(at = head - ring.capacity; at < head; at++) {
+        EXPECT_NE(ring.read(at, thread_id, lits, glue, ID), LongClauseRing::ReadRet::pending);
+    }
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,226 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+
+#include "cryptominisat5/cryptominisat.h"
+#include "src/solver.h"
+#include "src/solverconf.h"
+#include "test_helper.h"
+
+using namespace CMSat;
+using std::vector;
+using std::string;
+
+static const char* fname = "snapshot_test.snap";
+static const char* bad_fname = "snapshot_test_bad.snap";
+
+static vector<char> read_file(const string& name)
+{
+    std::ifstream in(name, std::ios::binary);
+    return vector<char>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+static void write_file(const string& name, const vector<char>& data)
+{
+    std::ofstream out(name, std::ios::binary);
+    out.write(data.data(), data.size());
+}
+
+static void add_cls(SATSolver& s, const vector<vector<Lit>>& cls)
+{
+    uint32_t num_vars = 0;
+    for(const auto& cl: cls) for(Lit l: cl) num_vars = std::max(num_vars, l.var()+1);
+    s.new_vars(num_vars);
+    for(const auto& cl: cls) s.add_clause(cl);
+}
+
+static void load_bad()
+{
+    SATSolver s;
+    s.load_snapshot(bad_fname);
+}
+
+TEST(snapshot, round_trip_sat)
+{
+    const auto cls = random_3sat(300, 1100, 3);
+    SATSolver s;
+    add_cls(s, cls);
+    const lbool simp_ret = s.simplify();
+    ASSERT_NE(simp_ret, l_False);
+    s.save_snapshot(fname);
+
+    SATSolver s2;
+    s2.load_snapshot(fname);
+    EXPECT_EQ(s2.nVars(), 300u);
+    ASSERT_EQ(s2.solve(), l_True);
+    EXPECT_TRUE(model_satisfies(cls, s2.get_model()));
+    std::remove(fname);
+}
+
+TEST(snapshot, round_trip_unsat)
+{
+    SATSolver s;
+    add_cls(s, pigeonhole(6));
+    s.simplify();
+    s.save_snapshot(fname);
+
+    SATSolver s2;
+    s2.load_snapshot(fname);
+    EXPECT_EQ(s2.solve(), l_False);
+    std::remove(fname);
+}
+
+TEST(snapshot, round_trip_checkpoint)
+{
+    const auto cls = random_3sat(250, 1050, 7);
+    SATSolver s;
+    add_cls(s, cls);
+    s.set_max_confl(500);
+    s.solve();
+    s.checkpoint(fname);
+
+    SATSolver s2;
+    s2.restore(fname);
+    const lbool ret = s2.solve();
+    ASSERT_NE(ret, l_Undef);
+    if (ret == l_True) {
+        EXPECT_TRUE(model_satisfies(cls, s2.get_model()));
+    }
+    std::remove(fname);
+}
+
+TEST(snapshot, checkpoint_keeps_gauss_matrices)
+{
+    SolverConf conf;
+    conf.gaussconf.min_gauss_xor_clauses = 0;
+    conf.gaussconf.min_matrix_rows = 1;
+    std::atomic<bool> must_inter(false);
+    Solver s(&conf, &must_inter);
+    s.new_vars(30);
+
+    SATSolver ref;
+    ref.new_vars(30);
+    std::mt19937 rnd(5);
+    for(uint32_t i = 0; i < 20; i++) {
+        vector<uint32_t> vars;
+        while(vars.size() < 4) {
+            const uint32_t v = rnd() % 30;
+            if (std::find(vars.begin(), vars.end(), v) == vars.end()) vars.push_back(v);
+        }
+        const bool rhs = rnd() & 1;
+        s.add_xor_clause_outside(vars, rhs);
+        ref.add_xor_clause(vars, rhs);
+    }
+    ASSERT_TRUE(s.okay());
+    ASSERT_TRUE(s.find_and_init_all_matrices());
+    const size_t num_matrices = s.gmatrices.size();
+    ASSERT_GT(num_matrices, 0u);
+
+    s.checkpoint(fname);
+    s.wait_for_checkpoint_write();
+    EXPECT_EQ(s.gmatrices.size(), num_matrices);
+    EXPECT_FALSE(s.xor_clauses_updated);
+
+    SATSolver s2;
+    s2.restore(fname);
+    EXPECT_EQ(s2.solve(), ref.solve());
+    std::remove(fname);
+}
+
+TEST(snapshot_death, truncated)
+{
+    SATSolver s;
+    add_cls(s, random_3sat(100, 400, 1));
+    s.simplify();
+    s.save_snapshot(fname);
+    const vector<char> data = read_file(fname);
+    ASSERT_GT(data.size(), 100u);
+
+    //Every cut point must be caught, not only the ones at vector boundaries
+    for(size_t cut: {data.size()-1, data.size()/2, data.size()/3, (size_t)40}) {
+        write_file(bad_fname, vector<char>(data.begin(), data.begin() + cut));
+        EXPECT_EXIT(load_bad(), ::testing::ExitedWithCode(255), "");
+    }
+    std::remove(fname);
+    std::remove(bad_fname);
+}
+
+TEST(snapshot_death, wrong_var_count)
+{
+    SATSolver s;
+    add_cls(s, random_3sat(100, 400, 2));
+    s.simplify();
+    s.save_snapshot(fname);
+    vector<char> data = read_file(fname);
+
+    //magic, 2x stats size, search state flag, then the number of variables
+    const uint32_t n = 50;
+    memcpy(data.data() + 20, &n, 4);
+    write_file(bad_fname, data);
+    EXPECT_EXIT(load_bad(), ::testing::ExitedWithCode(255), "");
+    std::remove(fname);
+    std::remove(bad_fname);
+}
+
+TEST(snapshot_death, unit_out_of_range)
+{
+    SATSolver s;
+    s.new_vars(3);
+    s.add_clause(str_to_cl("3"));
+    s.save_snapshot(fname);
+    vector<char> data = read_file(fname);
+
+    //The units are a vector of size 1 holding only Lit(2, false)
+    char pattern[12] = {};
+    const uint64_t sz = 1;
+    const uint32_t lit = Lit(2, false).toInt();
+    memcpy(pattern, &sz, 8);
+    memcpy(pattern + 8, &lit, 4);
+    auto it = std::search(data.begin(), data.end(), pattern, pattern + 12);
+    ASSERT_NE(it, data.end());
+    const uint32_t bad_lit = Lit(1000, false).toInt();
+    memcpy(&*(it + 8), &bad_lit, 4);
+    write_file(bad_fname, data);
+    EXPECT_EXIT(load_bad(), ::testing::ExitedWithCode(255), "");
+
+    //The file itself was fine
+    SATSolver s2;
+    s2.load_snapshot(fname);
+    EXPECT_EQ(s2.solve(), l_True);
+    EXPECT_EQ(s2.get_model()[2], l_True);
+    std::remove(fname);
+    std::remove(bad_fname);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
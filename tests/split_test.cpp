@@ -0,0 +1,140 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <thread>
+
+#include "cryptominisat5/cryptominisat.h"
+#include "src/solverconf.h"
+#include "test_helper.h"
+
+using namespace CMSat;
+
+//Small budgets so that cubes are both refuted and split again
+static SATSolver* new_split_solver(SolverConf& conf, uint32_t threads)
+{
+    conf.split_search = 1;
+    conf.split_cubes_per_thread = 4;
+    conf.split_cube_confl = 30;
+    SATSolver* s = new SATSolver(&conf);
+    s->set_num_threads(threads);
+    return s;
+}
+
+static void add_all(SATSolver* s, const vector<vector<Lit>>& cls, uint32_t num_vars)
+{
+    s->new_vars(num_vars);
+    for(const auto& cl: cls) s->add_clause(cl);
+}
+
+TEST(split, sat)
+{
+    for(uint32_t seed = 0; seed < 3; seed++) {
+        const vector<vector<Lit>> cls = random_3sat(150, 550, seed);
+        SolverConf conf;
+        SATSolver* s = new_split_solver(conf, 3);
+        add_all(s, cls, 150);
+
+        SATSolver ref;
+        add_all(&ref, cls, 150);
+
+        const lbool ret = s->solve();
+        EXPECT_EQ(ret, ref.solve());
+        if (ret == l_True) {
+            EXPECT_TRUE(model_satisfies(cls, s->get_model()));
+        }
+        delete s;
+    }
+}
+
+TEST(split, unsat)
+{
+    const vector<vector<Lit>> cls = pigeonhole(8);
+    SolverConf conf;
+    SATSolver* s = new_split_solver(conf, 2);
+    add_all(s, cls, 8*7);
+    EXPECT_EQ(s->solve(), l_False);
+    delete s;
+}
+
+TEST(split, unsat_under_assumptions)
+{
+    //Only UNSAT when the selector is set: the final conflict must be ~sel
+    vector<vector<Lit>> cls = pigeonhole(7);
+    const Lit sel = Lit(7*6, false);
+    for(auto& cl: cls) cl.push_back(~sel);
+
+    SolverConf conf;
+    SATSolver* s = new_split_solver(conf, 2);
+    add_all(s, cls, 7*6+1);
+
+    vector<Lit> assumps = {sel};
+    EXPECT_EQ(s->solve(&assumps), l_False);
+    EXPECT_EQ(s->get_conflict(), vector<Lit>{~sel});
+
+    EXPECT_EQ(s->solve(), l_True);
+    EXPECT_TRUE(model_satisfies(cls, s->get_model()));
+    delete s;
+}
+
+//Stopped runs are not refuted runs: they must give l_Undef, and must not
+//leave the instance UNSAT
+TEST(split, max_time)
+{
+    const vector<vector<Lit>> cls = pigeonhole(11);
+    SolverConf conf;
+    SATSolver* s = new_split_solver(conf, 2);
+    add_all(s, cls, 11*10);
+    s->set_max_time(0.2);
+    EXPECT_EQ(s->solve(), l_Undef);
+    EXPECT_TRUE(s->okay());
+
+    s->set_timeout_all_calls(0.2);
+    EXPECT_EQ(s->solve(), l_Undef);
+    EXPECT_TRUE(s->okay());
+    delete s;
+}
+
+TEST(split, interrupt)
+{
+    const vector<vector<Lit>> cls = pigeonhole(11);
+    SolverConf conf;
+    SATSolver* s = new_split_solver(conf, 2);
+    add_all(s, cls, 11*10);
+
+    lbool ret = l_True;
+    std::thread t([&]() { ret = s->solve(); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    s->interrupt_asap();
+    t.join();
+    EXPECT_EQ(ret, l_Undef);
+    EXPECT_TRUE(s->okay());
+    delete s;
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,158 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <random>
+
+#include "src/solver.h"
+#include "src/solverconf.h"
+#include "src/occsimplifier.h"
+#include "test_helper.h"
+
+using namespace CMSat;
+
+//Clauses with many subsumption and strengthening relations: random base
+//clauses, supersets of them, duplicates and supersets with a flipped lit
+static vector<vector<Lit>> related_cls(uint32_t num_vars, uint32_t num_base
+    , uint32_t min_size, uint32_t seed)
+{
+    std::mt19937 rnd(seed);
+    auto has_var = [](const vector<Lit>& cl, uint32_t v) {
+        for(Lit l: cl) if (l.var() == v) return true;
+        return false;
+    };
+    vector<vector<Lit>> cls;
+    for(uint32_t i = 0; i < num_base; i++) {
+        vector<Lit> base;
+        const uint32_t sz = min_size + rnd() % 2;
+        while(base.size() < sz) {
+            const uint32_t v = rnd() % num_vars;
+            if (!has_var(base, v)) base.push_back(Lit(v, rnd() & 1));
+        }
+        cls.push_back(base);
+        for(uint32_t j = rnd() % 4; j > 0; j--) {
+            vector<Lit> sup = base;
+            if (rnd() % 5 == 0) sup[0] = ~sup[0];
+            for(uint32_t k = 1 + rnd() % 3; k > 0; k--) {
+                const uint32_t v = rnd() % num_vars;
+                if (!has_var(sup, v)) sup.push_back(Lit(v, rnd() & 1));
+            }
+            std::shuffle(sup.begin(), sup.end(), rnd);
+            cls.push_back(sup);
+        }
+    }
+    std::shuffle(cls.begin(), cls.end(), rnd);
+    return cls;
+}
+
+static vector<vector<Lit>> sorted(vector<vector<Lit>> cls)
+{
+    for(auto& cl: cls) std::sort(cl.begin(), cl.end());
+    std::sort(cls.begin(), cls.end(), VecVecSorter());
+    return cls;
+}
+
+//Runs backward subsumption (and strengthening if 'str') on 'cls'. Units
+//that strengthening finds are returned as unit clauses, and an UNSAT result
+//as the empty clause
+static vector<vector<Lit>> run(const vector<vector<Lit>>& cls, uint32_t num_vars
+    , uint32_t threads, bool str)
+{
+    std::atomic<bool> must_inter(false);
+    SolverConf conf;
+    conf.subsume_threads = threads;
+    conf.verbosity = 0;
+    Solver s(&conf, &must_inter);
+    s.new_vars(num_vars);
+    for(const auto& cl: cls) s.add_clause_outside(cl);
+
+    s.occsimplifier->simplify(false, str ? "occ-backw-sub-str" : "occ-backw-sub");
+    if (!str) {
+        EXPECT_TRUE(s.okay());
+    }
+    if (!s.okay()) return vector<vector<Lit>>(1);
+
+    vector<vector<Lit>> ret = get_irred_cls(&s);
+    for(uint32_t v = 0; v < s.nVars(); v++) {
+        if (s.value(v) != l_Undef) ret.push_back(vector<Lit>{Lit(v, s.value(v) == l_False)});
+    }
+    return sorted(ret);
+}
+
+static bool eval(const vector<vector<Lit>>& cls, uint32_t assign)
+{
+    for(const auto& cl: cls) {
+        bool sat = false;
+        for(Lit l: cl) sat |= (((assign >> l.var()) & 1) ^ l.sign()) != 0;
+        if (!sat) return false;
+    }
+    return true;
+}
+
+//Subsumption alone always ends in the same clauses: the ones that no
+//other clause subsumes, with one copy of duplicates
+TEST(subsume_parallel, sub_same_as_serial)
+{
+    for(uint32_t seed = 0; seed < 10; seed++) {
+        const vector<vector<Lit>> cls = related_cls(60, 400, 3, seed);
+        const vector<vector<Lit>> serial = run(cls, 60, 1, false);
+        EXPECT_LT(serial.size(), cls.size());
+        for(const uint32_t threads: {2U, 4U}) {
+            EXPECT_EQ(run(cls, 60, threads, false), serial);
+        }
+    }
+}
+
+TEST(subsume_parallel, same_for_any_thread_num)
+{
+    for(uint32_t seed = 0; seed < 5; seed++) {
+        const vector<vector<Lit>> cls = related_cls(60, 100, 2, seed);
+        const vector<vector<Lit>> two = run(cls, 60, 2, true);
+        EXPECT_EQ(run(cls, 60, 3, true), two);
+        EXPECT_EQ(run(cls, 60, 8, true), two);
+    }
+}
+
+//Strengthening depends on the order, so only the formula is compared.
+//Few vars, so every assignment can be tried
+TEST(subsume_parallel, sub_str_equivalent)
+{
+    const uint32_t num_vars = 12;
+    for(uint32_t seed = 0; seed < 10; seed++) {
+        const vector<vector<Lit>> cls = related_cls(num_vars, 12, 2, seed);
+        const vector<vector<Lit>> serial = run(cls, num_vars, 1, true);
+        const vector<vector<Lit>> par = run(cls, num_vars, 4, true);
+        for(uint32_t a = 0; a < (1U << num_vars); a++) {
+            const bool orig = eval(cls, a);
+            EXPECT_EQ(eval(serial, a), orig);
+            EXPECT_EQ(eval(par, a), orig);
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,160 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#include "gtest/gtest.h"
+
+#include "src/solver.h"
+#include "src/solverconf.h"
+using namespace CMSat;
+#include "test_helper.h"
+
+//Propagation through 3-long clauses. With TERNARY_SECOND_BLOCKER their
+//watches also carry a second blocker, which must always be the clause's
+//third literal.
+struct ternary_prop : public ::testing::Test {
+    ternary_prop()
+    {
+        must_inter.store(false, std::memory_order_relaxed);
+        s = new Solver(&conf, &must_inter);
+        s->new_vars(30);
+    }
+    ~ternary_prop()
+    {
+        delete s;
+    }
+
+    void assign(const string& lit)
+    {
+        s->new_decision_level();
+        s->enqueue<false>(str_to_lit(lit));
+    }
+
+    void check_watches()
+    {
+        for(uint32_t i = 0; i < s->nVars()*2; i++) {
+            const Lit lit = Lit::toLit(i);
+            for(const Watched& w: s->watches[lit]) {
+                if (!w.isClause()) continue;
+                const Clause& c = *s->cl_alloc.ptr(w.get_offset());
+                if (c.size() != 3) {
+                    EXPECT_FALSE(w.hasSecondBlocker());
+                    continue;
+                }
+                vector<Lit> others;
+                for(Lit l: c) if (l != lit) others.push_back(l);
+                ASSERT_EQ(others.size(), 2u);
+                EXPECT_TRUE(w.getBlockedLit() == others[0] || w.getBlockedLit() == others[1]);
+                #ifdef TERNARY_SECOND_BLOCKER
+                ASSERT_TRUE(w.hasSecondBlocker());
+                EXPECT_NE(w.getBlockedLit(), w.getSecondBlocker());
+                EXPECT_TRUE(w.getSecondBlocker() == others[0] || w.getSecondBlocker() == others[1]);
+                #else
+                EXPECT_FALSE(w.hasSecondBlocker());
+                #endif
+            }
+        }
+    }
+
+    SolverConf conf;
+    Solver* s = NULL;
+    std::atomic<bool> must_inter;
+};
+
+TEST_F(ternary_prop, unit)
+{
+    s->add_clause_outside(str_to_cl("1, 2, 3"));
+    check_watches();
+
+    assign("-1");
+    EXPECT_TRUE(s->propagate<false>().isNULL());
+    EXPECT_EQ(s->value(str_to_lit("3")), l_Undef);
+    check_watches();
+
+    assign("-3");
+    EXPECT_TRUE(s->propagate<false>().isNULL());
+    EXPECT_EQ(s->value(str_to_lit("2")), l_True);
+    check_watches();
+}
+
+TEST_F(ternary_prop, conflict)
+{
+    s->add_clause_outside(str_to_cl("1, 2, 3"));
+    s->add_clause_outside(str_to_cl("1, 2, -3"));
+    assign("-1");
+    EXPECT_TRUE(s->propagate<false>().isNULL());
+    assign("-2");
+    EXPECT_FALSE(s->propagate<false>().isNULL());
+    s->cancelUntil(0);
+    check_watches();
+}
+
+TEST_F(ternary_prop, skipped_via_second_blocker)
+{
+    //Watch of 1 has 3 as its blocker, and 2 as its second blocker
+    s->add_clause_outside(str_to_cl("1, 2, 3"));
+    assign("2");
+    EXPECT_TRUE(s->propagate<false>().isNULL());
+
+    #ifdef PROP_WATCH_STATS
+    const uint64_t before = s->propStats.watchBlocker2Sat;
+    #endif
+    assign("-1");
+    EXPECT_TRUE(s->propagate<false>().isNULL());
+    #ifdef PROP_WATCH_STATS
+    #ifdef TERNARY_SECOND_BLOCKER
+    EXPECT_EQ(s->propStats.watchBlocker2Sat, before+1);
+    #else
+    EXPECT_EQ(s->propStats.watchBlocker2Sat, before);
+    #endif
+    #endif
+    EXPECT_EQ(s->value(str_to_lit("3")), l_Undef);
+    s->cancelUntil(0);
+    check_watches();
+}
+
+TEST_F(ternary_prop, random_3sat)
+{
+    //Many re-watches, then the models must be right
+    uint32_t num_sat = 0;
+    for(uint32_t seed = 0; seed < 10; seed++) {
+        //The previous solver raised it at the end of its solve()
+        must_inter.store(false, std::memory_order_relaxed);
+        Solver* s2 = new Solver(&conf, &must_inter);
+        s2->new_vars(100);
+        const auto cls = random_3sat(100, 420, seed);
+        for(const auto& cl: cls) s2->add_clause_outside(cl);
+        const lbool ret = s2->solve_with_assumptions(NULL);
+        EXPECT_NE(ret, l_Undef);
+        if (ret == l_True) {
+            num_sat++;
+            EXPECT_TRUE(model_satisfies(cls, s2->get_model()));
+        }
+        delete s2;
+    }
+    EXPECT_GT(num_sat, 0u);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -40,6 +40,7 @@ THE SOFTWARE.
 #include <cctype>
 #include <cassert>
 #include <algorithm>
+#include <random>
 #include "src/solver.h"
 #include "src/xor.h"
 #include "cryptominisat5/cryptominisat.h"
@@ -623,6 +624,60 @@ cnfdata cnf_file_read(std::string fname)
     return cnfdat;
 }
 
+//Random 3-SAT over 'num_vars' variables, no repeated vars in a clause
+vector<vector<Lit>> random_3sat(uint32_t num_vars, uint32_t num_cls, uint32_t seed)
+{
+    std::mt19937 rnd(seed);
+    vector<vector<Lit>> cls;
+    for(uint32_t i = 0; i < num_cls; i++) {
+        vector<Lit> cl;
+        while(cl.size() < 3) {
+            const uint32_t v = rnd() % num_vars;
+            bool dup = false;
+            for(Lit l: cl) dup |= l.var() == v;
+            if (!dup) cl.push_back(Lit(v, rnd() & 1));
+        }
+        cls.push_back(cl);
+    }
+    return cls;
+}
+
+//'pigeons' pigeons into pigeons-1 holes, UNSAT. Variables start at 'start'
+vector<vector<Lit>> pigeonhole(uint32_t pigeons, uint32_t start = 0)
+{
+    const uint32_t holes = pigeons-1;
+    auto var = [&](uint32_t p, uint32_t h) { return start + p*holes + h; };
+    vector<vector<Lit>> cls;
+    for(uint32_t p = 0; p < pigeons; p++) {
+        vector<Lit> cl;
+        for(uint32_t h = 0; h < holes; h++) cl.push_back(Lit(var(p, h), false));
+        cls.push_back(cl);
+    }
+    for(uint32_t h = 0; h < holes; h++) {
+        for(uint32_t p1 = 0; p1 < pigeons; p1++) {
+            for(uint32_t p2 = p1+1; p2 < pigeons; p2++) {
+                cls.push_back({Lit(var(p1, h), true), Lit(var(p2, h), true)});
+            }
+        }
+    }
+    return cls;
+}
+
+bool model_satisfies(const vector<vector<Lit>>& cls, const vector<lbool>& model)
+{
+    for(const auto& cl: cls) {
+        bool sat = false;
+        for(Lit l: cl) {
+            if (l.var() < model.size() && (model[l.var()] ^ l.sign()) == l_True) {
+                sat = true;
+                break;
+            }
+        }
+        if (!sat) return false;
+    }
+    return true;
+}
+
 bool cl_eq(const vector<Lit>& lits1, const vector<Lit>& lits2)
 {
     if (lits1.size() != lits2.size())